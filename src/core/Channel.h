@@ -0,0 +1,134 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#ifndef CHANNEL_H
+#define CHANNEL_H
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <optional>
+#include "Executor.h"
+
+namespace Richy {
+
+    /*
+     * File asynchrone entre un producteur quelconque (thread du flux,
+     * callback) et des coroutines consommatrices.
+     *
+     *     while (auto ticker = co_await channel->Next()) {
+     *         ...
+     *     }
+     *
+     * Push ne bloque jamais : si la file est pleine, la valeur la plus
+     * ancienne est perdue (et comptée). Next renvoie std::nullopt une fois
+     * la file fermée et vidée.
+     */
+    template <typename T>
+    class CChannel {
+        public:
+            CChannel(CExecutor& executor, size_t capacity = 1024) :
+                mExecutor(executor),
+                mCapacity(capacity),
+                mClosed(false),
+                mDropped(0) {
+            }
+
+            // false si la file est fermée
+            bool Push(T value) {
+                std::coroutine_handle<> handle;
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    if (mClosed) {
+                        return false;
+                    }
+
+                    // Un consommateur attend : la valeur lui est remise directement
+                    if (!mWaiters.empty()) {
+                        SWaiter waiter = mWaiters.front();
+                        mWaiters.pop_front();
+                        waiter.slot->emplace(std::move(value));
+                        handle = waiter.handle;
+                    } else {
+                        if (mQueue.size() >= mCapacity) {
+                            mQueue.pop_front();
+                            mDropped++;
+                        }
+                        mQueue.push_back(std::move(value));
+                        return true;
+                    }
+                }
+                mExecutor.Post(handle);
+                return true;
+            }
+
+            void Close() {
+                std::deque<SWaiter> waiters;
+                {
+                    std::lock_guard<std::mutex> lock(mMutex);
+                    mClosed = true;
+                    waiters.swap(mWaiters);
+                }
+                for (const auto& waiter : waiters) {
+                    mExecutor.Post(waiter.handle);
+                }
+            }
+
+            bool IsClosed() const {
+                std::lock_guard<std::mutex> lock(mMutex);
+                return mClosed;
+            }
+
+            unsigned long GetDropped() const {
+                return mDropped.load(std::memory_order_relaxed);
+            }
+
+            struct SNextAwaiter {
+                CChannel* channel;
+                std::optional<T> value;
+
+                bool await_ready() const noexcept {
+                    return false;
+                }
+
+                bool await_suspend(std::coroutine_handle<> handle) {
+                    std::lock_guard<std::mutex> lock(channel->mMutex);
+                    if (!channel->mQueue.empty()) {
+                        value.emplace(std::move(channel->mQueue.front()));
+                        channel->mQueue.pop_front();
+                        return false;
+                    }
+                    if (channel->mClosed) {
+                        return false;
+                    }
+                    channel->mWaiters.push_back({handle, &value});
+                    return true;
+                }
+
+                std::optional<T> await_resume() {
+                    return std::move(value);
+                }
+            };
+
+            SNextAwaiter Next() {
+                return {this, std::nullopt};
+            }
+
+        private:
+            struct SWaiter {
+                std::coroutine_handle<> handle;
+                std::optional<T>* slot;
+            };
+
+            CExecutor& mExecutor;
+            size_t mCapacity;
+            mutable std::mutex mMutex;
+            std::deque<T> mQueue;
+            std::deque<SWaiter> mWaiters;
+            bool mClosed;
+            std::atomic<unsigned long> mDropped;
+    };
+}
+
+#endif //CHANNEL_H
@@ -3,86 +3,409 @@
 //
 
 #include "Configuration.h"
+#include "Logger.h"
 #include <fstream>
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/stat.h>
+#ifdef __linux__
+#include <sys/inotify.h>
+#endif
 
 namespace Richy {
-    
+
+    // Supprime les espaces en début et fin de chaîne
+    static std::string Trim(const std::string& value) {
+        size_t first = value.find_first_not_of(" \t\r");
+        if (first == std::string::npos) {
+            return "";
+        }
+        size_t last = value.find_last_not_of(" \t\r");
+        return value.substr(first, last - first + 1);
+    }
+
     CConfiguration::CConfiguration() :
         mHost("localhost"),
         mAPIKey(""),
-        mAPISecret("") {
+        mAPISecret(""),
+        mGeneration(0),
+        mWatching(false) {
+        mStopPipe[0] = -1;
+        mStopPipe[1] = -1;
+        Publish(std::make_shared<SRuntimeConfig>());
     }
-    
+
     CConfiguration::~CConfiguration() {
+        StopWatching();
     }
-    
-    EErrors CConfiguration::Load() {
+
+    EErrors CConfiguration::ParseFile(const std::string& path, std::map<std::string, std::string>& values) {
         std::ifstream file;
-        file.open(CONF_FILE, std::ios::in);
-        
+        file.open(path, std::ios::in);
+
         if (!file.is_open()) {
             // Si le fichier n'existe pas, on retourne une erreur mais ce n'est pas critique
             return eCannotOpenFile;
         }
-        
+
         std::string line;
         while (std::getline(file, line)) {
             // Ignorer les lignes vides et les commentaires
             if (line.empty() || line[0] == '#') {
                 continue;
             }
-            
+
             size_t pos = line.find(':');
             if (pos == std::string::npos) {
                 continue; // Ligne mal formée, on l'ignore
             }
-            
-            std::string name = line.substr(0, pos);
-            std::string value = line.substr(pos + 1);
-            
-            // Nettoyer les espaces au début et à la fin
-            // Pour simplifier, on ne fait que supprimer les espaces en début de valeur
-            if (!value.empty() && value[0] == ' ') {
-                value = value.substr(1);
+
+            values[Trim(line.substr(0, pos))] = Trim(line.substr(pos + 1));
+        }
+
+        file.close();
+        return eNoError;
+    }
+
+    void CConfiguration::ParseRuntime(const std::map<std::string, std::string>& values, SRuntimeConfig& runtime) {
+        for (const auto& entry : values) {
+            const std::string& name = entry.first;
+            const std::string& value = entry.second;
+
+            if (name == "pairs") {
+                runtime.pairs.clear();
+                std::istringstream stream(value);
+                std::string pair;
+                while (std::getline(stream, pair, ',')) {
+                    pair = Trim(pair);
+                    if (!pair.empty()) {
+                        runtime.pairs.push_back(pair);
+                    }
+                }
+            }
+            else if (name == "publish_market_data") {
+                runtime.publishMarketData = (value == "true" || value == "1");
+            }
+            else if (name == "rate_limit_public") {
+                runtime.publicRateLimit = atoi(value);
+            }
+            else if (name == "rate_limit_private") {
+                runtime.privateRateLimit = atoi(value);
+            }
+            else if (name == "http_pool_size") {
+                runtime.httpPoolSize = atoi(value);
+            }
+            else if (name == "worker_threads") {
+                runtime.workerThreads = atoi(value);
+            }
+            else if (name == "cpu_network") {
+                runtime.networkCpu = atoi(value);
+            }
+            else if (name == "cpu_consumer") {
+                runtime.consumerCpu = atoi(value);
+            }
+            else if (name == "busy_poll") {
+                runtime.busyPoll = (value == "true" || value == "1");
+            }
+            else if (name == "busy_poll_us") {
+                runtime.busyPollUs = atoi(value);
             }
-            
-            // Charger les paramètres selon leur nom
-            if (name == "host") {
-                mHost = value;
+            else if (name == "lock_memory") {
+                runtime.lockMemory = (value == "true" || value == "1");
             }
-            else if (name == "api_key") {
-                mAPIKey = value;
+            else if (name == "request_timeout_ms") {
+                runtime.requestTimeoutMs = atoi(value);
             }
-            else if (name == "api_secret") {
-                mAPISecret = value;
+            else if (name == "connect_timeout_ms") {
+                runtime.connectTimeoutMs = atoi(value);
+            }
+            else if (name == "warmup") {
+                runtime.warmup = (value == "true" || value == "1");
+            }
+            else if (name == "warmup_connections") {
+                runtime.warmupConnections = atoi(value);
+            }
+            else if (name == "warmup_timeout_ms") {
+                runtime.warmupTimeoutMs = atoi(value);
+            }
+            else if (name == "risk_max_notional") {
+                runtime.riskMaxNotional = atof(value);
+            }
+            else if (name == "risk_max_position") {
+                runtime.riskMaxPosition = atof(value);
+            }
+            else if (name == "risk_price_band_percent") {
+                runtime.riskPriceBandPercent = atof(value);
+            }
+            else if (name == "risk_max_orders_per_second") {
+                runtime.riskMaxOrdersPerSecond = atoi(value);
+            }
+            else if (name == "risk_pair_orders_per_second") {
+                runtime.riskPairOrdersPerSecond = atoi(value);
+            }
+            else if (name == "risk_max_reference_age_ms") {
+                runtime.riskMaxReferenceAgeMs = atoi(value);
+            }
+            else if (name == "kill_switch") {
+                runtime.killSwitch = (value == "true" || value == "1");
+            }
+            else if (name == "key_routing") {
+                runtime.keyRouting = value;
+            }
+            else if (name == "simulated_exchange") {
+                runtime.simulatedExchange = (value == "true" || value == "1");
+            }
+            else if (name == "sim_maker_fee") {
+                runtime.simMakerFee = atof(value);
+            }
+            else if (name == "sim_taker_fee") {
+                runtime.simTakerFee = atof(value);
             }
         }
-        
-        file.close();
+    }
+
+    EErrors CConfiguration::Load() {
+        std::map<std::string, std::string> values;
+        EErrors result = ParseFile(CONF_FILE, values);
+        if (result != eNoError) {
+            return result;
+        }
+
+        // Charger les paramètres selon leur nom
+        if (values.count("host")) {
+            mHost = values["host"];
+        }
+        if (values.count("api_key")) {
+            mAPIKey = values["api_key"];
+        }
+        if (values.count("api_secret")) {
+            mAPISecret = values["api_secret"];
+        }
+        mExtraKeys.clear();
+        for (int index = 2; values.count("api_key_" + std::to_string(index)); ++index) {
+            mExtraKeys.emplace_back(values["api_key_" + std::to_string(index)],
+                                    values["api_secret_" + std::to_string(index)]);
+        }
+
+        std::shared_ptr<SRuntimeConfig> runtime = std::make_shared<SRuntimeConfig>();
+        ParseRuntime(values, *runtime);
+        Publish(std::move(runtime));
         return eNoError;
     }
-    
+
+    EErrors CConfiguration::Reload() {
+        // Seuls les paramètres d'exécution sont rechargés, les identifiants restent ceux du démarrage
+        std::map<std::string, std::string> values;
+        EErrors result = ParseFile(CONF_FILE, values);
+        if (result != eNoError) {
+            return result;
+        }
+
+        std::shared_ptr<SRuntimeConfig> runtime = std::make_shared<SRuntimeConfig>();
+        ParseRuntime(values, *runtime);
+        Publish(std::move(runtime));
+        return eNoError;
+    }
+
     EErrors CConfiguration::Save() {
         std::ofstream file;
         file.open(CONF_FILE, std::ios::out);
-        
+
         if (!file.is_open()) {
             return eCannotOpenFile;
         }
-        
+
         // Écrire un en-tête commenté
         file << "# " << FULLNAME << " Configuration File" << std::endl;
         file << "# This file is automatically generated" << std::endl;
         file << std::endl;
-        
+
         // Sauvegarder les paramètres
         file << "host:" << mHost << std::endl;
         file << "api_key:" << mAPIKey << std::endl;
         file << "api_secret:" << mAPISecret << std::endl;
-        
+        for (size_t i = 0; i < mExtraKeys.size(); ++i) {
+            file << "api_key_" << i + 2 << ":" << mExtraKeys[i].first << std::endl;
+            file << "api_secret_" << i + 2 << ":" << mExtraKeys[i].second << std::endl;
+        }
+
+        // Paramètres modifiables à chaud
+        std::shared_ptr<const SRuntimeConfig> snapshot = GetRuntime();
+        const SRuntimeConfig& runtime = *snapshot;
+        file.precision(15);
+        file << std::endl;
+        file << "# Runtime (reloaded live)" << std::endl;
+        file << "pairs:";
+        for (size_t i = 0; i < runtime.pairs.size(); ++i) {
+            file << (i > 0 ? "," : "") << runtime.pairs[i];
+        }
+        file << std::endl;
+        file << "publish_market_data:" << (runtime.publishMarketData ? "true" : "false") << std::endl;
+        file << "rate_limit_public:" << runtime.publicRateLimit << std::endl;
+        file << "rate_limit_private:" << runtime.privateRateLimit << std::endl;
+        file << "http_pool_size:" << runtime.httpPoolSize << std::endl;
+        file << "worker_threads:" << runtime.workerThreads << std::endl;
+        file << "cpu_network:" << runtime.networkCpu << std::endl;
+        file << "cpu_consumer:" << runtime.consumerCpu << std::endl;
+        file << "busy_poll:" << (runtime.busyPoll ? "true" : "false") << std::endl;
+        file << "busy_poll_us:" << runtime.busyPollUs << std::endl;
+        file << "lock_memory:" << (runtime.lockMemory ? "true" : "false") << std::endl;
+        file << "request_timeout_ms:" << runtime.requestTimeoutMs << std::endl;
+        file << "connect_timeout_ms:" << runtime.connectTimeoutMs << std::endl;
+        file << "warmup:" << (runtime.warmup ? "true" : "false") << std::endl;
+        file << "warmup_connections:" << runtime.warmupConnections << std::endl;
+        file << "warmup_timeout_ms:" << runtime.warmupTimeoutMs << std::endl;
+        file << "risk_max_notional:" << runtime.riskMaxNotional << std::endl;
+        file << "risk_max_position:" << runtime.riskMaxPosition << std::endl;
+        file << "risk_price_band_percent:" << runtime.riskPriceBandPercent << std::endl;
+        file << "risk_max_orders_per_second:" << runtime.riskMaxOrdersPerSecond << std::endl;
+        file << "risk_pair_orders_per_second:" << runtime.riskPairOrdersPerSecond << std::endl;
+        file << "risk_max_reference_age_ms:" << runtime.riskMaxReferenceAgeMs << std::endl;
+        file << "kill_switch:" << (runtime.killSwitch ? "true" : "false") << std::endl;
+        file << "key_routing:" << runtime.keyRouting << std::endl;
+        file << "simulated_exchange:" << (runtime.simulatedExchange ? "true" : "false") << std::endl;
+        file << "sim_maker_fee:" << runtime.simMakerFee << std::endl;
+        file << "sim_taker_fee:" << runtime.simTakerFee << std::endl;
+
         file.close();
         return eNoError;
     }
-}
\ No newline at end of file
+
+    // ===== INSTANTANÉS =====
+
+    std::shared_ptr<const SRuntimeConfig> CConfiguration::GetRuntime() const {
+        return mRuntime.load(std::memory_order_acquire);
+    }
+
+    void CConfiguration::AddListener(std::function<void(const SRuntimeConfig&)> listener) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mListeners.push_back(listener);
+    }
+
+    void CConfiguration::Publish(std::shared_ptr<SRuntimeConfig> runtime) {
+        std::vector<std::function<void(const SRuntimeConfig&)>> listeners;
+        std::shared_ptr<const SRuntimeConfig> published;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            runtime->generation = mGeneration++;
+            published = runtime;
+            mRuntime.store(published, std::memory_order_release);
+            listeners = mListeners;
+        }
+
+        for (const auto& listener : listeners) {
+            listener(*published);
+        }
+    }
+
+    // ===== SURVEILLANCE DU FICHIER =====
+
+    bool CConfiguration::Watch() {
+        if (mWatching) {
+            return true;
+        }
+        if (pipe(mStopPipe) != 0) {
+            return false;
+        }
+        mWatching = true;
+        mWatcher = std::thread(&CConfiguration::WatchLoop, this);
+        return true;
+    }
+
+    void CConfiguration::StopWatching() {
+        if (!mWatching) {
+            return;
+        }
+        mWatching = false;
+        char stop = 1;
+        if (write(mStopPipe[1], &stop, 1) < 0) {
+            // Le thread finira au prochain réveil
+        }
+        if (mWatcher.joinable()) {
+            mWatcher.join();
+        }
+        close(mStopPipe[0]);
+        close(mStopPipe[1]);
+        mStopPipe[0] = -1;
+        mStopPipe[1] = -1;
+    }
+
+    void CConfiguration::WatchLoop() {
+#ifdef __linux__
+        // On surveille le répertoire : les éditeurs remplacent souvent le fichier par renommage
+        int fd = inotify_init1(IN_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+        if (inotify_add_watch(fd, ".", IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+            close(fd);
+            return;
+        }
+
+        char buffer[BUFFER_SIZE] __attribute__((aligned(__alignof__(struct inotify_event))));
+        while (mWatching) {
+            struct pollfd fds[2] = {{fd, POLLIN, 0}, {mStopPipe[0], POLLIN, 0}};
+            int ready = poll(fds, 2, -1);
+            if (ready < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                // Erreur persistante : reboucler tournerait à vide
+                LOG_ERROR("Configuration watch stopped: {}", std::string(strerror(errno)));
+                break;
+            }
+            if (fds[1].revents & POLLIN) {
+                continue;
+            }
+            if ((fds[0].revents | fds[1].revents) & (POLLERR | POLLHUP | POLLNVAL)) {
+                LOG_ERROR("Configuration watch stopped: inotify descriptor failed");
+                break;
+            }
+            if (!(fds[0].revents & POLLIN)) {
+                continue;
+            }
+
+            ssize_t len = read(fd, buffer, sizeof(buffer));
+            bool changed = false;
+            for (char* ptr = buffer; len > 0 && ptr < buffer + len; ) {
+                struct inotify_event* event = (struct inotify_event*) ptr;
+                if (event->len > 0 && std::string(event->name) == CONF_FILE) {
+                    changed = true;
+                }
+                ptr += sizeof(struct inotify_event) + event->len;
+            }
+            if (changed) {
+                Reload();
+            }
+        }
+        close(fd);
+#else
+        // Sans inotify : comparaison de la date de modification toutes les secondes
+        struct stat st;
+        time_t lastModified = stat(CONF_FILE, &st) == 0 ? st.st_mtime : 0;
+        while (mWatching) {
+            struct pollfd fds[1] = {{mStopPipe[0], POLLIN, 0}};
+            int ready = poll(fds, 1, 1000);
+            if (ready < 0 && errno != EINTR) {
+                LOG_ERROR("Configuration watch stopped: {}", std::string(strerror(errno)));
+                break;
+            }
+            if (ready != 0) {
+                if (fds[0].revents & (POLLERR | POLLHUP | POLLNVAL)) {
+                    break;
+                }
+                continue;
+            }
+            if (stat(CONF_FILE, &st) == 0 && st.st_mtime != lastModified) {
+                lastModified = st.st_mtime;
+                Reload();
+            }
+        }
+#endif
+    }
+}
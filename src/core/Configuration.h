@@ -5,6 +5,14 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <functional>
 #include "def.h"
 #define CONF_FILE NAME ".conf"
 
@@ -21,6 +29,61 @@ namespace Richy {
         eCannotFork = 7,
     };
 
+    /*
+     * Paramètres modifiables à chaud.
+     * Une instance publiée n'est plus jamais modifiée : un rechargement en
+     * publie une nouvelle, que les lecteurs récupèrent sans verrou.
+     */
+    struct SRuntimeConfig {
+        unsigned long generation = 0;
+
+        // Marchés suivis
+        std::vector<std::string> pairs;
+        // Diffusion des flux aux autres processus (lu au démarrage)
+        bool publishMarketData = false;
+
+        // Budgets de rate-limit (requêtes/s publiques, compteur Kraken privé)
+        int publicRateLimit = 1;
+        int privateRateLimit = 15;
+
+        // Tailles des pools (lues au démarrage)
+        int httpPoolSize = 4;
+        int workerThreads = 2;
+
+        // Placement des threads (-1 = pas d'affinité, lu au démarrage) ; busy-poll appliqué à chaud
+        int networkCpu = -1;
+        int consumerCpu = -1;
+        bool busyPoll = false;
+        int busyPollUs = 50;
+        bool lockMemory = false;
+
+        // Timeouts
+        long requestTimeoutMs = 30000;
+        long connectTimeoutMs = 5000;
+
+        // Préchauffage avant le premier ordre : DNS figé, connexions ouvertes par clé (lu au démarrage)
+        bool warmup = true;
+        int warmupConnections = 2;
+        long warmupTimeoutMs = 3000;
+
+        // Contrôle pré-trade (0 = désactivé)
+        double riskMaxNotional = 0.0;
+        double riskMaxPosition = 0.0;
+        double riskPriceBandPercent = 0.0;
+        int riskMaxOrdersPerSecond = 0;        // toutes paires confondues
+        int riskPairOrdersPerSecond = 0;
+        long riskMaxReferenceAgeMs = 0;
+        bool killSwitch = false;
+
+        // Répartition des ordres entre les clés : "affinity" (par paire) ou "least_loaded"
+        std::string keyRouting = "affinity";
+
+        // Exchange simulé en processus, alimenté par le flux réel (lu au démarrage)
+        bool simulatedExchange = false;
+        double simMakerFee = -1.0;      // fraction ; < 0 : barème de la paire
+        double simTakerFee = -1.0;
+    };
+
     class CConfiguration {
         public:
             CConfiguration();
@@ -29,12 +92,40 @@ namespace Richy {
             EErrors Load();
             EErrors Save();
 
+            // Rechargement à chaud
+            EErrors Reload();
+            bool Watch();
+            void StopWatching();
+            void AddListener(std::function<void(const SRuntimeConfig&)> listener);
+
+            // Instantané courant ; libéré quand plus personne ne le tient (rechargements répétés)
+            std::shared_ptr<const SRuntimeConfig> GetRuntime() const;
+
         public:
             //HTTP Conf
             std::string mHost;
             std::string mAPIKey;
             std::string mAPISecret;
+            // Clés supplémentaires (api_key_2/api_secret_2, ...), chacune avec son budget de rate-limit
+            std::vector<std::pair<std::string, std::string>> mExtraKeys;
+
+        private:
+            static EErrors ParseFile(const std::string& path, std::map<std::string, std::string>& values);
+            static void ParseRuntime(const std::map<std::string, std::string>& values, SRuntimeConfig& runtime);
+            void Publish(std::shared_ptr<SRuntimeConfig> runtime);
+            void WatchLoop();
+
+            // Instantané publié ; les anciens vivent tant qu'un lecteur les tient
+            std::atomic<std::shared_ptr<const SRuntimeConfig>> mRuntime;
+            unsigned long mGeneration;
+            std::vector<std::function<void(const SRuntimeConfig&)>> mListeners;
+            std::mutex mMutex;
+
+            // Surveillance du fichier
+            std::thread mWatcher;
+            std::atomic<bool> mWatching;
+            int mStopPipe[2];
     };
 }
 
-#endif //CONFIG_H
\ No newline at end of file
+#endif //CONFIG_H
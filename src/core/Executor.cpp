@@ -0,0 +1,291 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#include "Executor.h"
+
+namespace Richy {
+
+    // Coroutine porteuse d'une tâche détachée : se libère d'elle-même à la fin
+    struct CExecutor::SDetached {
+        struct promise_type {
+            SDetached get_return_object() const noexcept {
+                return {};
+            }
+
+            std::suspend_never initial_suspend() const noexcept {
+                return {};
+            }
+
+            std::suspend_never final_suspend() const noexcept {
+                return {};
+            }
+
+            void return_void() const noexcept {
+            }
+
+            void unhandled_exception() const noexcept {
+                std::terminate();
+            }
+        };
+    };
+
+    CExecutor::CExecutor() :
+        mStopping(false),
+        mShutdown(false),
+        mEpoch(Clock::now()),
+        mBlockingShutdown(false),
+        mActive(0) {
+    }
+
+    CExecutor::~CExecutor() {
+        if (!mWorkers.empty() || !mBlockingThreads.empty()) {
+            RequestStop();
+            Join();
+        }
+    }
+
+    void CExecutor::SetThreadHook(std::function<void()> hook) {
+        mThreadHook = hook;
+    }
+
+    // ===== CYCLE DE VIE =====
+
+    bool CExecutor::Start(int workers, int blockingThreads) {
+        if (!mWorkers.empty()) {
+            return true;
+        }
+
+        mStopping = false;
+        mShutdown = false;
+        mBlockingShutdown = false;
+        for (int i = 0; i < std::max(1, workers); ++i) {
+            mWorkers.emplace_back(&CExecutor::RunWorker, this);
+        }
+        for (int i = 0; i < std::max(1, blockingThreads); ++i) {
+            mBlockingThreads.emplace_back(&CExecutor::RunBlocking, this);
+        }
+        return true;
+    }
+
+    void CExecutor::RequestStop() {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStopping = true;
+        }
+        // Les threads réveillés vident les minuteries : les Sleep en cours renvoient false
+        mCondition.notify_all();
+    }
+
+    bool CExecutor::IsStopping() const {
+        return mStopping.load(std::memory_order_acquire);
+    }
+
+    void CExecutor::Join() {
+        {
+            std::unique_lock<std::mutex> lock(mIdleMutex);
+            mIdleCondition.wait(lock, [this]() {
+                return mActive.load() == 0;
+            });
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mShutdown = true;
+        }
+        mCondition.notify_all();
+        for (auto& worker : mWorkers) {
+            worker.join();
+        }
+        mWorkers.clear();
+
+        {
+            std::lock_guard<std::mutex> lock(mBlockingMutex);
+            mBlockingShutdown = true;
+        }
+        mBlockingCondition.notify_all();
+        for (auto& thread : mBlockingThreads) {
+            thread.join();
+        }
+        mBlockingThreads.clear();
+    }
+
+    // ===== TÂCHES =====
+
+    CExecutor::SDetached CExecutor::RunDetached(CExecutor* executor, CTask<void> task) {
+        co_await executor->Schedule();
+        co_await task;
+        executor->TaskDone();
+    }
+
+    void CExecutor::Spawn(CTask<void> task) {
+        mActive++;
+        RunDetached(this, std::move(task));
+    }
+
+    void CExecutor::TaskDone() {
+        std::lock_guard<std::mutex> lock(mIdleMutex);
+        if (--mActive == 0) {
+            mIdleCondition.notify_all();
+        }
+    }
+
+    size_t CExecutor::GetActiveTasks() const {
+        return mActive.load();
+    }
+
+    // ===== MINUTERIES =====
+
+    uint64_t CExecutor::ToTick(Clock::time_point deadline) const {
+        // Arrondi au tick supérieur : une minuterie n'expire jamais en avance
+        if (deadline <= mEpoch) {
+            return 0;
+        }
+        return (uint64_t) std::chrono::ceil<std::chrono::milliseconds>(deadline - mEpoch).count();
+    }
+
+    uint64_t CExecutor::CurrentTick() const {
+        return (uint64_t) std::chrono::floor<std::chrono::milliseconds>(Clock::now() - mEpoch).count();
+    }
+
+    CExecutor::TimerId CExecutor::Arm(Clock::time_point deadline, STimer timer) {
+        TimerId id;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            id = mTimers.Add(ToTick(deadline), std::move(timer));
+        }
+        // Un thread en attente doit recalculer sa prochaine échéance
+        mCondition.notify_one();
+        return id;
+    }
+
+    CExecutor::TimerId CExecutor::After(long milliseconds, std::function<void()> callback) {
+        STimer timer;
+        timer.callback = std::move(callback);
+        return Arm(Clock::now() + std::chrono::milliseconds(milliseconds), std::move(timer));
+    }
+
+    CExecutor::TimerId CExecutor::Every(long milliseconds, std::function<void()> callback) {
+        STimer timer;
+        timer.callback = std::move(callback);
+        timer.interval = std::max(1L, milliseconds);
+        return Arm(Clock::now() + std::chrono::milliseconds(timer.interval), std::move(timer));
+    }
+
+    bool CExecutor::Cancel(TimerId id) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mTimers.Cancel(id);
+    }
+
+    // ===== FILES =====
+
+    void CExecutor::Post(std::coroutine_handle<> handle) {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mReady.push_back(handle);
+        }
+        mCondition.notify_one();
+    }
+
+    void CExecutor::AddTimer(Clock::time_point deadline, std::coroutine_handle<> handle) {
+        STimer timer;
+        timer.handle = handle;
+        Arm(deadline, std::move(timer));
+    }
+
+    void CExecutor::PostBlocking(std::function<void()> job) {
+        {
+            std::lock_guard<std::mutex> lock(mBlockingMutex);
+            mBlockingJobs.push_back(std::move(job));
+        }
+        mBlockingCondition.notify_one();
+    }
+
+    // ===== THREADS =====
+
+    void CExecutor::RunWorker() {
+        if (mThreadHook) {
+            mThreadHook();
+        }
+
+        for (;;) {
+            std::coroutine_handle<> handle;
+            std::function<void()> callback;
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                for (;;) {
+                    // Minuteries échues vers les files ; à l'arrêt, les coroutines reprennent
+                    // toutes et les rappels sont abandonnés
+                    size_t expired = 0;
+                    auto dispatch = [this, &expired](uint64_t, uint64_t tick, STimer& timer) -> uint64_t {
+                        expired++;
+                        if (timer.handle) {
+                            mReady.push_back(timer.handle);
+                            return 0;
+                        }
+                        if (mStopping) {
+                            return 0;
+                        }
+                        if (timer.interval > 0) {
+                            mCallbacks.push_back(timer.callback);
+                            return tick + timer.interval;
+                        }
+                        mCallbacks.push_back(std::move(timer.callback));
+                        return 0;
+                    };
+                    if (mStopping) {
+                        mTimers.Flush(dispatch);
+                    } else {
+                        mTimers.Advance(CurrentTick(), dispatch);
+                    }
+                    if (expired > 1) {
+                        mCondition.notify_all();
+                    }
+
+                    if (!mReady.empty()) {
+                        handle = mReady.front();
+                        mReady.pop_front();
+                        break;
+                    }
+                    if (!mCallbacks.empty()) {
+                        callback = std::move(mCallbacks.front());
+                        mCallbacks.pop_front();
+                        break;
+                    }
+                    if (mShutdown) {
+                        return;
+                    }
+                    uint64_t next = mTimers.NextExpiry();
+                    if (next == 0) {
+                        mCondition.wait(lock);
+                    } else {
+                        mCondition.wait_until(lock, mEpoch + std::chrono::milliseconds(next));
+                    }
+                }
+            }
+            if (handle) {
+                handle.resume();
+            } else {
+                callback();
+            }
+        }
+    }
+
+    void CExecutor::RunBlocking() {
+        for (;;) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(mBlockingMutex);
+                mBlockingCondition.wait(lock, [this]() {
+                    return mBlockingShutdown || !mBlockingJobs.empty();
+                });
+                if (mBlockingJobs.empty()) {
+                    return;
+                }
+                job = std::move(mBlockingJobs.front());
+                mBlockingJobs.pop_front();
+            }
+            job();
+        }
+    }
+}
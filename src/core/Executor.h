@@ -0,0 +1,205 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#ifndef EXECUTOR_H
+#define EXECUTOR_H
+
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <functional>
+#include <condition_variable>
+#include <type_traits>
+#include "Task.h"
+#include "TimerWheel.h"
+
+namespace Richy {
+
+    /*
+     * Exécuteur de coroutines : quelques threads de travail reprennent les
+     * tâches prêtes et les minuteries échues ; les appels bloquants
+     * (HTTP, disque) partent sur un pool séparé pour ne jamais immobiliser
+     * les threads de travail.
+     *
+     *     executor.Start(2, 4);
+     *     executor.Spawn(Strategy(api));
+     *     ...
+     *     executor.RequestStop();
+     *     executor.Join();
+     *
+     * Après RequestStop, les minuteries en cours se terminent aussitôt et
+     * Sleep renvoie false : les boucles des tâches s'arrêtent d'elles-mêmes.
+     *
+     * Minuteries (Sleep, After, Every) dans une roue hiérarchique à la
+     * milliseconde : des milliers d'échéances par seconde sans thread dédié.
+     */
+    class CExecutor {
+        public:
+            typedef std::chrono::steady_clock Clock;
+
+            CExecutor();
+            ~CExecutor();
+
+            // Appelé au démarrage de chaque thread de travail (placement CPU...)
+            void SetThreadHook(std::function<void()> hook);
+
+            bool Start(int workers, int blockingThreads);
+            void RequestStop();
+            bool IsStopping() const;
+            // Attend la fin des tâches lancées par Spawn, puis arrête les threads
+            void Join();
+
+            // Lance une tâche détachée sur un thread de travail
+            void Spawn(CTask<void> task);
+            size_t GetActiveTasks() const;
+
+            // ===== MINUTERIES =====
+
+            typedef uint64_t TimerId;
+
+            // Rappel exécuté sur un thread de travail : ne doit pas bloquer (PostBlocking sinon)
+            TimerId After(long milliseconds, std::function<void()> callback);
+            TimerId Every(long milliseconds, std::function<void()> callback);
+            // false si la minuterie a déjà expiré ou a été annulée
+            bool Cancel(TimerId id);
+
+            // ===== AWAITABLES =====
+
+            // Reprise sur un thread de travail
+            struct SScheduleAwaiter {
+                CExecutor* executor;
+
+                bool await_ready() const noexcept {
+                    return false;
+                }
+
+                void await_suspend(std::coroutine_handle<> handle) const {
+                    executor->Post(handle);
+                }
+
+                void await_resume() const noexcept {
+                }
+            };
+
+            // true si le délai s'est écoulé, false si l'arrêt l'a interrompu
+            struct STimerAwaiter {
+                CExecutor* executor;
+                Clock::time_point deadline;
+
+                bool await_ready() const noexcept {
+                    return executor->IsStopping();
+                }
+
+                void await_suspend(std::coroutine_handle<> handle) const {
+                    executor->AddTimer(deadline, handle);
+                }
+
+                bool await_resume() const noexcept {
+                    return !executor->IsStopping();
+                }
+            };
+
+            // Exécution d'une fonction bloquante sur le pool dédié, reprise sur un thread de travail
+            template <typename R, typename F>
+            struct SBlockingAwaiter {
+                CExecutor* executor;
+                F function;
+                std::optional<std::conditional_t<std::is_void_v<R>, bool, R>> result;
+
+                bool await_ready() const noexcept {
+                    return false;
+                }
+
+                void await_suspend(std::coroutine_handle<> handle) {
+                    executor->PostBlocking([this, handle]() {
+                        if constexpr (std::is_void_v<R>) {
+                            function();
+                            result.emplace(true);
+                        } else {
+                            result.emplace(function());
+                        }
+                        executor->Post(handle);
+                    });
+                }
+
+                R await_resume() {
+                    if constexpr (!std::is_void_v<R>) {
+                        return std::move(*result);
+                    }
+                }
+            };
+
+            SScheduleAwaiter Schedule() {
+                return {this};
+            }
+
+            STimerAwaiter Sleep(long milliseconds) {
+                return {this, Clock::now() + std::chrono::milliseconds(milliseconds)};
+            }
+
+            STimerAwaiter SleepUntil(Clock::time_point deadline) {
+                return {this, deadline};
+            }
+
+            template <typename F>
+            SBlockingAwaiter<std::invoke_result_t<F>, F> Blocking(F function) {
+                return {this, std::move(function), std::nullopt};
+            }
+
+            // ===== FILES =====
+
+            void Post(std::coroutine_handle<> handle);
+            void PostBlocking(std::function<void()> job);
+            void AddTimer(Clock::time_point deadline, std::coroutine_handle<> handle);
+
+        private:
+            // Coroutine à reprendre, ou rappel (périodique si interval > 0)
+            struct STimer {
+                std::coroutine_handle<> handle;
+                std::function<void()> callback;
+                long interval = 0;
+            };
+
+            struct SDetached;
+            static SDetached RunDetached(CExecutor* executor, CTask<void> task);
+            void TaskDone();
+
+            void RunWorker();
+            void RunBlocking();
+            TimerId Arm(Clock::time_point deadline, STimer timer);
+            uint64_t ToTick(Clock::time_point deadline) const;
+            uint64_t CurrentTick() const;
+
+            std::function<void()> mThreadHook;
+            std::vector<std::thread> mWorkers;
+            std::vector<std::thread> mBlockingThreads;
+            std::atomic<bool> mStopping;
+            bool mShutdown;
+
+            // Tâches prêtes, rappels échus et minuteries (ticks d'1 ms depuis mEpoch)
+            mutable std::mutex mMutex;
+            std::condition_variable mCondition;
+            std::deque<std::coroutine_handle<>> mReady;
+            std::deque<std::function<void()>> mCallbacks;
+            CTimerWheel<STimer> mTimers;
+            Clock::time_point mEpoch;
+
+            // Pool bloquant
+            std::mutex mBlockingMutex;
+            std::condition_variable mBlockingCondition;
+            std::deque<std::function<void()>> mBlockingJobs;
+            bool mBlockingShutdown;
+
+            // Tâches détachées en cours
+            std::atomic<size_t> mActive;
+            std::mutex mIdleMutex;
+            std::condition_variable mIdleCondition;
+    };
+}
+
+#endif //EXECUTOR_H
@@ -0,0 +1,211 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#include "LogReader.h"
+#include <cstdio>
+#include <ctime>
+
+namespace Richy {
+
+    CLogReader::CLogReader() :
+        mDropped(0) {
+    }
+
+    CLogReader::~CLogReader() {
+    }
+
+    bool CLogReader::Open(const std::string& path) {
+        mFile.open(path, std::ios::binary);
+        if (!mFile.is_open()) {
+            mLastError = "Cannot open " + path;
+            return false;
+        }
+
+        char magic[sizeof(LOG_MAGIC)];
+        uint32_t version = 0;
+        if (!mFile.read(magic, sizeof(magic)) || std::memcmp(magic, LOG_MAGIC, sizeof(magic)) != 0 || !Read(version)) {
+            mLastError = "Not a " NAME " binary log: " + path;
+            return false;
+        }
+        if (version / 100 != LOG_VERSION / 100) {
+            mLastError = "Unsupported log version " + std::to_string(version);
+            return false;
+        }
+        return true;
+    }
+
+    template <typename T>
+    bool CLogReader::Read(T& value) {
+        return (bool) mFile.read((char*) &value, sizeof(T));
+    }
+
+    bool CLogReader::ReadString(std::string& value) {
+        uint16_t length = 0;
+        if (!Read(length)) {
+            return false;
+        }
+        value.resize(length);
+        return length == 0 || (bool) mFile.read(&value[0], length);
+    }
+
+    bool CLogReader::ReadFormat() {
+        uint32_t id = 0;
+        uint8_t level = 0;
+        uint32_t line = 0;
+        SFormat format;
+        if (!Read(id) || !Read(level) || !Read(line) ||
+            !ReadString(format.file) || !ReadString(format.format) || !ReadString(format.types)) {
+            return false;
+        }
+        format.level = (ELogLevel) level;
+        format.line = (int) line;
+        mFormats[id] = format;
+        return true;
+    }
+
+    bool CLogReader::Next(SLogEntry& entry) {
+        char block;
+        while (mFile.get(block)) {
+            switch (block) {
+                case LOG_BLOCK_SESSION: {
+                    uint64_t start;
+                    if (!Read(start)) {
+                        mLastError = "Truncated session block";
+                        return false;
+                    }
+                    mFormats.clear();
+                    break;
+                }
+                case LOG_BLOCK_FORMAT:
+                    if (!ReadFormat()) {
+                        mLastError = "Truncated format block";
+                        return false;
+                    }
+                    break;
+                case LOG_BLOCK_DROPPED: {
+                    uint64_t dropped;
+                    if (!Read(dropped)) {
+                        mLastError = "Truncated drop block";
+                        return false;
+                    }
+                    mDropped = (unsigned long) dropped;
+                    break;
+                }
+                case LOG_BLOCK_RECORD: {
+                    SLogRecordHeader header;
+                    std::string payload;
+                    if (!Read(header)) {
+                        mLastError = "Truncated record";
+                        return false;
+                    }
+                    payload.resize(header.size);
+                    if (header.size > 0 && !mFile.read(&payload[0], header.size)) {
+                        mLastError = "Truncated record";
+                        return false;
+                    }
+
+                    auto it = mFormats.find(header.id);
+                    if (it == mFormats.end()) {
+                        mLastError = "Unknown format id " + std::to_string(header.id);
+                        return false;
+                    }
+                    entry.timestamp = header.timestamp;
+                    entry.thread = header.thread;
+                    entry.level = it->second.level;
+                    entry.file = it->second.file;
+                    entry.line = it->second.line;
+                    entry.message = Render(it->second, payload);
+                    return true;
+                }
+                default:
+                    mLastError = "Corrupted log block";
+                    return false;
+            }
+        }
+        return false;
+    }
+
+    std::string CLogReader::Render(const SFormat& format, const std::string& payload) const {
+        // Arguments décodés dans l'ordre des types
+        std::vector<std::string> args;
+        size_t offset = 0;
+        for (char type : format.types) {
+            char buffer[64];
+            if (type == 's') {
+                uint16_t length = 0;
+                if (offset + sizeof(length) > payload.size()) {
+                    break;
+                }
+                std::memcpy(&length, payload.data() + offset, sizeof(length));
+                offset += sizeof(length);
+                length = (uint16_t) std::min<size_t>(length, payload.size() - offset);
+                args.push_back(payload.substr(offset, length));
+                offset += length;
+                continue;
+            }
+
+            uint64_t raw = 0;
+            if (offset + sizeof(raw) > payload.size()) {
+                break;
+            }
+            std::memcpy(&raw, payload.data() + offset, sizeof(raw));
+            offset += sizeof(raw);
+            if (type == 'f') {
+                double value;
+                std::memcpy(&value, &raw, sizeof(value));
+                snprintf(buffer, sizeof(buffer), "%.10g", value);
+            } else if (type == 'i') {
+                snprintf(buffer, sizeof(buffer), "%lld", (long long) (int64_t) raw);
+            } else {
+                snprintf(buffer, sizeof(buffer), "%llu", (unsigned long long) raw);
+            }
+            args.push_back(buffer);
+        }
+
+        // Remplacement des "{}" ; les arguments en trop sont ajoutés à la fin
+        std::string message;
+        size_t next = 0;
+        for (size_t i = 0; i < format.format.size(); ++i) {
+            if (format.format[i] == '{' && i + 1 < format.format.size() && format.format[i + 1] == '}') {
+                message += next < args.size() ? args[next++] : "{}";
+                ++i;
+            } else {
+                message.push_back(format.format[i]);
+            }
+        }
+        for (; next < args.size(); ++next) {
+            message += " " + args[next];
+        }
+        return message;
+    }
+
+    unsigned long CLogReader::GetDropped() const {
+        return mDropped;
+    }
+
+    const std::string& CLogReader::GetLastError() const {
+        return mLastError;
+    }
+
+    const char* CLogReader::LevelName(ELogLevel level) {
+        switch (level) {
+            case eLogDebug: return "DEBUG";
+            case eLogInfo: return "INFO";
+            case eLogWarning: return "WARNING";
+            case eLogError: return "ERROR";
+        }
+        return "?";
+    }
+
+    std::string CLogReader::FormatTime(uint64_t timestamp) {
+        time_t seconds = (time_t) (timestamp / 1000000000ULL);
+        struct tm local;
+        localtime_r(&seconds, &local);
+        char date[32];
+        strftime(date, sizeof(date), "%Y-%m-%d %H:%M:%S", &local);
+        char result[48];
+        snprintf(result, sizeof(result), "%s.%09llu", date, (unsigned long long) (timestamp % 1000000000ULL));
+        return result;
+    }
+}
@@ -0,0 +1,70 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#ifndef LOGREADER_H
+#define LOGREADER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+#include "Logger.h"
+
+namespace Richy {
+
+    // Enregistrement décodé
+    struct SLogEntry {
+        uint64_t timestamp = 0;   // ns depuis l'epoch
+        uint16_t thread = 0;
+        ELogLevel level = eLogInfo;
+        std::string file;
+        int line = 0;
+        std::string message;
+    };
+
+    /*
+     * Lecture hors ligne d'un journal binaire écrit par CLogger.
+     *
+     * Les formats sont rejoués au fil des blocs : un fichier alimenté par
+     * plusieurs sessions successives se lit d'une traite.
+     */
+    class CLogReader {
+        public:
+            CLogReader();
+            ~CLogReader();
+
+            bool Open(const std::string& path);
+
+            // false en fin de fichier ou sur un bloc illisible (voir GetLastError)
+            bool Next(SLogEntry& entry);
+
+            unsigned long GetDropped() const;
+            const std::string& GetLastError() const;
+
+            static const char* LevelName(ELogLevel level);
+            static std::string FormatTime(uint64_t timestamp);
+
+        private:
+            struct SFormat {
+                ELogLevel level;
+                int line;
+                std::string file;
+                std::string format;
+                std::string types;
+            };
+
+            template <typename T>
+            bool Read(T& value);
+            bool ReadString(std::string& value);
+            bool ReadFormat();
+            std::string Render(const SFormat& format, const std::string& payload) const;
+
+            std::ifstream mFile;
+            std::map<uint32_t, SFormat> mFormats;
+            unsigned long mDropped;
+            std::string mLastError;
+    };
+}
+
+#endif //LOGREADER_H
@@ -0,0 +1,299 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#include "Logger.h"
+#include "ThreadLayout.h"
+#include <cstdio>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include <condition_variable>
+
+namespace Richy {
+
+    // Capacité du tampon de chaque thread (puissance de 2)
+    static const size_t LOG_BUFFER_SIZE = 1 << 20;
+    static const int DRAIN_PERIOD_MS = 1;
+
+    struct SLogBuffer {
+        uint16_t thread = 0;
+        std::unique_ptr<char[]> data;
+        std::atomic<uint64_t> head{0};    // écrit par le producteur seul
+        std::atomic<uint64_t> tail{0};    // écrit par le thread de fond seul
+        std::atomic<bool> closed{false};
+    };
+
+    struct SLogFormat {
+        ELogLevel level;
+        const char* file;
+        int line;
+        const char* format;
+        const char* types;
+    };
+
+    // Registre partagé (formats, tampons), protégé par sMutex
+    static std::mutex sMutex;
+    static std::condition_variable sStopCondition;
+    static std::vector<SLogFormat> sFormats;
+    static std::vector<std::shared_ptr<SLogBuffer>> sBuffers;
+    static uint16_t sNextThread = 0;
+
+    static std::atomic<bool> sRunning{false};
+    static std::atomic<int> sLevel{eLogInfo};
+    static std::atomic<unsigned long> sDropped{0};
+
+    // Propre au thread de fond
+    static std::thread sThread;
+    static FILE* sFile = NULL;
+    static size_t sWrittenFormats = 0;
+    static unsigned long sReportedDrops = 0;
+
+    // Le tampon survit au thread jusqu'à ce qu'il soit vidé
+    struct SThreadBuffer {
+        std::shared_ptr<SLogBuffer> buffer;
+
+        ~SThreadBuffer() {
+            if (buffer) {
+                buffer->closed.store(true, std::memory_order_release);
+            }
+        }
+    };
+
+    static thread_local SThreadBuffer tBuffer;
+
+    static SLogBuffer* CurrentBuffer() {
+        SLogBuffer* buffer = tBuffer.buffer.get();
+        if (buffer) {
+            return buffer;
+        }
+
+        std::shared_ptr<SLogBuffer> created = std::make_shared<SLogBuffer>();
+        created->data.reset(new char[LOG_BUFFER_SIZE]);
+        {
+            std::lock_guard<std::mutex> lock(sMutex);
+            created->thread = sNextThread++;
+            sBuffers.push_back(created);
+        }
+        tBuffer.buffer = created;
+        return created.get();
+    }
+
+    static void CopyIn(SLogBuffer* buffer, uint64_t position, const void* source, size_t length) {
+        size_t offset = position & (LOG_BUFFER_SIZE - 1);
+        size_t first = std::min(length, LOG_BUFFER_SIZE - offset);
+        std::memcpy(buffer->data.get() + offset, source, first);
+        std::memcpy(buffer->data.get(), (const char*) source + first, length - first);
+    }
+
+    static void CopyOut(const SLogBuffer* buffer, uint64_t position, void* destination, size_t length) {
+        size_t offset = position & (LOG_BUFFER_SIZE - 1);
+        size_t first = std::min(length, LOG_BUFFER_SIZE - offset);
+        std::memcpy(destination, buffer->data.get() + offset, first);
+        std::memcpy((char*) destination + first, buffer->data.get(), length - first);
+    }
+
+    template <typename T>
+    static void Put(std::string& out, T value) {
+        out.append((const char*) &value, sizeof(T));
+    }
+
+    static void PutString(std::string& out, const char* text) {
+        uint16_t length = (uint16_t) std::min<size_t>(std::strlen(text), 0xFFFF);
+        Put(out, length);
+        out.append(text, length);
+    }
+
+    // ===== CHEMIN CRITIQUE =====
+
+    bool CLogger::IsEnabled(ELogLevel level) {
+        return sRunning.load(std::memory_order_relaxed) && level >= sLevel.load(std::memory_order_relaxed);
+    }
+
+    uint32_t CLogger::Register(SLogSite& site, const char* format, const char* types) {
+        std::lock_guard<std::mutex> lock(sMutex);
+        uint32_t id = site.id.load(std::memory_order_relaxed);
+        if (id == 0) {
+            sFormats.push_back({site.level, site.file, site.line, format, types});
+            id = (uint32_t) sFormats.size();
+            site.id.store(id, std::memory_order_release);
+        }
+        return id;
+    }
+
+    void CLogger::Push(uint32_t id, const char* payload, size_t size) {
+        SLogBuffer* buffer = CurrentBuffer();
+
+        SLogRecordHeader header;
+        header.id = id;
+        header.thread = buffer->thread;
+        header.size = (uint16_t) size;
+        header.timestamp = (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()
+        ).count();
+
+        size_t total = sizeof(header) + size;
+        uint64_t head = buffer->head.load(std::memory_order_relaxed);
+        uint64_t tail = buffer->tail.load(std::memory_order_acquire);
+        if (head + total - tail > LOG_BUFFER_SIZE) {
+            sDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        CopyIn(buffer, head, &header, sizeof(header));
+        CopyIn(buffer, head + sizeof(header), payload, size);
+        buffer->head.store(head + total, std::memory_order_release);
+    }
+
+    // ===== THREAD DE FOND =====
+
+    static void Drain() {
+        std::vector<std::shared_ptr<SLogBuffer>> buffers;
+        {
+            std::lock_guard<std::mutex> lock(sMutex);
+            buffers = sBuffers;
+        }
+
+        std::string records;
+        for (const auto& buffer : buffers) {
+            uint64_t tail = buffer->tail.load(std::memory_order_relaxed);
+            uint64_t head = buffer->head.load(std::memory_order_acquire);
+            while (tail < head) {
+                SLogRecordHeader header;
+                CopyOut(buffer.get(), tail, &header, sizeof(header));
+                size_t total = sizeof(header) + header.size;
+                records.push_back(LOG_BLOCK_RECORD);
+                size_t offset = records.size();
+                records.resize(offset + total);
+                CopyOut(buffer.get(), tail, &records[offset], total);
+                tail += total;
+            }
+            buffer->tail.store(tail, std::memory_order_release);
+        }
+
+        // Formats lus après les enregistrements : tous ceux qu'ils référencent sont connus
+        std::string blocks;
+        {
+            std::lock_guard<std::mutex> lock(sMutex);
+            for (; sWrittenFormats < sFormats.size(); ++sWrittenFormats) {
+                const SLogFormat& format = sFormats[sWrittenFormats];
+                const char* file = std::strrchr(format.file, '/');
+                blocks.push_back(LOG_BLOCK_FORMAT);
+                Put(blocks, (uint32_t) (sWrittenFormats + 1));
+                Put(blocks, (uint8_t) format.level);
+                Put(blocks, (uint32_t) format.line);
+                PutString(blocks, file ? file + 1 : format.file);
+                PutString(blocks, format.format);
+                PutString(blocks, format.types);
+            }
+
+            // Tampons des threads terminés et entièrement vidés
+            sBuffers.erase(std::remove_if(sBuffers.begin(), sBuffers.end(), [](const std::shared_ptr<SLogBuffer>& buffer) {
+                return buffer->closed.load(std::memory_order_acquire) &&
+                       buffer->tail.load(std::memory_order_relaxed) == buffer->head.load(std::memory_order_acquire);
+            }), sBuffers.end());
+        }
+
+        unsigned long dropped = sDropped.load(std::memory_order_relaxed);
+        if (dropped != sReportedDrops) {
+            blocks.push_back(LOG_BLOCK_DROPPED);
+            Put(blocks, (uint64_t) dropped);
+            sReportedDrops = dropped;
+        }
+
+        if (blocks.empty() && records.empty()) {
+            return;
+        }
+        fwrite(blocks.data(), 1, blocks.size(), sFile);
+        fwrite(records.data(), 1, records.size(), sFile);
+        fflush(sFile);
+    }
+
+    void CLogger::Run() {
+        for (;;) {
+            bool running;
+            {
+                std::unique_lock<std::mutex> lock(sMutex);
+                sStopCondition.wait_for(lock, std::chrono::milliseconds(DRAIN_PERIOD_MS), []() {
+                    return !sRunning.load();
+                });
+                running = sRunning.load();
+            }
+            Drain();
+            if (!running) {
+                break;
+            }
+        }
+    }
+
+    // ===== CYCLE DE VIE =====
+
+    bool CLogger::Start(const std::string& path) {
+        std::lock_guard<std::mutex> lock(sMutex);
+        if (sRunning) {
+            return true;
+        }
+
+        sFile = fopen(path.c_str(), "ab");
+        if (!sFile) {
+            return false;
+        }
+        setvbuf(sFile, NULL, _IOFBF, 1 << 16);
+        fseek(sFile, 0, SEEK_END);
+
+        // En-tête à la création du fichier, puis un bloc de session par démarrage
+        std::string header;
+        if (ftell(sFile) == 0) {
+            header.append(LOG_MAGIC, sizeof(LOG_MAGIC));
+            Put(header, LOG_VERSION);
+        }
+        header.push_back(LOG_BLOCK_SESSION);
+        Put(header, (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()
+        ).count());
+        fwrite(header.data(), 1, header.size(), sFile);
+
+        // Les identifiants ne valent que pour la session : formats réécrits
+        sWrittenFormats = 0;
+        sReportedDrops = sDropped.load();
+        sRunning = true;
+        sThread = std::thread(&CLogger::Run);
+        return true;
+    }
+
+    void CLogger::Stop() {
+        {
+            std::lock_guard<std::mutex> lock(sMutex);
+            if (!sRunning) {
+                return;
+            }
+            sRunning = false;
+        }
+        sStopCondition.notify_all();
+        if (sThread.joinable()) {
+            sThread.join();
+        }
+        fclose(sFile);
+        sFile = NULL;
+    }
+
+    bool CLogger::IsRunning() {
+        return sRunning.load();
+    }
+
+    void CLogger::SetLevel(ELogLevel level) {
+        sLevel.store(level, std::memory_order_relaxed);
+    }
+
+    unsigned long CLogger::GetDropped() {
+        return sDropped.load(std::memory_order_relaxed);
+    }
+
+    void CLogger::Prefault() {
+        SLogBuffer* buffer = CurrentBuffer();
+        CThreadLayout::Prefault(buffer->data.get(), LOG_BUFFER_SIZE);
+    }
+}
@@ -0,0 +1,182 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <string>
+#include <string_view>
+#include <cstring>
+#include <cstdint>
+#include <atomic>
+#include <type_traits>
+#include <algorithm>
+#include "def.h"
+
+namespace Richy {
+
+    enum ELogLevel {
+        eLogDebug = 0,
+        eLogInfo = 1,
+        eLogWarning = 2,
+        eLogError = 3,
+    };
+
+    // Point d'appel d'un LOG_xxx : enregistré une seule fois, au premier passage
+    struct SLogSite {
+        ELogLevel level;
+        const char* file;
+        int line;
+        std::atomic<uint32_t> id{0};
+    };
+
+    /*
+     * Journal binaire asynchrone.
+     *
+     * Le thread appelant n'écrit qu'un identifiant de format, un horodatage
+     * et les arguments bruts dans un tampon circulaire qui lui est propre
+     * (un seul producteur, un seul consommateur, sans verrou). Un thread de
+     * fond vide les tampons vers richy.log ; les formats y sont écrits une
+     * fois, à leur première apparition, ce qui rend le fichier autonome.
+     * Le texte n'est produit qu'à la lecture, par richy-logdump.
+     *
+     * Si un tampon est plein, l'enregistrement est perdu (et compté) :
+     * le chemin critique ne bloque jamais. Les "{}" du format sont remplacés
+     * par les arguments dans l'ordre.
+     *
+     *     LOG_ERROR("{} failed: {}", endpoint.name, error);
+     */
+    class CLogger {
+        public:
+            static bool Start(const std::string& path = LOG_FILE);
+            static void Stop();
+            static bool IsRunning();
+
+            static void SetLevel(ELogLevel level);
+            static bool IsEnabled(ELogLevel level);
+
+            // Enregistrements perdus faute de place
+            static unsigned long GetDropped();
+
+            // Crée le tampon du thread appelant et en prend les défauts de page (préchauffage)
+            static void Prefault();
+
+            template <typename... Args>
+            static void Log(SLogSite& site, const char* format, const Args&... args) {
+                if (!IsEnabled(site.level)) {
+                    return;
+                }
+
+                uint32_t id = site.id.load(std::memory_order_acquire);
+                if (id == 0) {
+                    static const char types[] = {TypeTag<Args>()..., '\0'};
+                    id = Register(site, format, types);
+                }
+
+                // Place des arguments de taille fixe réservée d'avance : seules les chaînes sont tronquées
+                constexpr size_t fixed = (FixedSize<Args>() + ... + 0);
+                static_assert(fixed <= RECORD_MAX, "Too many log arguments");
+                char record[RECORD_MAX];
+                size_t size = 0;
+                size_t reserved = fixed;
+                (Encode(record, size, reserved, args), ...);
+                Push(id, record, size);
+            }
+
+            // Taille maximale des arguments d'un enregistrement (chaînes tronquées au-delà)
+            static constexpr size_t RECORD_MAX = 1024;
+
+        private:
+            static uint32_t Register(SLogSite& site, const char* format, const char* types);
+            static void Push(uint32_t id, const char* payload, size_t size);
+            static void Run();
+
+            // 'i' entier signé, 'u' non signé, 'f' flottant, 's' chaîne
+            template <typename T>
+            static constexpr char TypeTag() {
+                typedef std::decay_t<T> D;
+                if constexpr (std::is_floating_point_v<D>) {
+                    return 'f';
+                } else if constexpr (std::is_integral_v<D> || std::is_enum_v<D>) {
+                    return std::is_signed_v<D> ? 'i' : 'u';
+                } else {
+                    static_assert(std::is_convertible_v<const T&, std::string_view>, "Unsupported log argument type");
+                    return 's';
+                }
+            }
+
+            // Octets toujours écrits pour un argument : la valeur, ou la longueur d'une chaîne
+            template <typename T>
+            static constexpr size_t FixedSize() {
+                return TypeTag<T>() == 's' ? sizeof(uint16_t) : sizeof(uint64_t);
+            }
+
+            // reserved : taille fixe des arguments pas encore écrits, celui-ci compris
+            template <typename T>
+            static void Encode(char* record, size_t& size, size_t& reserved, const T& value) {
+                typedef std::decay_t<T> D;
+                reserved -= FixedSize<T>();
+                if constexpr (std::is_floating_point_v<D>) {
+                    Append(record, size, (double) value);
+                } else if constexpr (std::is_enum_v<D>) {
+                    Append(record, size, (int64_t) value);
+                } else if constexpr (std::is_integral_v<D>) {
+                    if constexpr (std::is_signed_v<D>) {
+                        Append(record, size, (int64_t) value);
+                    } else {
+                        Append(record, size, (uint64_t) value);
+                    }
+                } else {
+                    std::string_view text(value);
+                    size_t room = RECORD_MAX - std::min(RECORD_MAX, size + sizeof(uint16_t) + reserved);
+                    uint16_t length = (uint16_t) std::min(text.size(), room);
+                    Append(record, size, length);
+                    std::memcpy(record + size, text.data(), length);
+                    size += length;
+                }
+            }
+
+            template <typename T>
+            static void Append(char* record, size_t& size, T value) {
+                if (size + sizeof(T) <= RECORD_MAX) {
+                    std::memcpy(record + size, &value, sizeof(T));
+                    size += sizeof(T);
+                }
+            }
+    };
+
+    // ===== FORMAT DU FICHIER =====
+
+    // En-tête : "RLOG" puis VERSION_FILELOG * 100 (uint32)
+    static const char LOG_MAGIC[4] = {'R', 'L', 'O', 'G'};
+    static const uint32_t LOG_VERSION = (uint32_t) (VERSION_FILELOG * 100);
+
+    // Blocs : un octet de type puis le contenu
+    static const char LOG_BLOCK_SESSION = 'S';   // début de session u64 (ns), remet les formats à zéro
+    static const char LOG_BLOCK_FORMAT = 'F';    // id u32, niveau u8, ligne u32, fichier, format, types (u16 + octets)
+    static const char LOG_BLOCK_RECORD = 'R';    // SLogRecordHeader + arguments
+    static const char LOG_BLOCK_DROPPED = 'D';   // total perdu u64
+
+#pragma pack(push, 1)
+    struct SLogRecordHeader {
+        uint32_t id;
+        uint16_t thread;
+        uint16_t size;
+        uint64_t timestamp;   // ns depuis l'epoch
+    };
+#pragma pack(pop)
+}
+
+#define LOG_AT(level, ...) \
+    do { \
+        static Richy::SLogSite richyLogSite = {level, __FILE__, __LINE__}; \
+        Richy::CLogger::Log(richyLogSite, __VA_ARGS__); \
+    } while (0)
+
+#define LOG_DEBUG(...) LOG_AT(Richy::eLogDebug, __VA_ARGS__)
+#define LOG_INFO(...) LOG_AT(Richy::eLogInfo, __VA_ARGS__)
+#define LOG_WARNING(...) LOG_AT(Richy::eLogWarning, __VA_ARGS__)
+#define LOG_ERROR(...) LOG_AT(Richy::eLogError, __VA_ARGS__)
+
+#endif //LOGGER_H
@@ -0,0 +1,140 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#include "Metrics.h"
+#include <mutex>
+#include <cstring>
+#include <ctime>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#ifndef MAP_POPULATE
+#define MAP_POPULATE 0
+#endif
+
+namespace Richy {
+
+    static std::mutex sMutex;
+    static SMetricsHeader* sHeader = NULL;
+    static SMetricSlot* sSlots = NULL;
+    static bool sShared = false;
+    static std::string sName;
+    static std::string sLastError;
+
+    // Cible des poignées non enregistrées ou refusées (registre plein)
+    static SMetricSlot sDiscard;
+
+    CCounter::CCounter() : mSlot(&sDiscard) {}
+    CCounter::CCounter(SMetricSlot* slot) : mSlot(slot) {}
+    CGauge::CGauge() : mSlot(&sDiscard) {}
+    CGauge::CGauge(SMetricSlot* slot) : mSlot(slot) {}
+    CHistogram::CHistogram() : mSlot(&sDiscard) {}
+    CHistogram::CHistogram(SMetricSlot* slot) : mSlot(slot) {}
+
+    // Appelé sous sMutex
+    static bool Map(const std::string& name) {
+        // Toujours un segment neuf : tronquer celui d'une exécution précédente
+        // enverrait SIGBUS à un lecteur encore attaché
+        void* memory = MAP_FAILED;
+        shm_unlink(name.c_str());
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd >= 0) {
+            if (ftruncate(fd, (off_t) METRICS_SEGMENT_SIZE) == 0) {
+                // Pages prises d'avance : la première mise à jour d'une métrique ne fait pas de défaut de page
+                memory = mmap(NULL, METRICS_SEGMENT_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+            }
+            close(fd);
+        }
+
+        sShared = memory != MAP_FAILED;
+        if (!sShared) {
+            sLastError = "Cannot create shared metrics segment " + name + ": " + std::strerror(errno);
+            // Même disposition en mémoire privée : le processus continue sans export
+            memory = mmap(NULL, METRICS_SEGMENT_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+            if (memory == MAP_FAILED) {
+                return false;
+            }
+        }
+
+        sHeader = (SMetricsHeader*) memory;
+        sSlots = (SMetricSlot*) ((char*) memory + sizeof(SMetricsHeader));
+        std::memcpy(sHeader->magic, METRICS_MAGIC, sizeof(METRICS_MAGIC));
+        sHeader->version = METRICS_VERSION;
+        sHeader->pid = (int32_t) getpid();
+        sHeader->capacity = (uint32_t) METRICS_MAX;
+        sHeader->started = (int64_t) time(NULL);
+        sHeader->count.store(0, std::memory_order_release);
+        sName = name;
+        return true;
+    }
+
+    bool CMetrics::Open(const std::string& name) {
+        std::lock_guard<std::mutex> lock(sMutex);
+        if (sHeader) {
+            return sShared;
+        }
+        return Map(name) && sShared;
+    }
+
+    void CMetrics::Close() {
+        std::lock_guard<std::mutex> lock(sMutex);
+        if (sShared) {
+            shm_unlink(sName.c_str());
+            sShared = false;
+        }
+    }
+
+    bool CMetrics::IsShared() {
+        std::lock_guard<std::mutex> lock(sMutex);
+        return sShared;
+    }
+
+    std::string CMetrics::GetLastError() {
+        std::lock_guard<std::mutex> lock(sMutex);
+        return sLastError;
+    }
+
+    SMetricSlot* CMetrics::Register(const std::string& name, EMetricType type) {
+        std::lock_guard<std::mutex> lock(sMutex);
+        if (!sHeader && !Map(METRICS_SEGMENT)) {
+            return &sDiscard;
+        }
+
+        uint32_t count = sHeader->count.load(std::memory_order_relaxed);
+        for (uint32_t i = 0; i < count; ++i) {
+            if (name == sSlots[i].name) {
+                if (sSlots[i].type.load(std::memory_order_relaxed) != type) {
+                    sLastError = "Metric " + name + " registered with another type";
+                    return &sDiscard;
+                }
+                return &sSlots[i];
+            }
+        }
+        if (count >= METRICS_MAX || name.size() >= METRIC_NAME_MAX) {
+            sLastError = "Cannot register metric " + name;
+            return &sDiscard;
+        }
+
+        // Nom écrit avant le type, type avant le compteur : le lecteur ne voit que des slots complets
+        SMetricSlot* slot = &sSlots[count];
+        std::memcpy(slot->name, name.c_str(), name.size() + 1);
+        slot->type.store(type, std::memory_order_release);
+        sHeader->count.store(count + 1, std::memory_order_release);
+        return slot;
+    }
+
+    CCounter CMetrics::Counter(const std::string& name) {
+        return CCounter(Register(name, eMetricCounter));
+    }
+
+    CGauge CMetrics::Gauge(const std::string& name) {
+        return CGauge(Register(name, eMetricGauge));
+    }
+
+    CHistogram CMetrics::Histogram(const std::string& name) {
+        return CHistogram(Register(name, eMetricHistogram));
+    }
+}
@@ -0,0 +1,139 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <string>
+#include <cstdint>
+#include <atomic>
+#include <bit>
+#include <algorithm>
+#include "def.h"
+
+namespace Richy {
+
+    enum EMetricType : uint8_t {
+        eMetricNone = 0,
+        eMetricCounter = 1,
+        eMetricGauge = 2,
+        eMetricHistogram = 3,
+    };
+
+    // ===== FORMAT DU SEGMENT =====
+
+    static const char METRICS_MAGIC[4] = {'R', 'M', 'E', 'T'};
+    static const uint32_t METRICS_VERSION = 100;
+    static const size_t METRICS_MAX = 256;
+    static const size_t METRIC_NAME_MAX = 96;
+    // Histogrammes en puissances de 2 : le bucket i compte les valeurs < 2^i
+    static const size_t METRIC_BUCKETS = 32;
+
+    // Une métrique ; le nom suit la syntaxe Prometheus, étiquettes comprises
+    struct SMetricSlot {
+        char name[METRIC_NAME_MAX];
+        std::atomic<uint8_t> type;                   // publié en dernier (eMetricNone tant que le slot se remplit)
+        std::atomic<int64_t> value;                  // compteur, jauge ou nombre d'observations
+        std::atomic<int64_t> sum;                    // histogrammes : somme des observations
+        std::atomic<uint64_t> buckets[METRIC_BUCKETS];
+    };
+
+    struct SMetricsHeader {
+        char magic[4];
+        uint32_t version;
+        int32_t pid;
+        uint32_t capacity;
+        int64_t started;                             // secondes depuis l'epoch
+        std::atomic<uint32_t> count;                 // slots publiés
+    };
+
+    // Le lecteur partage ces atomiques avec un autre processus
+    static_assert(std::atomic<int64_t>::is_always_lock_free, "Shared metrics need lock-free 64-bit atomics");
+    static_assert(std::atomic<uint32_t>::is_always_lock_free, "Shared metrics need lock-free 32-bit atomics");
+
+    static const size_t METRICS_SEGMENT_SIZE = sizeof(SMetricsHeader) + METRICS_MAX * sizeof(SMetricSlot);
+
+    // ===== POIGNÉES =====
+
+    // Les poignées ne font que des opérations atomiques relâchées : aucun verrou, aucun appel système
+    class CCounter {
+        public:
+            CCounter();
+            explicit CCounter(SMetricSlot* slot);
+
+            void Add(int64_t value = 1) {
+                mSlot->value.fetch_add(value, std::memory_order_relaxed);
+            }
+
+        private:
+            SMetricSlot* mSlot;
+    };
+
+    class CGauge {
+        public:
+            CGauge();
+            explicit CGauge(SMetricSlot* slot);
+
+            void Set(int64_t value) {
+                mSlot->value.store(value, std::memory_order_relaxed);
+            }
+
+            void Add(int64_t value) {
+                mSlot->value.fetch_add(value, std::memory_order_relaxed);
+            }
+
+        private:
+            SMetricSlot* mSlot;
+    };
+
+    class CHistogram {
+        public:
+            CHistogram();
+            explicit CHistogram(SMetricSlot* slot);
+
+            void Observe(uint64_t value) {
+                size_t bucket = std::min<size_t>(std::bit_width(value), METRIC_BUCKETS - 1);
+                mSlot->buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+                mSlot->sum.fetch_add((int64_t) value, std::memory_order_relaxed);
+                mSlot->value.fetch_add(1, std::memory_order_relaxed);
+            }
+
+        private:
+            SMetricSlot* mSlot;
+    };
+
+    /*
+     * Registre de métriques dans un segment de mémoire partagée (/dev/shm).
+     *
+     * Les métriques sont créées une fois (sous verrou), puis mises à jour
+     * par leurs poignées sans coût notable. richy-metrics lit le segment
+     * depuis un autre processus, sans jamais interroger le processus de trading.
+     *
+     * Un même nom renvoie toujours le même slot. Si le segment ne peut pas
+     * être créé, ou qu'il est plein, les poignées restent utilisables mais
+     * ne sont pas exportées.
+     *
+     *     static CCounter errors = CMetrics::Counter("richy_errors_total");
+     *     errors.Add();
+     */
+    class CMetrics {
+        public:
+            // Ouvert implicitement (nom par défaut) à la première métrique
+            static bool Open(const std::string& name = METRICS_SEGMENT);
+            // Retire le segment de /dev/shm ; les poignées restent valides
+            static void Close();
+            static bool IsShared();
+
+            static CCounter Counter(const std::string& name);
+            static CGauge Gauge(const std::string& name);
+            static CHistogram Histogram(const std::string& name);
+
+            static std::string GetLastError();
+
+        private:
+            static SMetricSlot* Register(const std::string& name, EMetricType type);
+    };
+}
+
+#endif //METRICS_H
@@ -0,0 +1,179 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#include "MetricsReader.h"
+#include <set>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace Richy {
+
+    uint64_t SMetricSample::Quantile(double q) const {
+        if (value <= 0 || buckets.empty()) {
+            return 0;
+        }
+        uint64_t rank = std::min((uint64_t) (q * (double) value), (uint64_t) value - 1);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            seen += buckets[i];
+            if (seen > rank) {
+                return (1ULL << i) - 1;
+            }
+        }
+        return (1ULL << (buckets.size() - 1)) - 1;
+    }
+
+    CMetricsReader::CMetricsReader() :
+        mHeader(NULL),
+        mSlots(NULL) {
+    }
+
+    CMetricsReader::~CMetricsReader() {
+        Close();
+    }
+
+    bool CMetricsReader::Open(const std::string& name) {
+        Close();
+
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            mLastError = "No metrics segment " + name + " (is " NAME " running?)";
+            return false;
+        }
+
+        struct stat info;
+        void* memory = MAP_FAILED;
+        if (fstat(fd, &info) == 0 && (size_t) info.st_size >= METRICS_SEGMENT_SIZE) {
+            memory = mmap(NULL, METRICS_SEGMENT_SIZE, PROT_READ, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+        if (memory == MAP_FAILED) {
+            mLastError = "Cannot map metrics segment " + name;
+            return false;
+        }
+
+        mHeader = (const SMetricsHeader*) memory;
+        mSlots = (const SMetricSlot*) ((const char*) memory + sizeof(SMetricsHeader));
+        if (std::memcmp(mHeader->magic, METRICS_MAGIC, sizeof(METRICS_MAGIC)) != 0 ||
+            mHeader->version / 100 != METRICS_VERSION / 100) {
+            mLastError = "Unsupported metrics segment " + name;
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    void CMetricsReader::Close() {
+        if (mHeader) {
+            munmap((void*) mHeader, METRICS_SEGMENT_SIZE);
+        }
+        mHeader = NULL;
+        mSlots = NULL;
+    }
+
+    bool CMetricsReader::Snapshot(std::vector<SMetricSample>& samples) const {
+        samples.clear();
+        if (!mHeader) {
+            return false;
+        }
+
+        uint32_t count = std::min<uint32_t>(mHeader->count.load(std::memory_order_acquire), (uint32_t) METRICS_MAX);
+        for (uint32_t i = 0; i < count; ++i) {
+            const SMetricSlot& slot = mSlots[i];
+            EMetricType type = (EMetricType) slot.type.load(std::memory_order_acquire);
+            if (type == eMetricNone) {
+                continue;
+            }
+
+            SMetricSample sample;
+            sample.name.assign(slot.name, strnlen(slot.name, METRIC_NAME_MAX));
+            sample.type = type;
+            sample.value = slot.value.load(std::memory_order_relaxed);
+            if (type == eMetricHistogram) {
+                sample.sum = slot.sum.load(std::memory_order_relaxed);
+                sample.buckets.resize(METRIC_BUCKETS);
+                for (size_t b = 0; b < METRIC_BUCKETS; ++b) {
+                    sample.buckets[b] = slot.buckets[b].load(std::memory_order_relaxed);
+                }
+            }
+            samples.push_back(sample);
+        }
+        return true;
+    }
+
+    int CMetricsReader::GetPid() const {
+        return mHeader ? mHeader->pid : 0;
+    }
+
+    long long CMetricsReader::GetStarted() const {
+        return mHeader ? (long long) mHeader->started : 0;
+    }
+
+    bool CMetricsReader::IsAlive() const {
+        return mHeader && mHeader->pid > 0 && (kill(mHeader->pid, 0) == 0 || errno == EPERM);
+    }
+
+    const std::string& CMetricsReader::GetLastError() const {
+        return mLastError;
+    }
+
+    // ===== EXPORT PROMETHEUS =====
+
+    // "nom{a=\"b\"}" -> nom + suffixe, étiquettes + extra
+    static std::string Series(const std::string& name, const std::string& suffix, const std::string& extra = "") {
+        size_t brace = name.find('{');
+        std::string base = name.substr(0, brace);
+        std::string labels = brace == std::string::npos ? "" : name.substr(brace + 1, name.size() - brace - 2);
+        if (!extra.empty()) {
+            labels += (labels.empty() ? "" : ",") + extra;
+        }
+        return base + suffix + (labels.empty() ? "" : "{" + labels + "}");
+    }
+
+    static std::string BaseName(const std::string& name) {
+        return name.substr(0, name.find('{'));
+    }
+
+    std::string CMetricsReader::ToPrometheus(const std::vector<SMetricSample>& samples) {
+        // Les séries d'une même famille doivent se suivre
+        std::vector<SMetricSample> sorted = samples;
+        std::stable_sort(sorted.begin(), sorted.end(), [](const SMetricSample& a, const SMetricSample& b) {
+            return BaseName(a.name) < BaseName(b.name);
+        });
+
+        std::string text;
+        std::set<std::string> typed;
+        for (const auto& sample : sorted) {
+            std::string base = BaseName(sample.name);
+            if (typed.insert(base).second) {
+                const char* type = sample.type == eMetricCounter ? "counter" :
+                                   sample.type == eMetricGauge ? "gauge" : "histogram";
+                text += "# TYPE " + base + " " + type + "\n";
+            }
+
+            if (sample.type != eMetricHistogram) {
+                text += sample.name + " " + std::to_string(sample.value) + "\n";
+                continue;
+            }
+
+            // Buckets cumulés (valeurs entières : < 2^b équivaut à <= 2^b - 1) ; le dernier déborde (+Inf)
+            uint64_t cumulative = 0;
+            for (size_t b = 0; b + 1 < sample.buckets.size(); ++b) {
+                cumulative += sample.buckets[b];
+                text += Series(sample.name, "_bucket", "le=\"" + std::to_string((1ULL << b) - 1) + "\"") +
+                        " " + std::to_string(cumulative) + "\n";
+            }
+            text += Series(sample.name, "_bucket", "le=\"+Inf\"") + " " + std::to_string(sample.value) + "\n";
+            text += Series(sample.name, "_sum") + " " + std::to_string(sample.sum) + "\n";
+            text += Series(sample.name, "_count") + " " + std::to_string(sample.value) + "\n";
+        }
+        return text;
+    }
+}
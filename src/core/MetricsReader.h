@@ -0,0 +1,59 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#ifndef METRICSREADER_H
+#define METRICSREADER_H
+
+#include <string>
+#include <vector>
+#include "Metrics.h"
+
+namespace Richy {
+
+    // Valeurs d'une métrique à un instant donné
+    struct SMetricSample {
+        std::string name;
+        EMetricType type = eMetricNone;
+        int64_t value = 0;
+        int64_t sum = 0;
+        std::vector<uint64_t> buckets;   // non cumulés
+
+        // Plus grande valeur du bucket contenant le quantile q (histogrammes)
+        uint64_t Quantile(double q) const;
+    };
+
+    /*
+     * Lecture, depuis un autre processus, du segment écrit par CMetrics.
+     *
+     * Le segment est projeté en lecture seule : le processus observé n'est
+     * ni interrompu ni ralenti. Chaque valeur est lue atomiquement, mais un
+     * instantané n'est pas cohérent entre métriques.
+     */
+    class CMetricsReader {
+        public:
+            CMetricsReader();
+            ~CMetricsReader();
+
+            bool Open(const std::string& name = METRICS_SEGMENT);
+            void Close();
+
+            bool Snapshot(std::vector<SMetricSample>& samples) const;
+
+            int GetPid() const;
+            long long GetStarted() const;
+            // Le processus propriétaire tourne-t-il encore ?
+            bool IsAlive() const;
+            const std::string& GetLastError() const;
+
+            // Format texte Prometheus (node_exporter textfile collector)
+            static std::string ToPrometheus(const std::vector<SMetricSample>& samples);
+
+        private:
+            const SMetricsHeader* mHeader;
+            const SMetricSlot* mSlots;
+            std::string mLastError;
+    };
+}
+
+#endif //METRICSREADER_H
@@ -0,0 +1,150 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#ifndef TASK_H
+#define TASK_H
+
+#include <coroutine>
+#include <optional>
+#include <utility>
+#include <exception>
+#include <type_traits>
+
+namespace Richy {
+
+    template <typename T>
+    class CTask;
+
+    // ===== PROMESSES =====
+
+    // À la fin de la tâche, reprise directe de l'appelant (transfert symétrique, pile constante)
+    struct SPromiseBase {
+        std::coroutine_handle<> continuation;
+
+        struct SFinalAwaiter {
+            bool await_ready() const noexcept {
+                return false;
+            }
+
+            template <typename Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) const noexcept {
+                std::coroutine_handle<> continuation = handle.promise().continuation;
+                return continuation ? continuation : std::noop_coroutine();
+            }
+
+            void await_resume() const noexcept {
+            }
+        };
+
+        std::suspend_always initial_suspend() const noexcept {
+            return {};
+        }
+
+        SFinalAwaiter final_suspend() const noexcept {
+            return {};
+        }
+
+        // Pas d'exceptions dans le projet : une exception qui s'échappe d'une tâche est fatale
+        void unhandled_exception() const noexcept {
+            std::terminate();
+        }
+    };
+
+    template <typename T>
+    struct SPromise : SPromiseBase {
+        std::optional<T> value;
+
+        CTask<T> get_return_object();
+
+        void return_value(T result) {
+            value.emplace(std::move(result));
+        }
+    };
+
+    template <>
+    struct SPromise<void> : SPromiseBase {
+        CTask<void> get_return_object();
+
+        void return_void() const noexcept {
+        }
+    };
+
+    /*
+     * Tâche coroutine paresseuse : elle ne démarre qu'au premier co_await
+     * (ou via CExecutor::Spawn) et reprend son appelant en se terminant.
+     *
+     *     CTask<double> Mid(AsyncKrakenApi& api) {
+     *         TickerData ticker = co_await api.GetTicker("XBTUSD");
+     *         co_return (ticker.bid + ticker.ask) / 2;
+     *     }
+     *
+     * Les paramètres sont copiés dans la coroutine : passer des valeurs,
+     * pas des références vers des objets temporaires. GCC 12 détruit deux
+     * fois une fermeture ou un agrégat temporaire construit dans une
+     * expression co_await : le nommer avant.
+     */
+    template <typename T = void>
+    class CTask {
+        public:
+            typedef SPromise<T> promise_type;
+            typedef std::coroutine_handle<promise_type> Handle;
+
+            CTask() : mHandle(nullptr) {}
+            explicit CTask(Handle handle) : mHandle(handle) {}
+            CTask(CTask&& other) noexcept : mHandle(std::exchange(other.mHandle, nullptr)) {}
+            CTask(const CTask&) = delete;
+            CTask& operator=(const CTask&) = delete;
+
+            CTask& operator=(CTask&& other) noexcept {
+                if (this != &other) {
+                    if (mHandle) {
+                        mHandle.destroy();
+                    }
+                    mHandle = std::exchange(other.mHandle, nullptr);
+                }
+                return *this;
+            }
+
+            ~CTask() {
+                if (mHandle) {
+                    mHandle.destroy();
+                }
+            }
+
+            bool IsValid() const {
+                return mHandle != nullptr;
+            }
+
+            // ===== AWAITABLE =====
+
+            bool await_ready() const noexcept {
+                return !mHandle || mHandle.done();
+            }
+
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                mHandle.promise().continuation = awaiting;
+                return mHandle;
+            }
+
+            T await_resume() {
+                if constexpr (!std::is_void_v<T>) {
+                    return std::move(*mHandle.promise().value);
+                }
+            }
+
+        private:
+            Handle mHandle;
+    };
+
+    template <typename T>
+    inline CTask<T> SPromise<T>::get_return_object() {
+        return CTask<T>(std::coroutine_handle<SPromise<T>>::from_promise(*this));
+    }
+
+    inline CTask<void> SPromise<void>::get_return_object() {
+        return CTask<void>(std::coroutine_handle<SPromise<void>>::from_promise(*this));
+    }
+}
+
+#endif //TASK_H
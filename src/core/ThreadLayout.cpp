@@ -0,0 +1,177 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#include "ThreadLayout.h"
+#include <chrono>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <algorithm>
+#include <pthread.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#ifndef SO_BUSY_POLL
+#define SO_BUSY_POLL 46
+#endif
+
+#ifndef MADV_POPULATE_WRITE
+#define MADV_POPULATE_WRITE 23
+#endif
+
+namespace Richy {
+
+    // Histogramme log-linéaire de la gigue : 8 sous-buckets par puissance de 2 (précision ~12 %),
+    // taille fixe quelle que soit la durée de la mesure
+    static const int JITTER_SUB_BITS = 3;
+    static const size_t JITTER_BUCKETS = (64 - JITTER_SUB_BITS + 1) << JITTER_SUB_BITS;
+
+    static size_t JitterBucket(uint64_t value) {
+        if (value < (1u << JITTER_SUB_BITS)) {
+            return (size_t) value;
+        }
+        int shift = std::bit_width(value) - JITTER_SUB_BITS - 1;
+        size_t sub = (size_t) (value >> shift) & ((1u << JITTER_SUB_BITS) - 1);
+        return ((size_t) (shift + 1) << JITTER_SUB_BITS) + sub;
+    }
+
+    // Plus grande valeur comptée dans le bucket
+    static uint64_t JitterBucketUpper(size_t bucket) {
+        if (bucket < (1u << JITTER_SUB_BITS)) {
+            return bucket;
+        }
+        int shift = (int) (bucket >> JITTER_SUB_BITS) - 1;
+        uint64_t mantissa = (1u << JITTER_SUB_BITS) + (bucket & ((1u << JITTER_SUB_BITS) - 1));
+        return ((mantissa + 1) << shift) - 1;
+    }
+
+    bool CThreadLayout::Apply(const SRuntimeConfig& runtime, EThreadRole role) {
+        bool ok = true;
+
+        int cpu = (role == eNetworkThread) ? runtime.networkCpu : runtime.consumerCpu;
+        if (cpu >= 0) {
+            ok = PinCurrentThread(cpu) && ok;
+        }
+
+        if (runtime.lockMemory) {
+            ok = LockMemory() && ok;
+        }
+
+        return ok;
+    }
+
+    bool CThreadLayout::PinCurrentThread(int cpu) {
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+        // macOS n'offre pas d'affinité stricte
+        return false;
+#endif
+    }
+
+    bool CThreadLayout::LockMemory() {
+        // Évite les défauts de page sur le chemin critique (nécessite CAP_IPC_LOCK ou un ulimit suffisant)
+        return mlockall(MCL_CURRENT | MCL_FUTURE) == 0;
+    }
+
+    bool CThreadLayout::Prefault(void* data, size_t size) {
+        if (!data || size == 0) {
+            return true;
+        }
+        uintptr_t page = (uintptr_t) sysconf(_SC_PAGESIZE);
+        uintptr_t begin = (uintptr_t) data & ~(page - 1);
+        uintptr_t end = ((uintptr_t) data + size + page - 1) & ~(page - 1);
+#ifdef __linux__
+        // Linux 5.14+ : pages allouées par le noyau, sans toucher au contenu
+        if (madvise((void*) begin, end - begin, MADV_POPULATE_WRITE) == 0) {
+            return true;
+        }
+#endif
+        // Repli : une lecture-écriture par page, dans les limites de la zone (contenu inchangé)
+        for (uintptr_t address = begin; address < end; address += page) {
+            volatile char* byte = (volatile char*) std::max(address, (uintptr_t) data);
+            *byte = *byte;
+        }
+        return true;
+    }
+
+    bool CThreadLayout::EnableBusyPoll(int fd, int microseconds) {
+#ifdef __linux__
+        return setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &microseconds, sizeof(microseconds)) == 0;
+#else
+        return false;
+#endif
+    }
+
+    int CThreadLayout::WaitReadable(int fd, int timeoutMs, bool spin) {
+        struct pollfd pfd = {fd, POLLIN, 0};
+        if (!spin) {
+            return poll(&pfd, 1, timeoutMs);
+        }
+
+        // Spin : on ne rend jamais la main à l'ordonnanceur
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        for (;;) {
+            int ready = poll(&pfd, 1, 0);
+            if (ready != 0) {
+                return ready;
+            }
+            if (timeoutMs >= 0 && std::chrono::steady_clock::now() >= deadline) {
+                return 0;
+            }
+        }
+    }
+
+    SJitterStats CThreadLayout::MeasureJitter(int durationMs, int fd) {
+        std::array<unsigned long, JITTER_BUCKETS> histogram = {};
+        unsigned long samples = 0;
+        long max = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        auto end = start + std::chrono::milliseconds(durationMs);
+        auto previous = start;
+        for (;;) {
+            if (fd >= 0) {
+                // Un tour de la boucle de réception en spin
+                WaitReadable(fd, 0, true);
+            }
+            auto now = std::chrono::steady_clock::now();
+            long gap = std::chrono::duration_cast<std::chrono::nanoseconds>(now - previous).count();
+            previous = now;
+            samples++;
+            histogram[JitterBucket((uint64_t) gap)]++;
+            max = std::max(max, gap);
+            if (now >= end) {
+                break;
+            }
+        }
+
+        SJitterStats stats;
+        stats.samples = samples;
+        stats.max = max;
+        auto percentile = [&](double p) -> long {
+            unsigned long rank = (unsigned long) (p * (double) samples);
+            unsigned long seen = 0;
+            for (size_t bucket = 0; bucket < histogram.size(); bucket++) {
+                seen += histogram[bucket];
+                if (seen > rank) {
+                    return std::min<long>((long) JitterBucketUpper(bucket), max);
+                }
+            }
+            return max;
+        };
+        stats.p50 = percentile(0.50);
+        stats.p99 = percentile(0.99);
+        stats.p999 = percentile(0.999);
+        return stats;
+    }
+}
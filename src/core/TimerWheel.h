@@ -0,0 +1,291 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <vector>
+#include <cstdint>
+#include <bit>
+
+namespace Richy {
+
+    /*
+     * Roue de minuteries hiérarchique : 4 niveaux de 256 cases, une case du
+     * niveau 0 par tick (1 ms pour CExecutor), soit 2^32 ticks d'horizon.
+     *
+     * Ajout et annulation en O(1) : un nœud pris dans un pool, chaîné dans
+     * une case. Une minuterie lointaine descend d'un niveau à chaque passage
+     * de l'aiguille du niveau supérieur, et n'est touchée qu'au plus 4 fois.
+     *
+     *     CTimerWheel<int> wheel;
+     *     uint64_t id = wheel.Add(now + 250, 42);
+     *     wheel.Cancel(id);
+     *     wheel.Advance(now, [](uint64_t id, uint64_t tick, int& value) {
+     *         return (uint64_t) 0;        // ou le tick de réarmement
+     *     });
+     *
+     * Pas de verrou : la roue appartient à la boucle qui l'avance. Le rappel
+     * d'Advance ne doit ni ajouter ni annuler de minuterie.
+     */
+    template <typename T>
+    class CTimerWheel {
+        public:
+            static const int BITS = 8;
+            static const int SLOTS = 1 << BITS;
+            static const int LEVELS = 4;
+
+            explicit CTimerWheel(size_t capacity = 1024) :
+                mNow(0),
+                mCount(0),
+                mFree(NIL) {
+                for (int level = 0; level < LEVELS; ++level) {
+                    for (int slot = 0; slot < SLOTS; ++slot) {
+                        mHeads[level][slot] = NIL;
+                    }
+                    for (int word = 0; word < SLOTS / 64; ++word) {
+                        mOccupied[level][word] = 0;
+                    }
+                }
+                mNodes.reserve(capacity);
+            }
+
+            // Identifiant non nul, invalide dès que la minuterie a expiré ou a été annulée
+            uint64_t Add(uint64_t tick, T payload) {
+                uint32_t index = Allocate();
+                SNode& node = mNodes[index];
+                node.payload = std::move(payload);
+                node.armed = true;
+                Place(index, Upcoming(tick));
+                mCount++;
+                return ((uint64_t) node.generation << 32) | index;
+            }
+
+            bool Cancel(uint64_t id) {
+                uint32_t index = (uint32_t) id;
+                if (index >= mNodes.size() || mNodes[index].generation != (uint32_t) (id >> 32) ||
+                    !mNodes[index].armed) {
+                    return false;
+                }
+                Unlink(index);
+                Release(index);
+                return true;
+            }
+
+            /*
+             * Fait avancer l'aiguille jusqu'à "tick" inclus et appelle
+             * expired(id, tick, payload) pour chaque minuterie échue, dans
+             * l'ordre des échéances. Une valeur de retour non nulle réarme
+             * la minuterie à ce tick, avec le même identifiant.
+             */
+            template <typename F>
+            void Advance(uint64_t tick, F&& expired) {
+                while (mNow < tick) {
+                    if (mCount == 0) {
+                        mNow = tick;
+                        break;
+                    }
+
+                    // Saut direct à la prochaine case occupée ou au prochain passage d'aiguille
+                    uint64_t next = NextEvent();
+                    if (next > tick) {
+                        mNow = tick;
+                        break;
+                    }
+                    mNow = next;
+                    if ((mNow & (SLOTS - 1)) == 0) {
+                        Cascade();
+                    }
+                    Fire(mNow & (SLOTS - 1), expired);
+                }
+            }
+
+            // Échéance de toutes les minuteries restantes, quel que soit leur tick (arrêt)
+            template <typename F>
+            void Flush(F&& expired) {
+                for (int level = 0; level < LEVELS; ++level) {
+                    for (int slot = 0; slot < SLOTS; ++slot) {
+                        uint32_t index = Detach(level, slot);
+                        while (index != NIL) {
+                            uint32_t next = mNodes[index].next;
+                            uint64_t id = ((uint64_t) mNodes[index].generation << 32) | index;
+                            mNodes[index].armed = false;
+                            expired(id, mNow, mNodes[index].payload);
+                            Release(index);
+                            index = next;
+                        }
+                    }
+                }
+            }
+
+            /*
+             * Tick auquel il faut rappeler Advance : prochaine case occupée
+             * du niveau 0, ou à défaut prochain passage d'aiguille (réveil
+             * éventuellement inutile, au plus une fois toutes les 256 cases).
+             * 0 si la roue est vide.
+             */
+            uint64_t NextExpiry() const {
+                return mCount == 0 ? 0 : NextEvent();
+            }
+
+            uint64_t GetNow() const {
+                return mNow;
+            }
+
+            size_t Size() const {
+                return mCount;
+            }
+
+        private:
+            static const uint32_t NIL = 0xffffffffu;
+
+            struct SNode {
+                T payload;
+                uint64_t deadline = 0;
+                uint32_t prev = NIL;
+                uint32_t next = NIL;
+                uint32_t generation = 1;
+                uint8_t level = 0;
+                uint8_t slot = 0;
+                bool armed = false;
+            };
+
+            uint32_t Allocate() {
+                if (mFree != NIL) {
+                    uint32_t index = mFree;
+                    mFree = mNodes[index].next;
+                    return index;
+                }
+                mNodes.emplace_back();
+                return (uint32_t) (mNodes.size() - 1);
+            }
+
+            void Release(uint32_t index) {
+                SNode& node = mNodes[index];
+                node.payload = T();
+                node.armed = false;
+                node.generation++;
+                node.prev = NIL;
+                node.next = mFree;
+                mFree = index;
+                mCount--;
+            }
+
+            // La case du tick courant est déjà passée : une échéance échue part au tick suivant
+            uint64_t Upcoming(uint64_t tick) const {
+                return tick > mNow ? tick : mNow + 1;
+            }
+
+            // deadline >= mNow ; égalité seulement pendant une cascade, juste avant le tir de la case
+            void Place(uint32_t index, uint64_t deadline) {
+                SNode& node = mNodes[index];
+                node.deadline = deadline;
+                uint64_t delta = node.deadline - mNow;
+                if (delta >= (1ULL << (BITS * LEVELS))) {
+                    node.deadline = mNow + (1ULL << (BITS * LEVELS)) - 1;
+                    delta = node.deadline - mNow;
+                }
+
+                int level = 0;
+                while (level < LEVELS - 1 && delta >= (1ULL << (BITS * (level + 1)))) {
+                    level++;
+                }
+                int slot = (int) ((node.deadline >> (BITS * level)) & (SLOTS - 1));
+
+                node.level = (uint8_t) level;
+                node.slot = (uint8_t) slot;
+                node.prev = NIL;
+                node.next = mHeads[level][slot];
+                if (node.next != NIL) {
+                    mNodes[node.next].prev = index;
+                }
+                mHeads[level][slot] = index;
+                mOccupied[level][slot / 64] |= 1ULL << (slot % 64);
+            }
+
+            void Unlink(uint32_t index) {
+                SNode& node = mNodes[index];
+                if (node.prev != NIL) {
+                    mNodes[node.prev].next = node.next;
+                } else {
+                    mHeads[node.level][node.slot] = node.next;
+                    if (node.next == NIL) {
+                        mOccupied[node.level][node.slot / 64] &= ~(1ULL << (node.slot % 64));
+                    }
+                }
+                if (node.next != NIL) {
+                    mNodes[node.next].prev = node.prev;
+                }
+            }
+
+            // Retire toute la liste d'une case
+            uint32_t Detach(int level, int slot) {
+                uint32_t index = mHeads[level][slot];
+                mHeads[level][slot] = NIL;
+                mOccupied[level][slot / 64] &= ~(1ULL << (slot % 64));
+                return index;
+            }
+
+            // Passage d'aiguille : les cases courantes des niveaux supérieurs redescendent
+            void Cascade() {
+                int top = 1;
+                while (top < LEVELS - 1 && ((mNow >> (BITS * top)) & (SLOTS - 1)) == 0) {
+                    top++;
+                }
+                for (int level = top; level >= 1; --level) {
+                    uint32_t index = Detach(level, (int) ((mNow >> (BITS * level)) & (SLOTS - 1)));
+                    while (index != NIL) {
+                        uint32_t next = mNodes[index].next;
+                        Place(index, mNodes[index].deadline);
+                        index = next;
+                    }
+                }
+            }
+
+            template <typename F>
+            void Fire(int slot, F& expired) {
+                uint32_t index = Detach(0, slot);
+                while (index != NIL) {
+                    uint32_t next = mNodes[index].next;
+                    uint64_t id = ((uint64_t) mNodes[index].generation << 32) | index;
+                    uint64_t rearm = expired(id, mNow, mNodes[index].payload);
+                    if (rearm != 0) {
+                        Place(index, Upcoming(rearm));
+                    } else {
+                        Release(index);
+                    }
+                    index = next;
+                }
+            }
+
+            // Première case occupée du niveau 0 d'ici le prochain passage d'aiguille
+            uint64_t NextEvent() const {
+                uint64_t boundary = (mNow | (SLOTS - 1)) + 1;
+                int from = (int) ((mNow + 1) & (SLOTS - 1));
+                if (from == 0) {
+                    return boundary;
+                }
+                for (int word = from / 64; word < SLOTS / 64; ++word) {
+                    uint64_t bits = mOccupied[0][word];
+                    if (word == from / 64) {
+                        bits &= ~0ULL << (from % 64);
+                    }
+                    if (bits) {
+                        int slot = word * 64 + std::countr_zero(bits);
+                        return (mNow & ~(uint64_t) (SLOTS - 1)) + slot;
+                    }
+                }
+                return boundary;
+            }
+
+            std::vector<SNode> mNodes;
+            uint32_t mHeads[LEVELS][SLOTS];
+            uint64_t mOccupied[LEVELS][SLOTS / 64];
+            uint64_t mNow;
+            size_t mCount;
+            uint32_t mFree;
+    };
+}
+
+#endif //TIMERWHEEL_H
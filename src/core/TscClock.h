@@ -0,0 +1,69 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#ifndef TSCCLOCK_H
+#define TSCCLOCK_H
+
+#include <chrono>
+#include <thread>
+#include <cstdint>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace Richy {
+
+    /*
+     * Horloge du compteur de cycles (TSC), pour horodater un chemin chaud
+     * sans appel système : une lecture coûte une dizaine de ns, contre une
+     * vingtaine pour steady_clock via le vDSO.
+     *
+     *     uint64_t start = CTscClock::Now();
+     *     ...
+     *     uint64_t ns = CTscClock::ToNs(CTscClock::Now() - start);
+     *
+     * Suppose un TSC invariant (constant_tsc, nonstop_tsc : tous les x86
+     * récents). Hors x86, Now() renvoie directement des ns de steady_clock.
+     */
+    class CTscClock {
+        public:
+            static uint64_t Now() {
+#if defined(__x86_64__) || defined(__i386__)
+                return __rdtsc();
+#else
+                return (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()
+                ).count();
+#endif
+            }
+
+            static uint64_t ToNs(uint64_t ticks) {
+                return (uint64_t) ((double) ticks * NsPerTick());
+            }
+
+            // Étalonnage contre steady_clock, une fois par processus (~20 ms au premier appel)
+            static double NsPerTick() {
+                static const double nsPerTick = Calibrate();
+                return nsPerTick;
+            }
+
+        private:
+            static double Calibrate() {
+#if defined(__x86_64__) || defined(__i386__)
+                auto start = std::chrono::steady_clock::now();
+                uint64_t ticks = __rdtsc();
+                std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                uint64_t elapsedTicks = __rdtsc() - ticks;
+                double elapsedNs = (double) std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start
+                ).count();
+                return elapsedTicks > 0 ? elapsedNs / (double) elapsedTicks : 1.0;
+#else
+                return 1.0;
+#endif
+            }
+    };
+}
+
+#endif //TSCCLOCK_H
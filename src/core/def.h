@@ -32,6 +32,9 @@
 //Paths
 #define LOG_FILE NAME ".log"
 #define CLIENT_CONF_FILE NAME ".conf"
+#define CACHE_FILE NAME ".cache"
+#define METRICS_SEGMENT "/" NAME "-metrics"
+#define MARKET_SEGMENT "/" NAME "-market"
 
 inline int atoi(const std::string &v)
 {
@@ -40,6 +43,13 @@ inline int atoi(const std::string &v)
     return Temp;
 }
 
+inline double atof(const std::string &v)
+{
+    double Temp = 0.0;
+    std::istringstream(v) >> Temp;
+    return Temp;
+}
+
 //Network stuff
 const int BUFFER_SIZE = 4096;
 
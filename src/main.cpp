@@ -1,7 +1,179 @@
 #include <iostream>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <csignal>
+#include <algorithm>
 #include "core/def.h"
 #include "core/Configuration.h"
+#include "core/ThreadLayout.h"
+#include "core/Logger.h"
+#include "core/Metrics.h"
+#include "core/Executor.h"
 #include "net/KrakenApi.h"
+#include "net/AsyncKrakenApi.h"
+#include "net/RiskGate.h"
+#include "net/KeyPool.h"
+#include "net/SimExchange.h"
+#include "trading/BalanceLedger.h"
+#include "trading/PositionEngine.h"
+
+static std::atomic<bool> sStopRequested(false);
+
+// Sans flux privé, exécutions et expirations des ordres envoyés sont relevées par sondage
+static const long ORDER_REFRESH_MS = 1000;
+// Recalage des soldes locaux sur ceux de l'exchange
+static const int BALANCE_RECONCILE_S = 30;
+
+static void OnStopSignal(int) {
+    sStopRequested = true;
+}
+
+// Limites pré-trade et coupe-circuit (contrôle partagé par toutes les clés), au démarrage et à chaque rechargement.
+// previous : instantané appliqué avant, nullptr au démarrage. Le coupe-circuit ne bouge que si kill_switch
+// lui-même change : un déclenchement par RiskGate::Trip survit aux rechargements sans rapport
+static void ApplyRiskLimits(API::KrakenApi& api, const Richy::SRuntimeConfig& runtime,
+                            const Richy::SRuntimeConfig* previous) {
+    API::RiskLimits limits;
+    limits.maxNotional = runtime.riskMaxNotional;
+    limits.maxPosition = runtime.riskMaxPosition;
+    limits.priceBandPercent = runtime.riskPriceBandPercent;
+    limits.maxOrdersPerSecond = runtime.riskPairOrdersPerSecond;
+    limits.maxReferenceAgeMs = runtime.riskMaxReferenceAgeMs;
+
+    API::RiskGate& gate = api.GetRiskGate();
+    gate.SetLimits(limits);
+    gate.SetMaxOrdersPerSecond(runtime.riskMaxOrdersPerSecond);
+    if (previous && previous->killSwitch == runtime.killSwitch) {
+        return;
+    }
+    if (runtime.killSwitch) {
+        gate.Trip();
+    } else if (previous) {
+        gate.Reset();
+    }
+}
+
+// Budgets, timeouts et busy-poll, au démarrage et à chaque rechargement
+static void ApplyNetworkSettings(API::KrakenApi& api, const Richy::SRuntimeConfig& runtime) {
+    api.SetTimeouts(runtime.requestTimeoutMs, runtime.connectTimeoutMs);
+    api.SetBusyPoll(runtime.busyPoll ? runtime.busyPollUs : 0);
+    api.SetRateLimits(runtime.publicRateLimit, runtime.privateRateLimit);
+}
+
+// Paires de `from` absentes de `in`
+static std::vector<std::string> PairsMissing(const std::vector<std::string>& from, const std::vector<std::string>& in) {
+    std::vector<std::string> missing;
+    for (const auto& pair : from) {
+        if (std::find(in.begin(), in.end(), pair) == in.end()) {
+            missing.push_back(pair);
+        }
+    }
+    return missing;
+}
+
+// Positions et PnL de la session, à l'arrêt
+static void ReportPositions(const Richy::CPositionBook& positions) {
+    for (const auto& position : positions.GetPositions()) {
+        std::cout << position.pair << ": " << position.type << " " << position.volume << " @ " << position.avgPrice
+                  << " (realized " << position.realizedPnL << ", unrealized " << position.unrealizedPnL << ")" << std::endl;
+    }
+    LOG_INFO("Realized PnL {}, unrealized PnL {}", positions.GetTotalRealizedPnL(), positions.GetTotalUnrealizedPnL());
+}
+
+// Mode éditeur : ce processus possède les flux et les diffuse aux stratégies locales
+static int RunPublisher(API::KrakenApi& api, const Richy::SRuntimeConfig& runtime) {
+    if (!api.EnableMarketPublisher()) {
+        std::cout << RED "Cannot publish market data: " STOP << api.GetLastError() << std::endl;
+        return 1;
+    }
+    if (!api.ConnectWebSocket()) {
+        std::cout << RED << api.GetLastError() << STOP << std::endl;
+        return 1;
+    }
+    for (const auto& pair : runtime.pairs) {
+        api.SubscribeToTicker(pair);
+        api.SubscribeToTrades(pair);
+        api.SubscribeToOrderBook(pair);
+    }
+
+    std::signal(SIGINT, OnStopSignal);
+    std::signal(SIGTERM, OnStopSignal);
+    std::cout << GREEN "Publishing " << runtime.pairs.size() << " pair(s) on " MARKET_SEGMENT STOP << std::endl;
+    while (!sStopRequested) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }
+
+    api.DisconnectWebSocket();
+    return 0;
+}
+
+// Préchauffage : le premier ordre ne paie ni DNS, ni poignée de main TLS, ni défauts de page,
+// ni premiers passages dans la signature et les décodeurs. Signal "ready" dans les métriques,
+// levé seulement si tous les préchauffages réussissent (sinon richy_warmup_failed).
+static void Warmup(API::KrakenApi& api, API::KeyPool& keys, const Richy::SRuntimeConfig& runtime) {
+    static Richy::CGauge ready = Richy::CMetrics::Gauge("richy_ready");
+    static Richy::CGauge duration = Richy::CMetrics::Gauge("richy_warmup_us");
+    static Richy::CGauge failed = Richy::CMetrics::Gauge("richy_warmup_failed");
+    auto start = std::chrono::steady_clock::now();
+
+    // Tampons du journal : thread courant, puis thread du flux à son démarrage
+    Richy::CLogger::Prefault();
+    api.SetFeedThreadHook([]() {
+        Richy::CLogger::Prefault();
+    });
+    // Toutes les clés, api compris (clé 0) ; le rapport affiché est celui de api
+    API::WarmupReport report;
+    bool ok = true;
+    keys.ForEach([&api, &runtime, &report, &ok](API::KrakenApi& key) {
+        API::WarmupReport keyReport;
+        if (!key.Warmup(runtime.warmupConnections, runtime.warmupTimeoutMs, &key == &api ? report : keyReport)) {
+            std::cout << YELLOW "Warm-up incomplete: " STOP << key.GetLastError() << std::endl;
+            ok = false;
+        }
+    });
+
+    long elapsed = (long) std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start
+    ).count();
+    duration.Set(elapsed);
+    if (!ok) {
+        ready.Set(0);
+        failed.Set(1);
+        LOG_WARNING("Warm-up failed after {} us, not ready", elapsed);
+        std::cout << YELLOW "Not ready: warm-up failed after " << elapsed / 1000 << " ms" STOP << std::endl;
+        return;
+    }
+    failed.Set(0);
+    ready.Set(1);
+    LOG_INFO("Ready after {} us of warm-up", elapsed);
+    std::cout << GREEN "Ready in " << elapsed / 1000 << " ms" STOP << " (DNS " << report.resolveUs / 1000 << " ms, "
+              << report.connections << " connection(s) in " << report.connectUs / 1000 << " ms)" << std::endl;
+}
+
+// Vérification de la connexion puis ordre de démonstration
+static Richy::CTask<void> DemoStrategy(API::AsyncKrakenApi& async) {
+    if (co_await async.TestConnection()) {
+        std::cout << "Connected to Kraken!" << std::endl;
+    }
+
+    API::TickerData ticker = co_await async.GetTicker("XBTUSD");
+    std::cout << "BTC/USD: " << ticker.last << std::endl;
+
+    std::string orderId = co_await async.PlaceMarketOrder("XBTUSD", "buy", 0.001);
+    if (!orderId.empty()) {
+        std::cout << "Order placed: " << orderId << std::endl;
+    } else {
+        LOG_WARNING("Demo order rejected: {}", API::AsyncKrakenApi::GetLastError());
+    }
+}
+
+// Suivi d'une paire sur le flux temps réel, jusqu'à l'arrêt
+static Richy::CTask<void> WatchTicker(std::shared_ptr<Richy::CChannel<API::TickerData>> channel) {
+    while (auto ticker = co_await channel->Next()) {
+        LOG_DEBUG("{} last {}", ticker->pair, ticker->last);
+    }
+}
 
 int main() {
     std::cout << FULLNAME << std::endl;
@@ -47,26 +219,227 @@ int main() {
         }
     }
     
+    // Rechargement à chaud des paramètres d'exécution
+    config.AddListener([](const Richy::SRuntimeConfig& runtime) {
+        std::cout << CYAN "Runtime configuration reloaded (generation " << runtime.generation << ")" STOP << std::endl;
+    });
+    config.Watch();
+
+    // Le thread principal porte les appels réseau
+    if (!Richy::CThreadLayout::Apply(*config.GetRuntime(), Richy::eNetworkThread)) {
+        std::cout << YELLOW "Thread layout only partially applied" STOP << std::endl;
+    }
+
+    // Journal binaire asynchrone (décodé par richy-logdump)
+    if (!Richy::CLogger::Start()) {
+        std::cout << YELLOW "Cannot open log file " LOG_FILE STOP << std::endl;
+    }
+    LOG_INFO("{} started", FULLNAME);
+
+    // Métriques en mémoire partagée (lues par richy-metrics)
+    if (!Richy::CMetrics::Open()) {
+        std::cout << YELLOW << Richy::CMetrics::GetLastError() << STOP << std::endl;
+    }
+
     std::cout << BLUE "Application initialized successfully!" STOP << std::endl;
 
     API::KrakenApi api;
-    api.SetCredentials("your_api_key", "your_api_secret");
+    api.SetCredentials(config.mAPIKey, config.mAPISecret);
     api.SetSandboxMode(true); // Pour les tests
 
-    // Test de connexion
-    if (api.TestConnection()) {
-        std::cout << "Connected to Kraken!" << std::endl;
+    // Un seul contrôle pré-trade pour le compte, clés du pool comprises ;
+    // le flux de api lui relaie les tickers de référence
+    auto gate = std::make_shared<API::RiskGate>();
+    api.SetRiskGate(gate);
+    ApplyRiskLimits(api, *config.GetRuntime(), nullptr);
+
+    // Clés : api est la clé principale (clé 0, une seule instance donc un seul nonce par clé),
+    // les clés supplémentaires répartissent le trafic privé, chacune avec son nonce et son budget
+    API::KeyPool keys;
+    keys.SetRiskGate(gate);
+    keys.AddKey(api);
+    for (const auto& extra : config.mExtraKeys) {
+        keys.AddKey(extra.first, extra.second);
+    }
+    keys.ForEach([&config](API::KrakenApi& key) {
+        key.SetSandboxMode(true);
+        ApplyNetworkSettings(key, *config.GetRuntime());
+    });
+    keys.SetRouting(API::KeyPool::ParseRouting(config.GetRuntime()->keyRouting));
+    if (keys.GetSize() > 1) {
+        std::cout << "Private traffic shared by " << keys.GetSize() << " API keys" << std::endl;
     }
 
-    // Obtenir le ticker
-    API::TickerData ticker = api.GetTicker("XBTUSD");
-    std::cout << "BTC/USD: " << ticker.last << std::endl;
+    // Tailles des pools et placement des threads restent ceux du démarrage
+    config.AddListener([&api, &keys, applied = *config.GetRuntime()](const Richy::SRuntimeConfig& runtime) mutable {
+        ApplyRiskLimits(api, runtime, &applied);
+        applied = runtime;
+        keys.ForEach([&runtime](API::KrakenApi& key) {
+            ApplyNetworkSettings(key, runtime);
+        });
+        keys.SetRouting(API::KeyPool::ParseRouting(runtime.keyRouting));
+    });
 
-    // Placer un ordre
-    std::string orderId = api.PlaceMarketOrder("XBTUSD", "buy", 0.001);
-    if (!orderId.empty()) {
-        std::cout << "Order placed: " << orderId << std::endl;
+    // Données de référence depuis le cache disque (rafraîchies en tâche de fond)
+    if (!api.LoadReferenceCache()) {
+        std::cout << YELLOW "Reference data unavailable: " STOP << api.GetLastError() << std::endl;
+    }
+
+    // Paper trading : ordres appariés en processus, sur le flux réel relayé par KrakenApi
+    if (config.GetRuntime()->simulatedExchange) {
+        std::shared_ptr<const Richy::SRuntimeConfig> runtime = config.GetRuntime();
+        auto exchange = std::make_shared<API::SimExchange>();
+        for (const auto& pair : api.GetPairInfo()) {
+            uint32_t index = exchange->AddPair(pair.second);
+            if (runtime->simMakerFee >= 0.0 && runtime->simTakerFee >= 0.0) {
+                exchange->SetFees(index, runtime->simMakerFee, runtime->simTakerFee);
+            }
+        }
+        // Les clés du pool partagent le compte : mêmes ordres, mêmes soldes
+        auto transport = std::make_shared<API::SimTransport>(exchange, 0);
+        keys.ForEach([&transport](API::KrakenApi& key) {
+            key.SetTransport(transport);
+        });
+        std::cout << YELLOW "Simulated exchange: " << exchange->GetPairs().size() << " pair(s), no order reaches Kraken" STOP << std::endl;
+    }
+
+    // Palier de frais 30 jours (relu ensuite à chaque rafraîchissement des données de référence)
+    if (api.GetTradeVolume() == 0.0 && api.HasError()) {
+        LOG_WARNING("Trade volume unavailable, base fee tier used: {}", api.GetLastError());
+    }
+
+    // Soldes locaux : réservés à l'envoi des ordres, consommés aux exécutions (partagés par les clés).
+    // L'exchange simulé n'a pas de soldes posés : il ne contrôle pas les fonds, le registre non plus
+    auto ledger = std::make_shared<Richy::CBalanceLedger>();
+    if (config.GetRuntime()->simulatedExchange) {
+        LOG_INFO("Simulated exchange, orders sent without local funds check");
+    } else if (ledger->Sync(api)) {
+        keys.ForEach([&ledger](API::KrakenApi& key) {
+            key.SetBalanceLedger(ledger);
+        });
+        ledger->StartReconciliation(api, BALANCE_RECONCILE_S);
+    } else {
+        LOG_WARNING("Balances unavailable, orders sent without local funds check: {}",
+                    api.HasError() ? api.GetLastError() : std::string("empty balance"));
+    }
+
+    // Positions et PnL : exécutions des ordres suivis, réévaluées à chaque ticker (partagés par les clés)
+    auto positions = std::make_shared<Richy::CPositionBook>();
+    keys.ForEach([&positions](API::KrakenApi& key) {
+        key.SetPositionTracker(positions);
+    });
+
+    // Position réelle de départ dans le contrôle pré-trade et le suivi (l'exchange simulé part de zéro)
+    if (!config.GetRuntime()->simulatedExchange && !config.GetRuntime()->pairs.empty()) {
+        std::vector<std::string> pairs = config.GetRuntime()->pairs;
+        if (!api.SyncPositions(pairs)) {
+            LOG_WARNING("Open positions unavailable, risk gate starts flat: {}", api.GetLastError());
+        }
+    }
+
+    if (config.GetRuntime()->warmup) {
+        Warmup(api, keys, *config.GetRuntime());
+    }
+
+    if (config.GetRuntime()->publishMarketData) {
+        // Paires ajoutées ou retirées à chaud
+        config.AddListener([&api, pairs = config.GetRuntime()->pairs](const Richy::SRuntimeConfig& runtime) mutable {
+            for (const auto& pair : PairsMissing(runtime.pairs, pairs)) {
+                api.SubscribeToTicker(pair);
+                api.SubscribeToTrades(pair);
+                api.SubscribeToOrderBook(pair);
+            }
+            for (const auto& pair : PairsMissing(pairs, runtime.pairs)) {
+                api.UnsubscribeFromPair(pair);
+            }
+            pairs = runtime.pairs;
+        });
+        int result = RunPublisher(api, *config.GetRuntime());
+        config.StopWatching();
+        ledger->StopReconciliation();
+        ReportPositions(*positions);
+        Richy::CMetrics::Close();
+        Richy::CLogger::Stop();
+        return result;
+    }
+
+    // Les stratégies sont des coroutines réparties sur les threads de travail
+    Richy::SRuntimeConfig runtime = *config.GetRuntime();
+    Richy::CExecutor executor;
+    executor.SetThreadHook([runtime]() {
+        Richy::CThreadLayout::Apply(runtime, Richy::eConsumerThread);
+        if (runtime.warmup) {
+            Richy::CLogger::Prefault();
+        }
+    });
+    executor.Start(runtime.workerThreads, runtime.httpPoolSize);
+
+    {
+        API::AsyncKrakenApi async(api, executor);
+        executor.Spawn(DemoStrategy(async));
+        if (!runtime.pairs.empty()) {
+            if (api.ConnectWebSocket()) {
+                for (const auto& pair : runtime.pairs) {
+                    executor.Spawn(WatchTicker(async.Tickers(pair)));
+                }
+            } else {
+                std::cout << YELLOW "Market data stream unavailable: " STOP << api.GetLastError() << std::endl;
+            }
+        }
+
+        // Paires ajoutées ou retirées à chaud : une tâche de suivi par paire
+        config.AddListener([&api, &async, &executor, pairs = runtime.pairs](const Richy::SRuntimeConfig& reloaded) mutable {
+            std::vector<std::string> removed = PairsMissing(pairs, reloaded.pairs);
+            for (const auto& pair : removed) {
+                async.CloseStreams(pair);
+            }
+            std::vector<std::string> added = PairsMissing(reloaded.pairs, pairs);
+            if (!added.empty() && !api.IsWebSocketConnected() && !api.ConnectWebSocket()) {
+                // Réessayé au prochain rechargement
+                LOG_WARNING("Market data stream unavailable: {}", api.GetLastError());
+                pairs = PairsMissing(pairs, removed);
+                return;
+            }
+            for (const auto& pair : added) {
+                executor.Spawn(WatchTicker(async.Tickers(pair)));
+            }
+            pairs = reloaded.pairs;
+        });
+
+        std::atomic<bool> refreshing(false);
+        Richy::CExecutor::TimerId orderRefresh = executor.Every(ORDER_REFRESH_MS, [&keys, &executor, &refreshing]() {
+            if (refreshing.exchange(true)) {
+                return;
+            }
+            executor.PostBlocking([&keys, &refreshing]() {
+                keys.ForEach([](API::KrakenApi& key) {
+                    key.RefreshOrders();
+                });
+                refreshing = false;
+            });
+        });
+
+        // Jusqu'à SIGINT/SIGTERM ou la fin de toutes les stratégies
+        std::signal(SIGINT, OnStopSignal);
+        std::signal(SIGTERM, OnStopSignal);
+        while (!sStopRequested && executor.GetActiveTasks() > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+
+        // Les listeners de rechargement ne doivent plus toucher async, api ni keys
+        config.StopWatching();
+        executor.Cancel(orderRefresh);
+        executor.RequestStop();
+        async.CloseStreams();
+        executor.Join();
+        api.DisconnectWebSocket();
     }
 
+    // Le thread de réconciliation interroge api
+    ledger->StopReconciliation();
+    ReportPositions(*positions);
+
+    Richy::CMetrics::Close();
+    Richy::CLogger::Stop();
     return 0;
 }
\ No newline at end of file
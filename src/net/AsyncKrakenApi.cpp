@@ -0,0 +1,243 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#include "AsyncKrakenApi.h"
+
+namespace API {
+
+    thread_local std::string AsyncKrakenApi::tLastError;
+
+    AsyncKrakenApi::AsyncKrakenApi(KrakenApi& api, Richy::CExecutor& executor) :
+        mApi(api),
+        mExecutor(executor),
+        mClosed(false) {
+
+        // Le thread du flux ne fait que déposer les valeurs dans les files des abonnés
+        mApi.SetTickerCallback([this](const TickerData& ticker) {
+            Dispatch(mTickers, ticker.pair, ticker);
+        });
+        mApi.SetOrderBookCallback([this](const OrderBook& book) {
+            Dispatch(mBooks, book.pair, book);
+        });
+        mApi.SetTradeCallback([this](const Trade& trade) {
+            Dispatch(mTrades, trade.pair, trade);
+        });
+        mApi.SetGapCallback([this](const FeedGap& gap) {
+            Dispatch(mGaps, std::string(), gap);
+        });
+    }
+
+    AsyncKrakenApi::~AsyncKrakenApi() {
+        mApi.SetTickerCallback(nullptr);
+        mApi.SetOrderBookCallback(nullptr);
+        mApi.SetTradeCallback(nullptr);
+        mApi.SetGapCallback(nullptr);
+        CloseStreams();
+    }
+
+    std::string AsyncKrakenApi::GetLastError() {
+        return tLastError;
+    }
+
+    // ===== REST =====
+
+    // Simples fonctions (pas des coroutines) : la fermeture est passée à Call hors de toute expression co_await
+
+    Richy::CTask<bool> AsyncKrakenApi::TestConnection() {
+        return Call([](KrakenApi& api) {
+            return api.TestConnection();
+        });
+    }
+
+    Richy::CTask<std::string> AsyncKrakenApi::GetServerTime() {
+        return Call([](KrakenApi& api) {
+            return api.GetServerTime();
+        });
+    }
+
+    Richy::CTask<TickerData> AsyncKrakenApi::GetTicker(std::string pair) {
+        return Call([pair](KrakenApi& api) {
+            return api.GetTicker(pair);
+        });
+    }
+
+    Richy::CTask<std::vector<TickerData>> AsyncKrakenApi::GetMultipleTickers(std::vector<std::string> pairs) {
+        return Call([pairs](KrakenApi& api) {
+            return api.GetMultipleTickers(pairs);
+        });
+    }
+
+    Richy::CTask<OrderBook> AsyncKrakenApi::GetOrderBook(std::string pair, int depth) {
+        return Call([pair, depth](KrakenApi& api) {
+            return api.GetOrderBook(pair, depth);
+        });
+    }
+
+    Richy::CTask<std::vector<Trade>> AsyncKrakenApi::GetRecentTrades(std::string pair, int count) {
+        return Call([pair, count](KrakenApi& api) {
+            return api.GetRecentTrades(pair, count);
+        });
+    }
+
+    Richy::CTask<std::vector<Balance>> AsyncKrakenApi::GetAccountBalance() {
+        return Call([](KrakenApi& api) {
+            return api.GetAccountBalance();
+        });
+    }
+
+    Richy::CTask<std::vector<Order>> AsyncKrakenApi::GetOpenOrders(std::string pair) {
+        return Call([pair](KrakenApi& api) {
+            return api.GetOpenOrders(pair);
+        });
+    }
+
+    Richy::CTask<std::string> AsyncKrakenApi::PlaceMarketOrder(std::string pair, std::string type, double volume) {
+        return Call([pair, type, volume](KrakenApi& api) {
+            return api.PlaceMarketOrder(pair, type, volume);
+        });
+    }
+
+    Richy::CTask<std::string> AsyncKrakenApi::PlaceLimitOrder(std::string pair, std::string type,
+                                                             double volume, double price) {
+        return Call([pair, type, volume, price](KrakenApi& api) {
+            return api.PlaceLimitOrder(pair, type, volume, price);
+        });
+    }
+
+    Richy::CTask<bool> AsyncKrakenApi::CancelOrder(std::string orderId) {
+        return Call([orderId](KrakenApi& api) {
+            return api.CancelOrder(orderId);
+        });
+    }
+
+    Richy::CTask<bool> AsyncKrakenApi::CancelAllOrders(std::string pair) {
+        return Call([pair](KrakenApi& api) {
+            return api.CancelAllOrders(pair);
+        });
+    }
+
+    // ===== FLUX =====
+
+    Richy::CTask<bool> AsyncKrakenApi::ConnectWebSocket() {
+        return Call([](KrakenApi& api) {
+            return api.ConnectWebSocket();
+        });
+    }
+
+    std::shared_ptr<Richy::CChannel<TickerData>> AsyncKrakenApi::Tickers(const std::string& pair) {
+        std::shared_ptr<Richy::CChannel<TickerData>> channel(new Richy::CChannel<TickerData>(mExecutor));
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mClosed) {
+                channel->Close();
+                return channel;
+            }
+            mTickers[pair].push_back(channel);
+        }
+        mApi.SubscribeToTicker(pair);
+        return channel;
+    }
+
+    std::shared_ptr<Richy::CChannel<OrderBook>> AsyncKrakenApi::OrderBooks(const std::string& pair, int depth) {
+        // Un carnet périmé n'a pas d'intérêt : file courte, les plus anciens sont abandonnés
+        std::shared_ptr<Richy::CChannel<OrderBook>> channel(new Richy::CChannel<OrderBook>(mExecutor, 16));
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mClosed) {
+                channel->Close();
+                return channel;
+            }
+            mBooks[pair].push_back(channel);
+        }
+        mApi.SubscribeToOrderBook(pair, depth);
+        return channel;
+    }
+
+    std::shared_ptr<Richy::CChannel<Trade>> AsyncKrakenApi::Trades(const std::string& pair) {
+        std::shared_ptr<Richy::CChannel<Trade>> channel(new Richy::CChannel<Trade>(mExecutor));
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mClosed) {
+                channel->Close();
+                return channel;
+            }
+            mTrades[pair].push_back(channel);
+        }
+        mApi.SubscribeToTrades(pair);
+        return channel;
+    }
+
+    std::shared_ptr<Richy::CChannel<FeedGap>> AsyncKrakenApi::Gaps() {
+        std::shared_ptr<Richy::CChannel<FeedGap>> channel(new Richy::CChannel<FeedGap>(mExecutor));
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mClosed) {
+            channel->Close();
+        } else {
+            mGaps[std::string()].push_back(channel);
+        }
+        return channel;
+    }
+
+    template <typename T>
+    static void CloseAll(std::map<std::string, std::vector<std::shared_ptr<Richy::CChannel<T>>>>& channels) {
+        for (auto& entry : channels) {
+            for (auto& channel : entry.second) {
+                channel->Close();
+            }
+        }
+        channels.clear();
+    }
+
+    void AsyncKrakenApi::CloseStreams() {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mClosed = true;
+        CloseAll(mTickers);
+        CloseAll(mBooks);
+        CloseAll(mTrades);
+        CloseAll(mGaps);
+    }
+
+    template <typename T>
+    static void ClosePair(std::map<std::string, std::vector<std::shared_ptr<Richy::CChannel<T>>>>& channels,
+                          const std::string& pair) {
+        auto it = channels.find(pair);
+        if (it == channels.end()) {
+            return;
+        }
+        for (auto& channel : it->second) {
+            channel->Close();
+        }
+        channels.erase(it);
+    }
+
+    void AsyncKrakenApi::CloseStreams(const std::string& pair) {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            ClosePair(mTickers, pair);
+            ClosePair(mBooks, pair);
+            ClosePair(mTrades, pair);
+        }
+        mApi.UnsubscribeFromPair(pair);
+    }
+
+    template <typename T>
+    void AsyncKrakenApi::Dispatch(std::map<std::string, std::vector<std::shared_ptr<Richy::CChannel<T>>>>& channels,
+                                  const std::string& key, const T& value) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = channels.find(key);
+        if (it == channels.end()) {
+            return;
+        }
+        // Un abonné qui a fermé sa file est retiré
+        std::vector<std::shared_ptr<Richy::CChannel<T>>>& subscribers = it->second;
+        for (size_t i = 0; i < subscribers.size();) {
+            if (subscribers[i]->Push(value)) {
+                ++i;
+            } else {
+                subscribers.erase(subscribers.begin() + i);
+            }
+        }
+    }
+
+} // API
@@ -0,0 +1,105 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#ifndef ASYNCKRAKENAPI_H
+#define ASYNCKRAKENAPI_H
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include "KrakenApi.h"
+#include "../core/Task.h"
+#include "../core/Executor.h"
+#include "../core/Channel.h"
+
+namespace API {
+
+    /*
+     * Façade coroutine de KrakenApi.
+     *
+     * Chaque appel REST part sur le pool bloquant de l'exécuteur et reprend
+     * la coroutine sur un thread de travail : des milliers de stratégies
+     * attendent leurs réponses sans occuper de thread.
+     *
+     *     TickerData ticker = co_await async.GetTicker("XBTUSD");
+     *     if (ticker.last == 0.0) {
+     *         std::cout << AsyncKrakenApi::GetLastError();
+     *     }
+     *
+     * Les flux temps réel sont des CChannel alimentés par le thread du flux ;
+     * AsyncKrakenApi prend la main sur les callbacks WebSocket de KrakenApi.
+     */
+    class AsyncKrakenApi {
+        public:
+            AsyncKrakenApi(KrakenApi& api, Richy::CExecutor& executor);
+            ~AsyncKrakenApi();
+
+            // ===== REST =====
+
+            Richy::CTask<bool> TestConnection();
+            Richy::CTask<std::string> GetServerTime();
+            Richy::CTask<TickerData> GetTicker(std::string pair);
+            Richy::CTask<std::vector<TickerData>> GetMultipleTickers(std::vector<std::string> pairs);
+            Richy::CTask<OrderBook> GetOrderBook(std::string pair, int depth = 100);
+            Richy::CTask<std::vector<Trade>> GetRecentTrades(std::string pair, int count = 100);
+            Richy::CTask<std::vector<Balance>> GetAccountBalance();
+            Richy::CTask<std::vector<Order>> GetOpenOrders(std::string pair = "");
+            Richy::CTask<std::string> PlaceMarketOrder(std::string pair, std::string type, double volume);
+            Richy::CTask<std::string> PlaceLimitOrder(std::string pair, std::string type, double volume, double price);
+            Richy::CTask<bool> CancelOrder(std::string orderId);
+            Richy::CTask<bool> CancelAllOrders(std::string pair = "");
+
+            // N'importe quel appel synchrone de KrakenApi
+            template <typename F>
+            Richy::CTask<std::invoke_result_t<F, KrakenApi&>> Call(F call) {
+                KrakenApi* api = &mApi;
+                // Awaiter nommé : GCC 12 détruit deux fois une fermeture temporaire
+                // construite dans une expression co_await
+                auto blocking = mExecutor.Blocking([api, call]() {
+                    auto result = call(*api);
+                    return std::make_pair(std::move(result), api->GetLastError());
+                });
+                auto outcome = co_await blocking;
+                tLastError = std::move(outcome.second);
+                co_return std::move(outcome.first);
+            }
+
+            // ===== FLUX =====
+
+            Richy::CTask<bool> ConnectWebSocket();
+            std::shared_ptr<Richy::CChannel<TickerData>> Tickers(const std::string& pair);
+            std::shared_ptr<Richy::CChannel<OrderBook>> OrderBooks(const std::string& pair, int depth = 10);
+            std::shared_ptr<Richy::CChannel<Trade>> Trades(const std::string& pair);
+            std::shared_ptr<Richy::CChannel<FeedGap>> Gaps();
+            // Ferme tous les flux : les consommateurs reçoivent std::nullopt
+            void CloseStreams();
+            // Ferme les flux d'une paire et la désabonne du WebSocket
+            void CloseStreams(const std::string& pair);
+
+            // Erreur du dernier appel terminé sur ce thread (à lire juste après le co_await)
+            static std::string GetLastError();
+
+        private:
+            template <typename T>
+            void Dispatch(std::map<std::string, std::vector<std::shared_ptr<Richy::CChannel<T>>>>& channels,
+                          const std::string& key, const T& value);
+
+            KrakenApi& mApi;
+            Richy::CExecutor& mExecutor;
+
+            std::mutex mMutex;
+            bool mClosed;
+            std::map<std::string, std::vector<std::shared_ptr<Richy::CChannel<TickerData>>>> mTickers;
+            std::map<std::string, std::vector<std::shared_ptr<Richy::CChannel<OrderBook>>>> mBooks;
+            std::map<std::string, std::vector<std::shared_ptr<Richy::CChannel<Trade>>>> mTrades;
+            std::map<std::string, std::vector<std::shared_ptr<Richy::CChannel<FeedGap>>>> mGaps;
+
+            static thread_local std::string tLastError;
+    };
+
+} // API
+
+#endif //ASYNCKRAKENAPI_H
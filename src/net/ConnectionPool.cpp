@@ -0,0 +1,100 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#include "ConnectionPool.h"
+#include <algorithm>
+#include <netdb.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+namespace API {
+
+    ConnectionPool::ConnectionPool() : mShare(curl_share_init()), mResolve(NULL) {
+        if (mShare) {
+            curl_share_setopt(mShare, CURLSHOPT_LOCKFUNC, Lock);
+            curl_share_setopt(mShare, CURLSHOPT_UNLOCKFUNC, Unlock);
+            curl_share_setopt(mShare, CURLSHOPT_USERDATA, this);
+            curl_share_setopt(mShare, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+            curl_share_setopt(mShare, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+            curl_share_setopt(mShare, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+        }
+    }
+
+    ConnectionPool::~ConnectionPool() {
+        // Les handles rattachés sont tous libérés avant le KrakenApi propriétaire
+        if (mShare) {
+            curl_share_cleanup(mShare);
+        }
+        curl_slist_free_all(mResolve.load());
+        for (struct curl_slist* list : mRetired) {
+            curl_slist_free_all(list);
+        }
+    }
+
+    void ConnectionPool::Lock(CURL*, curl_lock_data data, curl_lock_access, void* pool) {
+        ((ConnectionPool*) pool)->mLocks[data].lock();
+    }
+
+    void ConnectionPool::Unlock(CURL*, curl_lock_data data, void* pool) {
+        ((ConnectionPool*) pool)->mLocks[data].unlock();
+    }
+
+    void ConnectionPool::Attach(CURL* curl) const {
+        if (mShare) {
+            curl_easy_setopt(curl, CURLOPT_SHARE, mShare);
+        }
+        struct curl_slist* resolve = mResolve.load(std::memory_order_acquire);
+        if (resolve) {
+            curl_easy_setopt(curl, CURLOPT_RESOLVE, resolve);
+        }
+    }
+
+    std::string ConnectionPool::Pin(const std::string& host, int port) {
+        struct addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        struct addrinfo* result = NULL;
+        if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &result) != 0) {
+            return "";
+        }
+
+        // IPv6 entre crochets, comme l'attend CURLOPT_RESOLVE
+        std::vector<std::string> entries;
+        for (struct addrinfo* it = result; it; it = it->ai_next) {
+            char text[INET6_ADDRSTRLEN] = {};
+            if (it->ai_family == AF_INET) {
+                inet_ntop(AF_INET, &((struct sockaddr_in*) it->ai_addr)->sin_addr, text, sizeof(text));
+            } else if (it->ai_family == AF_INET6) {
+                inet_ntop(AF_INET6, &((struct sockaddr_in6*) it->ai_addr)->sin6_addr, text, sizeof(text));
+            } else {
+                continue;
+            }
+            std::string address = it->ai_family == AF_INET6 ? "[" + std::string(text) + "]" : std::string(text);
+            if (std::find(entries.begin(), entries.end(), address) == entries.end()) {
+                entries.push_back(address);
+            }
+        }
+        freeaddrinfo(result);
+        if (entries.empty()) {
+            return "";
+        }
+        std::string addresses;
+        for (const std::string& entry : entries) {
+            addresses += (addresses.empty() ? "" : ",") + entry;
+        }
+
+        struct curl_slist* resolve = curl_slist_append(NULL, (host + ":" + std::to_string(port) + ":" + addresses).c_str());
+        if (!resolve) {
+            return "";
+        }
+        std::lock_guard<std::mutex> lock(mMutex);
+        struct curl_slist* previous = mResolve.exchange(resolve, std::memory_order_acq_rel);
+        if (previous) {
+            mRetired.push_back(previous);
+        }
+        return addresses;
+    }
+
+} // API
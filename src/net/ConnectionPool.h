@@ -0,0 +1,54 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#ifndef CONNECTIONPOOL_H
+#define CONNECTIONPOOL_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <curl/curl.h>
+
+namespace API {
+
+    /*
+     * Connexions HTTP partagées entre les requêtes d'un KrakenApi.
+     *
+     * Chaque requête crée son propre handle CURL : sans partage, chacune
+     * refaisait la résolution DNS et la poignée de main TCP/TLS. Le partage
+     * garde d'une requête à l'autre le cache DNS, les sessions TLS et les
+     * connexions ouvertes (un verrou par type de donnée partagée).
+     *
+     * Pin résout un hôte une fois et fige ses adresses (CURLOPT_RESOLVE) :
+     * le chemin d'un ordre ne repasse plus jamais par le DNS, même après
+     * expiration du cache. Appelé depuis plusieurs threads.
+     */
+    class ConnectionPool {
+        public:
+            ConnectionPool();
+            ~ConnectionPool();
+
+            // Rattache un handle au partage et aux adresses figées
+            void Attach(CURL* curl) const;
+
+            // Adresses figées, séparées par des virgules ; vide si la résolution échoue
+            std::string Pin(const std::string& host, int port);
+
+        private:
+            static void Lock(CURL* curl, curl_lock_data data, curl_lock_access access, void* pool);
+            static void Unlock(CURL* curl, curl_lock_data data, void* pool);
+
+            CURLSH* mShare;
+            std::mutex mLocks[CURL_LOCK_DATA_LAST];
+
+            // Les listes remplacées restent valides : un handle en cours peut encore les lire
+            std::atomic<struct curl_slist*> mResolve;
+            std::vector<struct curl_slist*> mRetired;
+            std::mutex mMutex;
+    };
+
+} // API
+
+#endif //CONNECTIONPOOL_H
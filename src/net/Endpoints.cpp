@@ -0,0 +1,347 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#include "Endpoints.h"
+#include <cstdlib>
+#include <chrono>
+#include <algorithm>
+#include <json/json.h>
+
+namespace API {
+
+    // Kraken transmet les montants en chaînes : pas d'exception sur un champ vide
+    static double ToDouble(const Json::Value& value) {
+        if (value.isString()) {
+            return std::atof(value.asCString());
+        }
+        return value.isNumeric() ? value.asDouble() : 0.0;
+    }
+
+    static long Now() {
+        return std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()
+        ).count();
+    }
+
+    static Order DecodeOrder(const std::string& id, const Json::Value& data) {
+        Order order;
+        order.orderId = id;
+        order.pair = data["descr"]["pair"].asString();
+        order.type = data["descr"]["type"].asString();
+        order.orderType = data["descr"]["ordertype"].asString();
+        order.volume = ToDouble(data["vol"]);
+        order.filled = ToDouble(data["vol_exec"]);
+        order.cost = ToDouble(data["cost"]);
+        order.fee = ToDouble(data["fee"]);
+        // Prix moyen d'exécution s'il existe, sinon prix de l'ordre
+        order.price = ToDouble(data["price"]);
+        if (order.price == 0.0) {
+            order.price = ToDouble(data["descr"]["price"]);
+        }
+        order.status = data["status"].asString();
+        order.timestamp = (long) ToDouble(data["opentm"]);
+        order.closed = (long) ToDouble(data["closetm"]);
+        return order;
+    }
+
+    static bool DecodeOrders(const Json::Value& orders, std::vector<Order>& out) {
+        if (!orders.isObject()) {
+            return false;
+        }
+        out.reserve(orders.size());
+        for (auto it = orders.begin(); it != orders.end(); ++it) {
+            out.push_back(DecodeOrder(it.name(), *it));
+        }
+        // Plus récents en premier
+        std::sort(out.begin(), out.end(), [](const Order& a, const Order& b) {
+            return a.timestamp > b.timestamp;
+        });
+        return true;
+    }
+
+    static bool DecodeAmounts(const Json::Value& result, std::map<std::string, double>& out) {
+        if (!result.isObject()) {
+            return false;
+        }
+        for (auto it = result.begin(); it != result.end(); ++it) {
+            out[it.name()] = ToDouble(*it);
+        }
+        return true;
+    }
+
+    // ===== PUBLICS =====
+
+    bool Endpoint<eTime>::Decode(const Json::Value& result, Result& out) {
+        out = result["rfc1123"].asString();
+        return !out.empty();
+    }
+
+    bool Endpoint<eSystemStatus>::Decode(const Json::Value& result, Result& out) {
+        out = result["status"].asString();
+        return !out.empty();
+    }
+
+    bool Endpoint<eAssets>::Decode(const Json::Value& result, Result& out) {
+        if (!result.isObject()) {
+            return false;
+        }
+        for (auto it = result.begin(); it != result.end(); ++it) {
+            out[it.name()] = (*it)["altname"].asString();
+        }
+        return true;
+    }
+
+    bool Endpoint<eAssetPairs>::Decode(const Json::Value& result, Result& out) {
+        if (!result.isObject()) {
+            return false;
+        }
+        for (auto it = result.begin(); it != result.end(); ++it) {
+            const Json::Value& data = *it;
+            PairInfo info;
+            info.name = it.name();
+            info.altname = data["altname"].asString();
+            info.wsname = data["wsname"].asString();
+            info.base = data["base"].asString();
+            info.quote = data["quote"].asString();
+            info.pairDecimals = data["pair_decimals"].asInt();
+            info.lotDecimals = data["lot_decimals"].asInt();
+            info.orderMin = ToDouble(data["ordermin"]);
+            info.tickSize = ToDouble(data["tick_size"]);
+            for (const auto& tier : data["fees"]) {
+                info.fees.push_back({tier[0].asDouble(), tier[1].asDouble()});
+            }
+            for (const auto& tier : data["fees_maker"]) {
+                info.feesMaker.push_back({tier[0].asDouble(), tier[1].asDouble()});
+            }
+            out[info.name] = info;
+        }
+        return true;
+    }
+
+    bool Endpoint<eTicker>::Decode(const Json::Value& result, Result& out) {
+        if (!result.isObject()) {
+            return false;
+        }
+        long now = Now();
+        for (auto it = result.begin(); it != result.end(); ++it) {
+            const Json::Value& data = *it;
+            TickerData ticker;
+            ticker.pair = it.name();
+            ticker.ask = ToDouble(data["a"][0]);
+            ticker.bid = ToDouble(data["b"][0]);
+            ticker.last = ToDouble(data["c"][0]);
+            ticker.volume = ToDouble(data["v"][1]);
+            ticker.high = ToDouble(data["h"][1]);
+            ticker.low = ToDouble(data["l"][1]);
+            ticker.open = ToDouble(data["o"]);
+            ticker.timestamp = now;
+            out[ticker.pair] = ticker;
+        }
+        return true;
+    }
+
+    bool Endpoint<eDepth>::Decode(const Json::Value& result, Result& out) {
+        if (!result.isObject()) {
+            return false;
+        }
+        for (auto it = result.begin(); it != result.end(); ++it) {
+            OrderBook& book = out[it.name()];
+            book.pair = it.name();
+
+            // Asks (vendeurs) puis bids (acheteurs) : [prix, volume, horodatage]
+            const Json::Value& asks = (*it)["asks"];
+            const Json::Value& bids = (*it)["bids"];
+            book.asks.reserve(asks.size());
+            book.bids.reserve(bids.size());
+            for (const auto& ask : asks) {
+                book.asks.push_back({ToDouble(ask[0]), ToDouble(ask[1]), (long) ToDouble(ask[2])});
+            }
+            for (const auto& bid : bids) {
+                book.bids.push_back({ToDouble(bid[0]), ToDouble(bid[1]), (long) ToDouble(bid[2])});
+            }
+        }
+        return true;
+    }
+
+    bool Endpoint<eRecentTrades>::Decode(const Json::Value& result, Result& out) {
+        if (!result.isObject()) {
+            return false;
+        }
+        out.last = result["last"].asString();
+        for (auto it = result.begin(); it != result.end(); ++it) {
+            if (!it->isArray()) {
+                continue;
+            }
+            // [prix, volume, horodatage, côté, type, divers, id]
+            out.trades.reserve(it->size());
+            for (const auto& entry : *it) {
+                Trade trade;
+                trade.price = ToDouble(entry[0]);
+                trade.volume = ToDouble(entry[1]);
+                trade.timestamp = (long) ToDouble(entry[2]);
+                trade.type = entry[3].asString() == "b" ? "buy" : "sell";
+                trade.pair = it.name();
+                trade.id = entry[6].asString();
+                out.trades.push_back(trade);
+            }
+        }
+        return true;
+    }
+
+    bool Endpoint<eOHLC>::Decode(const Json::Value& result, Result& out) {
+        if (!result.isObject()) {
+            return false;
+        }
+        for (auto it = result.begin(); it != result.end(); ++it) {
+            if (!it->isArray()) {
+                continue;
+            }
+            out.reserve(it->size());
+            for (const auto& candle : *it) {
+                std::vector<double> values;
+                values.reserve(candle.size());
+                for (const auto& value : candle) {
+                    values.push_back(ToDouble(value));
+                }
+                out.push_back(values);
+            }
+        }
+        return true;
+    }
+
+    // ===== PRIVÉS =====
+
+    bool Endpoint<eBalance>::Decode(const Json::Value& result, Result& out) {
+        return DecodeAmounts(result, out);
+    }
+
+    bool Endpoint<eBalanceEx>::Decode(const Json::Value& result, Result& out) {
+        if (!result.isObject()) {
+            return false;
+        }
+        // hold_trade : part bloquée par les ordres ouverts
+        for (auto it = result.begin(); it != result.end(); ++it) {
+            Balance balance;
+            balance.currency = it.name();
+            balance.total = ToDouble((*it)["balance"]);
+            balance.locked = ToDouble((*it)["hold_trade"]);
+            balance.available = balance.total - balance.locked;
+            out.push_back(balance);
+        }
+        return true;
+    }
+
+    bool Endpoint<eTradeBalance>::Decode(const Json::Value& result, Result& out) {
+        return DecodeAmounts(result, out);
+    }
+
+    bool Endpoint<eTradeVolume>::Decode(const Json::Value& result, Result& out) {
+        if (!result.isMember("volume")) {
+            return false;
+        }
+        out = ToDouble(result["volume"]);
+        return true;
+    }
+
+    bool Endpoint<eAddOrder>::Decode(const Json::Value& result, Result& out) {
+        const Json::Value& txid = result["txid"];
+        if (!txid.isArray() || txid.empty()) {
+            return false;
+        }
+        out = txid[0].asString();
+        return true;
+    }
+
+    bool Endpoint<eCancelOrder>::Decode(const Json::Value& result, Result& out) {
+        out = result["count"].asInt();
+        return true;
+    }
+
+    bool Endpoint<eCancelAll>::Decode(const Json::Value& result, Result& out) {
+        out = result["count"].asInt();
+        return true;
+    }
+
+    bool Endpoint<eOpenOrders>::Decode(const Json::Value& result, Result& out) {
+        return DecodeOrders(result["open"], out);
+    }
+
+    bool Endpoint<eClosedOrders>::Decode(const Json::Value& result, Result& out) {
+        out.count = result["count"].asInt();
+        return DecodeOrders(result["closed"], out.orders);
+    }
+
+    bool Endpoint<eQueryOrders>::Decode(const Json::Value& result, Result& out) {
+        return DecodeOrders(result, out);
+    }
+
+    bool Endpoint<eTradesHistory>::Decode(const Json::Value& result, Result& out) {
+        const Json::Value& trades = result["trades"];
+        if (!trades.isObject()) {
+            return false;
+        }
+        out.count = result["count"].asInt();
+        out.trades.reserve(trades.size());
+        for (auto it = trades.begin(); it != trades.end(); ++it) {
+            const Json::Value& data = *it;
+            Trade trade;
+            trade.price = ToDouble(data["price"]);
+            trade.volume = ToDouble(data["vol"]);
+            trade.timestamp = (long) ToDouble(data["time"]);
+            trade.type = data["type"].asString();
+            trade.pair = data["pair"].asString();
+            trade.id = it.name();
+            out.trades.push_back(trade);
+        }
+        std::sort(out.trades.begin(), out.trades.end(), [](const Trade& a, const Trade& b) {
+            return a.timestamp > b.timestamp;
+        });
+        return true;
+    }
+
+    bool Endpoint<eOpenPositions>::Decode(const Json::Value& result, Result& out) {
+        if (!result.isObject()) {
+            return false;
+        }
+        for (auto it = result.begin(); it != result.end(); ++it) {
+            const Json::Value& data = *it;
+            Position position;
+            position.pair = data["pair"].asString();
+            position.type = data["type"].asString() == "sell" ? "short" : "long";
+            double vol = ToDouble(data["vol"]);
+            double cost = ToDouble(data["cost"]);
+            position.volume = vol - ToDouble(data["vol_closed"]);
+            position.avgPrice = vol > 0.0 ? cost / vol : 0.0;
+            position.unrealizedPnL = ToDouble(data["net"]);   // présent avec docalcs
+            position.realizedPnL = 0.0;
+            position.timestamp = (long) ToDouble(data["time"]);
+            out.push_back(position);
+        }
+        return true;
+    }
+
+    bool Endpoint<eDepositMethods>::Decode(const Json::Value& result, Result& out) {
+        if (!result.isArray()) {
+            return false;
+        }
+        for (const auto& method : result) {
+            out.push_back(method["method"].asString());
+        }
+        return true;
+    }
+
+    bool Endpoint<eDepositAddresses>::Decode(const Json::Value& result, Result& out) {
+        if (!result.isArray() || result.empty()) {
+            return false;
+        }
+        out = result[0]["address"].asString();
+        return !out.empty();
+    }
+
+    bool Endpoint<eWithdraw>::Decode(const Json::Value& result, Result& out) {
+        out = result["refid"].asString();
+        return !out.empty();
+    }
+
+} // API
@@ -0,0 +1,230 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#ifndef ENDPOINTS_H
+#define ENDPOINTS_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include "KrakenApi.h"
+
+namespace Json {
+    class Value;
+}
+
+namespace API {
+
+    enum EEndpoint : int {
+        // Publics
+        eTime,
+        eSystemStatus,
+        eAssets,
+        eAssetPairs,
+        eTicker,
+        eDepth,
+        eRecentTrades,
+        eOHLC,
+        // Privés
+        eBalance,
+        eBalanceEx,
+        eTradeBalance,
+        eTradeVolume,
+        eAddOrder,
+        eCancelOrder,
+        eCancelAll,
+        eOpenOrders,
+        eClosedOrders,
+        eQueryOrders,
+        eTradesHistory,
+        eOpenPositions,
+        eDepositMethods,
+        eDepositAddresses,
+        eWithdraw,
+        eEndpointCount
+    };
+
+    // Descripteur statique d'un endpoint REST
+    struct EndpointInfo {
+        EEndpoint id;   // les transports aiguillent sur l'id plutôt que sur le nom
+        const char* name;
+        const char* path;
+        bool authenticated;
+        bool post;
+        int cost;   // points consommés dans le compteur de rate-limit
+    };
+
+    /*
+     * Table des endpoints, indexée par EEndpoint.
+     *
+     * Coûts Kraken : 1 point par appel privé, 2 pour les historiques,
+     * 0 pour AddOrder/CancelOrder qui dépendent du limiteur du moteur
+     * d'appariement. Côté public, 1 point par requête.
+     */
+    constexpr EndpointInfo ENDPOINTS[] = {
+        {eTime,             "Time",             "/0/public/Time",               false, false, 1},
+        {eSystemStatus,     "SystemStatus",     "/0/public/SystemStatus",       false, false, 1},
+        {eAssets,           "Assets",           "/0/public/Assets",             false, false, 1},
+        {eAssetPairs,       "AssetPairs",       "/0/public/AssetPairs",         false, false, 1},
+        {eTicker,           "Ticker",           "/0/public/Ticker",             false, false, 1},
+        {eDepth,            "Depth",            "/0/public/Depth",              false, false, 1},
+        {eRecentTrades,     "Trades",           "/0/public/Trades",             false, false, 1},
+        {eOHLC,             "OHLC",             "/0/public/OHLC",               false, false, 1},
+        {eBalance,          "Balance",          "/0/private/Balance",           true,  true,  1},
+        {eBalanceEx,        "BalanceEx",        "/0/private/BalanceEx",         true,  true,  1},
+        {eTradeBalance,     "TradeBalance",     "/0/private/TradeBalance",      true,  true,  1},
+        {eTradeVolume,      "TradeVolume",      "/0/private/TradeVolume",       true,  true,  1},
+        {eAddOrder,         "AddOrder",         "/0/private/AddOrder",          true,  true,  0},
+        {eCancelOrder,      "CancelOrder",      "/0/private/CancelOrder",       true,  true,  0},
+        {eCancelAll,        "CancelAll",        "/0/private/CancelAll",         true,  true,  0},
+        {eOpenOrders,       "OpenOrders",       "/0/private/OpenOrders",        true,  true,  1},
+        {eClosedOrders,     "ClosedOrders",     "/0/private/ClosedOrders",      true,  true,  2},
+        {eQueryOrders,      "QueryOrders",      "/0/private/QueryOrders",       true,  true,  1},
+        {eTradesHistory,    "TradesHistory",    "/0/private/TradesHistory",     true,  true,  2},
+        {eOpenPositions,    "OpenPositions",    "/0/private/OpenPositions",     true,  true,  1},
+        {eDepositMethods,   "DepositMethods",   "/0/private/DepositMethods",    true,  true,  1},
+        {eDepositAddresses, "DepositAddresses", "/0/private/DepositAddresses",  true,  true,  1},
+        {eWithdraw,         "Withdraw",         "/0/private/Withdraw",          true,  true,  1},
+    };
+
+    static_assert(sizeof(ENDPOINTS) / sizeof(ENDPOINTS[0]) == eEndpointCount,
+                  "ENDPOINTS must list every EEndpoint");
+
+    constexpr bool IsConsistent(const EndpointInfo& endpoint) {
+        // Toute requête authentifiée est un POST signé
+        return endpoint.path[0] == '/' && (!endpoint.authenticated || endpoint.post) && endpoint.cost >= 0;
+    }
+
+    constexpr bool CheckEndpoints(int index = 0) {
+        return index == eEndpointCount ||
+               (ENDPOINTS[index].id == index && IsConsistent(ENDPOINTS[index]) && CheckEndpoints(index + 1));
+    }
+
+    static_assert(CheckEndpoints(), "Invalid endpoint descriptor");
+
+    /*
+     * Type de réponse et décodeur de chaque endpoint.
+     * Decode reçoit le champ "result" d'une réponse sans erreur.
+     */
+    template <EEndpoint E> struct Endpoint;
+
+    template <> struct Endpoint<eTime> {
+        typedef std::string Result;   // RFC 1123
+        static bool Decode(const Json::Value& result, Result& out);
+    };
+
+    template <> struct Endpoint<eSystemStatus> {
+        typedef std::string Result;   // online, maintenance, cancel_only, post_only
+        static bool Decode(const Json::Value& result, Result& out);
+    };
+
+    template <> struct Endpoint<eAssets> {
+        typedef std::map<std::string, std::string> Result;   // nom -> altname
+        static bool Decode(const Json::Value& result, Result& out);
+    };
+
+    template <> struct Endpoint<eAssetPairs> {
+        typedef std::map<std::string, PairInfo> Result;
+        static bool Decode(const Json::Value& result, Result& out);
+    };
+
+    // Les réponses de marché sont indexées par le nom Kraken de la paire (XXBTZUSD)
+    template <> struct Endpoint<eTicker> {
+        typedef std::map<std::string, TickerData> Result;
+        static bool Decode(const Json::Value& result, Result& out);
+    };
+
+    template <> struct Endpoint<eDepth> {
+        typedef std::map<std::string, OrderBook> Result;
+        static bool Decode(const Json::Value& result, Result& out);
+    };
+
+    template <> struct Endpoint<eRecentTrades> {
+        typedef TradePage Result;
+        static bool Decode(const Json::Value& result, Result& out);
+    };
+
+    template <> struct Endpoint<eOHLC> {
+        typedef std::vector<std::vector<double>> Result;   // time, open, high, low, close, vwap, volume, count
+        static bool Decode(const Json::Value& result, Result& out);
+    };
+
+    template <> struct Endpoint<eBalance> {
+        typedef std::map<std::string, double> Result;
+        static bool Decode(const Json::Value& result, Result& out);
+    };
+
+    template <> struct Endpoint<eBalanceEx> {
+        typedef std::vector<Balance> Result;
+        static bool Decode(const Json::Value& result, Result& out);
+    };
+
+    template <> struct Endpoint<eTradeBalance> {
+        typedef std::map<std::string, double> Result;   // eb, tb, m, n, c, v, e, mf, ml...
+        static bool Decode(const Json::Value& result, Result& out);
+    };
+
+    template <> struct Endpoint<eTradeVolume> {
+        typedef double Result;   // volume 30 jours en USD
+        static bool Decode(const Json::Value& result, Result& out);
+    };
+
+    template <> struct Endpoint<eAddOrder> {
+        typedef std::string Result;   // txid
+        static bool Decode(const Json::Value& result, Result& out);
+    };
+
+    template <> struct Endpoint<eCancelOrder> {
+        typedef int Result;   // nombre d'ordres annulés
+        static bool Decode(const Json::Value& result, Result& out);
+    };
+
+    template <> struct Endpoint<eCancelAll> {
+        typedef int Result;
+        static bool Decode(const Json::Value& result, Result& out);
+    };
+
+    template <> struct Endpoint<eOpenOrders> {
+        typedef std::vector<Order> Result;
+        static bool Decode(const Json::Value& result, Result& out);
+    };
+
+    template <> struct Endpoint<eClosedOrders> {
+        typedef OrderPage Result;
+        static bool Decode(const Json::Value& result, Result& out);
+    };
+
+    template <> struct Endpoint<eQueryOrders> {
+        typedef std::vector<Order> Result;
+        static bool Decode(const Json::Value& result, Result& out);
+    };
+
+    template <> struct Endpoint<eTradesHistory> {
+        typedef TradePage Result;
+        static bool Decode(const Json::Value& result, Result& out);
+    };
+
+    template <> struct Endpoint<eOpenPositions> {
+        typedef std::vector<Position> Result;
+        static bool Decode(const Json::Value& result, Result& out);
+    };
+
+    template <> struct Endpoint<eDepositMethods> {
+        typedef std::vector<std::string> Result;
+        static bool Decode(const Json::Value& result, Result& out);
+    };
+
+    template <> struct Endpoint<eDepositAddresses> {
+        typedef std::string Result;   // première adresse
+        static bool Decode(const Json::Value& result, Result& out);
+    };
+
+    template <> struct Endpoint<eWithdraw> {
+        typedef std::string Result;   // refid
+        static bool Decode(const Json::Value& result, Result& out);
+    };
+
+} // API
+
+#endif //ENDPOINTS_H
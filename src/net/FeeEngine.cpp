@@ -0,0 +1,121 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#include "FeeEngine.h"
+
+namespace API {
+
+    // Barème de base Kraken si une paire n'a pas de table
+    static const double DEFAULT_TAKER_RATE = 0.0026;
+    static const double DEFAULT_MAKER_RATE = 0.0016;
+
+    FeeEngine::FeeEngine() :
+        mVolume(0.0) {
+    }
+
+    FeeEngine::~FeeEngine() {
+    }
+
+    bool FeeEngine::Refresh(KrakenApi& api) {
+        std::map<std::string, PairInfo> pairs = api.GetPairInfo();
+        if (pairs.empty()) {
+            return false;
+        }
+        Load(pairs);
+        SetVolume(api.GetTradeVolume());
+        return true;
+    }
+
+    void FeeEngine::Load(const std::map<std::string, PairInfo>& pairs) {
+        mIndex.clear();
+        mTakerTiers.clear();
+        mMakerTiers.clear();
+
+        for (const auto& entry : pairs) {
+            PairId id = (PairId) mTakerTiers.size();
+            mIndex[entry.first] = id;
+            if (!entry.second.altname.empty()) {
+                mIndex[entry.second.altname] = id;
+            }
+            mTakerTiers.push_back(entry.second.fees);
+            mMakerTiers.push_back(entry.second.feesMaker.empty() ? entry.second.fees : entry.second.feesMaker);
+        }
+
+        UpdateRates();
+    }
+
+    void FeeEngine::SetVolume(double volume30d) {
+        mVolume = volume30d;
+        UpdateRates();
+    }
+
+    double FeeEngine::GetVolume() const {
+        return mVolume;
+    }
+
+    double FeeEngine::RateForVolume(const std::vector<FeeTier>& tiers, double volume) {
+        if (tiers.empty()) {
+            return -1.0;
+        }
+        // Tables triées par volume croissant : on garde le dernier palier atteint
+        double percent = tiers[0].percent;
+        for (const auto& tier : tiers) {
+            if (volume >= tier.volume) {
+                percent = tier.percent;
+            }
+        }
+        return percent / 100.0;
+    }
+
+    void FeeEngine::UpdateRates() {
+        mTakerRates.resize(mTakerTiers.size());
+        mMakerRates.resize(mMakerTiers.size());
+
+        for (size_t i = 0; i < mTakerTiers.size(); ++i) {
+            double taker = RateForVolume(mTakerTiers[i], mVolume);
+            double maker = RateForVolume(mMakerTiers[i], mVolume);
+            mTakerRates[i] = taker >= 0.0 ? taker : DEFAULT_TAKER_RATE;
+            mMakerRates[i] = maker >= 0.0 ? maker : DEFAULT_MAKER_RATE;
+        }
+    }
+
+    PairId FeeEngine::Find(const std::string& pair) const {
+        auto it = mIndex.find(pair);
+        return it != mIndex.end() ? it->second : INVALID_PAIR;
+    }
+
+    double FeeEngine::GetMakerRate(PairId id) const {
+        return id < mMakerRates.size() ? mMakerRates[id] : DEFAULT_MAKER_RATE;
+    }
+
+    double FeeEngine::GetTakerRate(PairId id) const {
+        return id < mTakerRates.size() ? mTakerRates[id] : DEFAULT_TAKER_RATE;
+    }
+
+    double FeeEngine::CalculateFee(PairId id, double volume, double price, bool maker) const {
+        return volume * price * (maker ? GetMakerRate(id) : GetTakerRate(id));
+    }
+
+    void FeeEngine::Evaluate(const PairId* ids, const double* volumes, const double* prices, const uint8_t* maker,
+                              size_t count, double* notional, double* fees) const {
+        const double* makerRates = mMakerRates.data();
+        const double* takerRates = mTakerRates.data();
+        const size_t pairs = mTakerRates.size();
+
+        // Boucle sans appel ni branche imprévisible : le compilateur peut la vectoriser
+        for (size_t i = 0; i < count; ++i) {
+            double value = volumes[i] * prices[i];
+            bool known = ids[i] < pairs;
+            double rate;
+            if (maker[i]) {
+                rate = known ? makerRates[ids[i]] : DEFAULT_MAKER_RATE;
+            } else {
+                rate = known ? takerRates[ids[i]] : DEFAULT_TAKER_RATE;
+            }
+            notional[i] = value;
+            fees[i] = value * rate;
+        }
+    }
+
+} // API
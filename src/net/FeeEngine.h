@@ -0,0 +1,64 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#ifndef FEEENGINE_H
+#define FEEENGINE_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <cstdint>
+#include "KrakenApi.h"
+
+namespace API {
+
+    /*
+     * Barèmes de frais par paire.
+     *
+     * Les barèmes viennent des tables "fees"/"fees_maker" d'AssetPairs et le
+     * palier de notre volume 30 jours de TradeVolume. Les taux maker/taker du
+     * palier courant sont précalculés par paire : la consultation est O(1) et
+     * ne touche jamais le réseau. Les taux sont des fractions (0.0026 = 0.26%).
+     */
+    class FeeEngine {
+        public:
+            FeeEngine();
+            ~FeeEngine();
+
+            // Chargement des barèmes et du palier
+            bool Refresh(KrakenApi& api);
+            void Load(const std::map<std::string, PairInfo>& pairs);
+            void SetVolume(double volume30d);
+            double GetVolume() const;
+
+            // Résolution hors chemin critique (nom Kraken ou altname)
+            PairId Find(const std::string& pair) const;
+
+            // Consultation O(1)
+            double GetMakerRate(PairId id) const;
+            double GetTakerRate(PairId id) const;
+            double CalculateFee(PairId id, double volume, double price, bool maker) const;
+
+            // Évaluation groupée : notional[i] = volumes[i] * prices[i], fees[i] selon maker[i]
+            void Evaluate(const PairId* ids, const double* volumes, const double* prices, const uint8_t* maker,
+                          size_t count, double* notional, double* fees) const;
+
+        private:
+            static double RateForVolume(const std::vector<FeeTier>& tiers, double volume);
+            void UpdateRates();
+
+            std::unordered_map<std::string, PairId> mIndex;
+            std::vector<std::vector<FeeTier>> mTakerTiers;
+            std::vector<std::vector<FeeTier>> mMakerTiers;
+
+            // Taux du palier courant, indexés par PairId
+            std::vector<double> mTakerRates;
+            std::vector<double> mMakerRates;
+            double mVolume;
+    };
+
+} // API
+
+#endif //FEEENGINE_H
@@ -0,0 +1,37 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#ifndef FUNDSLEDGER_H
+#define FUNDSLEDGER_H
+
+#include <string>
+#include "KrakenApi.h"
+
+namespace API {
+
+    /*
+     * Registre de fonds consulté par KrakenApi sur le chemin des ordres.
+     *
+     * Réservation à l'envoi, renommage sur le txid, suivi des exécutions
+     * observées, libération à la clôture. Implémenté hors de net (registre
+     * des soldes de trading) : net ne dépend que de cette interface.
+     * Appelé depuis plusieurs threads.
+     */
+    class FundsLedger {
+        public:
+            virtual ~FundsLedger() {}
+
+            // 0 tant qu'aucun solde n'a été synchronisé : aucun contrôle des fonds
+            virtual long GetLastSync() const = 0;
+            virtual double GetAvailable(const std::string& currency) const = 0;
+
+            virtual bool Reserve(const std::string& orderId, const std::string& currency, double amount) = 0;
+            virtual bool Rename(const std::string& orderId, const std::string& newOrderId) = 0;
+            virtual void Release(const std::string& orderId) = 0;
+            virtual void OnOrder(const Order& order, const std::string& base, const std::string& quote) = 0;
+    };
+
+} // API
+
+#endif //FUNDSLEDGER_H
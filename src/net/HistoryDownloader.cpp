@@ -0,0 +1,568 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#include "HistoryDownloader.h"
+#include <map>
+#include <chrono>
+#include <thread>
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+#include <unistd.h>
+#include <condition_variable>
+#include "RequestPolicy.h"
+#include "../core/Logger.h"
+#include "../core/Metrics.h"
+
+namespace API {
+
+    // ===== MÉTRIQUES =====
+
+    struct SHistoryMetrics {
+        Richy::CCounter pages = Richy::CMetrics::Counter("richy_history_pages_total");
+        Richy::CCounter rows = Richy::CMetrics::Counter("richy_history_rows_total");
+        Richy::CCounter retries = Richy::CMetrics::Counter("richy_history_retries_total");
+    };
+
+    static SHistoryMetrics& HistoryMetrics() {
+        static SHistoryMetrics metrics;
+        return metrics;
+    }
+
+    static long NowSeconds() {
+        return std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()
+        ).count();
+    }
+
+    static const std::string& RowId(const Trade& trade) {
+        return trade.id;
+    }
+
+    static const std::string& RowId(const Order& order) {
+        return order.orderId;
+    }
+
+    // Horodatage du curseur : exécution d'un trade, clôture d'un ordre
+    static long RowTime(const Trade& trade) {
+        return trade.timestamp;
+    }
+
+    static long RowTime(const Order& order) {
+        return order.closed;
+    }
+
+    // ===== CURSEUR =====
+
+    bool HistoryCursor::Load(const std::string& path) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            return false;
+        }
+        std::string line;
+        if (!std::getline(file, line)) {
+            return false;
+        }
+        timestamp = atol(line.c_str());
+        ids.clear();
+        while (std::getline(file, line)) {
+            if (!line.empty()) {
+                ids.push_back(line);
+            }
+        }
+        return true;
+    }
+
+    bool HistoryCursor::Save(const std::string& path) const {
+        // Écriture dans un fichier temporaire puis renommage atomique
+        std::string tmpPath = path + ".tmp";
+        {
+            std::ofstream file(tmpPath, std::ios::trunc);
+            if (!file.is_open()) {
+                return false;
+            }
+            file << timestamp << "\n";
+            for (const auto& id : ids) {
+                file << id << "\n";
+            }
+            if (!file.good()) {
+                file.close();
+                unlink(tmpPath.c_str());
+                return false;
+            }
+        }
+        if (rename(tmpPath.c_str(), path.c_str()) != 0) {
+            unlink(tmpPath.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    bool HistoryCursor::Advance(long time, const std::string& id) {
+        if (time < timestamp) {
+            return false;
+        }
+        if (time > timestamp) {
+            timestamp = time;
+            ids.clear();
+        } else if (std::find(ids.begin(), ids.end(), id) != ids.end()) {
+            return false;
+        }
+        ids.push_back(id);
+        return true;
+    }
+
+    // ===== FICHIER COLONNES =====
+
+    TradeColumnWriter::TradeColumnWriter() :
+        mFile(nullptr),
+        mBlockRows(4096) {
+    }
+
+    TradeColumnWriter::~TradeColumnWriter() {
+        Close();
+    }
+
+    bool TradeColumnWriter::Open(const std::string& path, size_t blockRows) {
+        Close();
+        mFile = fopen(path.c_str(), "ab");
+        if (!mFile) {
+            return false;
+        }
+        mBlockRows = std::max((size_t) 1, blockRows);
+        mBlock.reserve(mBlockRows);
+
+        fseek(mFile, 0, SEEK_END);
+        if (ftell(mFile) == 0) {
+            if (fwrite(COLUMNS_MAGIC, sizeof(COLUMNS_MAGIC), 1, mFile) != 1 ||
+                fwrite(&COLUMNS_VERSION, sizeof(COLUMNS_VERSION), 1, mFile) != 1) {
+                Close();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool TradeColumnWriter::Append(const Trade& trade) {
+        if (!mFile) {
+            return false;
+        }
+        mBlock.push_back(trade);
+        return mBlock.size() < mBlockRows || Flush();
+    }
+
+    template <typename T>
+    static void WriteColumn(std::string& block, const T& value) {
+        block.append(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+    bool TradeColumnWriter::Flush() {
+        if (!mFile) {
+            return false;
+        }
+        if (mBlock.empty()) {
+            return fflush(mFile) == 0;
+        }
+
+        // Dictionnaire des paires du bloc
+        std::vector<std::string> pairs;
+        std::vector<uint16_t> pairIndex;
+        pairIndex.reserve(mBlock.size());
+        for (const auto& trade : mBlock) {
+            auto it = std::find(pairs.begin(), pairs.end(), trade.pair);
+            if (it == pairs.end()) {
+                pairs.push_back(trade.pair);
+                it = pairs.end() - 1;
+            }
+            pairIndex.push_back((uint16_t) (it - pairs.begin()));
+        }
+
+        std::string block;
+        block.reserve(mBlock.size() * (8 + 8 + 8 + 1 + 2 + 24));
+        WriteColumn<uint32_t>(block, (uint32_t) mBlock.size());
+        WriteColumn<uint16_t>(block, (uint16_t) pairs.size());
+        for (const auto& pair : pairs) {
+            block.append(pair.c_str(), pair.size() + 1);
+        }
+        for (const auto& trade : mBlock) {
+            WriteColumn<int64_t>(block, (int64_t) trade.timestamp);
+        }
+        for (const auto& trade : mBlock) {
+            WriteColumn<double>(block, trade.price);
+        }
+        for (const auto& trade : mBlock) {
+            WriteColumn<double>(block, trade.volume);
+        }
+        for (const auto& trade : mBlock) {
+            WriteColumn<uint8_t>(block, (uint8_t) (trade.type == "buy" ? 'b' : 's'));
+        }
+        for (uint16_t index : pairIndex) {
+            WriteColumn<uint16_t>(block, index);
+        }
+        for (const auto& trade : mBlock) {
+            block.append(trade.id.c_str(), trade.id.size() + 1);
+        }
+
+        mBlock.clear();
+        return fwrite(block.data(), 1, block.size(), mFile) == block.size() && fflush(mFile) == 0;
+    }
+
+    void TradeColumnWriter::Close() {
+        if (mFile) {
+            Flush();
+            fclose(mFile);
+            mFile = nullptr;
+        }
+    }
+
+    // Lecture séquentielle d'un tableau ou d'une chaîne terminée par \0
+    static bool ReadColumn(FILE* file, void* data, size_t size) {
+        return size == 0 || fread(data, size, 1, file) == 1;
+    }
+
+    static bool ReadString(FILE* file, std::string& value) {
+        value.clear();
+        for (int c = fgetc(file); c != '\0'; c = fgetc(file)) {
+            if (c == EOF) {
+                return false;
+            }
+            value.push_back((char) c);
+        }
+        return true;
+    }
+
+    bool TradeColumnWriter::Read(const std::string& path, std::function<bool(const Trade&)> row) {
+        FILE* file = fopen(path.c_str(), "rb");
+        if (!file) {
+            return false;
+        }
+        char magic[sizeof(COLUMNS_MAGIC)];
+        uint32_t version = 0;
+        bool ok = ReadColumn(file, magic, sizeof(magic)) && ReadColumn(file, &version, sizeof(version)) &&
+                  std::memcmp(magic, COLUMNS_MAGIC, sizeof(magic)) == 0 && version == COLUMNS_VERSION;
+
+        uint32_t rows;
+        while (ok && fread(&rows, sizeof(rows), 1, file) == 1) {
+            uint16_t pairCount = 0;
+            ok = ReadColumn(file, &pairCount, sizeof(pairCount));
+            std::vector<std::string> pairs(pairCount);
+            for (auto& pair : pairs) {
+                ok = ok && ReadString(file, pair);
+            }
+
+            std::vector<int64_t> times(rows);
+            std::vector<double> prices(rows);
+            std::vector<double> volumes(rows);
+            std::vector<uint8_t> sides(rows);
+            std::vector<uint16_t> pairIndex(rows);
+            ok = ok && ReadColumn(file, times.data(), rows * sizeof(int64_t)) &&
+                 ReadColumn(file, prices.data(), rows * sizeof(double)) &&
+                 ReadColumn(file, volumes.data(), rows * sizeof(double)) &&
+                 ReadColumn(file, sides.data(), rows * sizeof(uint8_t)) &&
+                 ReadColumn(file, pairIndex.data(), rows * sizeof(uint16_t));
+
+            Trade trade;
+            for (uint32_t i = 0; ok && i < rows; ++i) {
+                ok = ReadString(file, trade.id) && pairIndex[i] < pairs.size();
+                if (!ok) {
+                    break;
+                }
+                trade.timestamp = (long) times[i];
+                trade.price = prices[i];
+                trade.volume = volumes[i];
+                trade.type = sides[i] == 'b' ? "buy" : "sell";
+                trade.pair = pairs[pairIndex[i]];
+                if (!row(trade)) {
+                    fclose(file);
+                    return true;
+                }
+            }
+        }
+        fclose(file);
+        return ok;
+    }
+
+    // ===== TÉLÉCHARGEMENT =====
+
+    HistoryDownloader::HistoryDownloader(KrakenApi& api) :
+        mApi(api),
+        mConcurrency(4),
+        mRetries(5),
+        mPages(0),
+        mStopping(false) {
+    }
+
+    HistoryDownloader::~HistoryDownloader() {
+    }
+
+    void HistoryDownloader::SetConcurrency(int threads) {
+        mConcurrency = std::max(1, threads);
+    }
+
+    void HistoryDownloader::SetRetries(int retries) {
+        mRetries = std::max(0, retries);
+    }
+
+    bool HistoryDownloader::Fetch(const std::function<bool()>& request) {
+        for (int attempt = 0;; ++attempt) {
+            if (mStopping) {
+                return false;
+            }
+            if (request()) {
+                mPages++;
+                HistoryMetrics().pages.Add();
+                return true;
+            }
+            // Budget épuisé, nonce arrivé dans le désordre, réseau : la page est redemandée
+            std::string error = mApi.GetLastError();
+            if (attempt >= mRetries) {
+                SetError(error);
+                return false;
+            }
+            HistoryMetrics().retries.Add();
+            LOG_WARNING("History page attempt {} failed: {}", attempt + 1, error);
+            std::this_thread::sleep_for(std::chrono::milliseconds(RetryBackoff(attempt, 250, 5000)));
+        }
+    }
+
+    template <typename Row>
+    bool HistoryDownloader::Gather(int units, std::function<bool(int unit, std::vector<Row>& rows)> fetch,
+                                   HistoryCursor& cursor, const std::function<bool(const Row&)>& row) {
+        // Avance maximale des threads sur la livraison : borne la mémoire des pages en attente
+        const int window = mConcurrency * 4;
+
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::map<int, std::vector<Row>> ready;
+        int delivering = 0;
+        bool failed = false;
+        std::atomic<int> next(0);
+
+        auto worker = [&]() {
+            for (;;) {
+                int unit = next++;
+                if (unit >= units) {
+                    return;
+                }
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    condition.wait(lock, [&]() {
+                        return mStopping || unit - delivering <= window;
+                    });
+                }
+                if (mStopping) {
+                    return;
+                }
+
+                std::vector<Row> rows;
+                bool ok = fetch(unit, rows);
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (ok) {
+                        ready[unit] = std::move(rows);
+                    } else if (!mStopping) {
+                        // Échec après tous les essais ; un arrêt demandé par le rappel n'en est pas un
+                        failed = true;
+                        mStopping = true;
+                    }
+                }
+                condition.notify_all();
+                if (!ok) {
+                    return;
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < std::min(mConcurrency, units); ++i) {
+            threads.emplace_back(worker);
+        }
+
+        // Livraison dans l'ordre, sur le thread appelant
+        bool ok = true;
+        for (int unit = 0; unit < units && ok; ++unit) {
+            std::vector<Row> rows;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                delivering = unit;
+                condition.notify_all();
+                condition.wait(lock, [&]() {
+                    return failed || ready.count(unit);
+                });
+                auto it = ready.find(unit);
+                if (it == ready.end()) {
+                    ok = false;
+                    break;
+                }
+                rows = std::move(it->second);
+                ready.erase(it);
+            }
+            for (const auto& entry : rows) {
+                if (!cursor.Advance(RowTime(entry), RowId(entry))) {
+                    continue;
+                }
+                HistoryMetrics().rows.Add();
+                if (!row(entry)) {
+                    ok = false;
+                    break;
+                }
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            mStopping = true;
+        }
+        condition.notify_all();
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        return !failed;
+    }
+
+    bool HistoryDownloader::TradeHistory(HistoryCursor& cursor, std::function<bool(const Trade&)> row,
+                                         long start, long end) {
+        mStopping = false;
+        // start est exclusif côté Kraken : la seconde du curseur est redemandée, puis dédoublonnée
+        start = std::max(start, cursor.timestamp - 1);
+        end = end > 0 ? end : NowSeconds();
+
+        // Première page : total de la fenêtre, dont la borne haute reste figée
+        TradePage first;
+        if (!Fetch([&]() {
+            first = TradePage();
+            return mApi.GetTradeHistoryPage(start, end, 0, first);
+        })) {
+            return false;
+        }
+        int size = (int) first.trades.size();
+        if (size == 0) {
+            return true;
+        }
+        int pages = (first.count + size - 1) / size;
+
+        // Unité 0 = page la plus ancienne ; chaque page arrive du plus récent au plus ancien
+        return Gather<Trade>(pages, [&](int unit, std::vector<Trade>& rows) {
+            int page = pages - 1 - unit;
+            if (page == 0) {
+                rows = first.trades;
+            } else {
+                TradePage result;
+                if (!Fetch([&]() {
+                    result = TradePage();
+                    return mApi.GetTradeHistoryPage(start, end, page * size, result);
+                })) {
+                    return false;
+                }
+                rows = std::move(result.trades);
+            }
+            std::reverse(rows.begin(), rows.end());
+            return true;
+        }, cursor, row);
+    }
+
+    bool HistoryDownloader::ClosedOrders(HistoryCursor& cursor, std::function<bool(const Order&)> row,
+                                         long start, long end) {
+        mStopping = false;
+        // Fenêtre et curseur sur l'heure de clôture
+        start = std::max(start, cursor.timestamp - 1);
+        end = end > 0 ? end : NowSeconds();
+
+        OrderPage first;
+        if (!Fetch([&]() {
+            first = OrderPage();
+            return mApi.GetClosedOrdersPage(start, end, 0, first);
+        })) {
+            return false;
+        }
+        int size = (int) first.orders.size();
+        if (size == 0) {
+            return true;
+        }
+        int pages = (first.count + size - 1) / size;
+
+        return Gather<Order>(pages, [&](int unit, std::vector<Order>& rows) {
+            int page = pages - 1 - unit;
+            if (page == 0) {
+                rows = first.orders;
+            } else {
+                OrderPage result;
+                if (!Fetch([&]() {
+                    result = OrderPage();
+                    return mApi.GetClosedOrdersPage(start, end, page * size, result);
+                })) {
+                    return false;
+                }
+                rows = std::move(result.orders);
+            }
+            // Pages décodées par heure d'ouverture : remises dans l'ordre de clôture
+            std::stable_sort(rows.begin(), rows.end(), [](const Order& a, const Order& b) {
+                return a.closed < b.closed;
+            });
+            return true;
+        }, cursor, row);
+    }
+
+    bool HistoryDownloader::RecentTrades(const std::string& pair, HistoryCursor& cursor,
+                                         std::function<bool(const Trade&)> row, long start, long end) {
+        mStopping = false;
+        start = std::max(start, cursor.timestamp);
+        if (start <= 0) {
+            SetError("RecentTrades needs a start time or a cursor");
+            return false;
+        }
+        // Tranches [from, to[ en secondes, au moins une minute chacune
+        long stop = (end > 0 ? end : NowSeconds()) + 1;
+        if (stop <= start) {
+            return true;
+        }
+        int slices = (int) std::max(1L, std::min((long) mConcurrency * 4, (stop - start) / 60));
+        long length = (stop - start + slices - 1) / slices;
+
+        return Gather<Trade>(slices, [&](int unit, std::vector<Trade>& rows) {
+            long from = start + unit * length;
+            long to = std::min(stop, from + length);
+            // "since" est exclusif : une nanoseconde avant le début de la tranche
+            std::string since = std::to_string(from * 1000000000LL - 1);
+            for (;;) {
+                TradePage page;
+                if (!Fetch([&]() {
+                    page = TradePage();
+                    return mApi.GetTradesPage(pair, since, page);
+                })) {
+                    return false;
+                }
+                bool done = page.trades.empty() || page.last == since;
+                for (auto& trade : page.trades) {
+                    if (trade.timestamp >= to) {
+                        done = true;
+                        break;
+                    }
+                    if (trade.timestamp >= from) {
+                        rows.push_back(std::move(trade));
+                    }
+                }
+                if (done) {
+                    return true;
+                }
+                since = page.last;
+            }
+        }, cursor, row);
+    }
+
+    unsigned long HistoryDownloader::GetPages() const {
+        return mPages.load();
+    }
+
+    void HistoryDownloader::SetError(const std::string& error) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mLastError = error;
+    }
+
+    std::string HistoryDownloader::GetLastError() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mLastError;
+    }
+
+} // API
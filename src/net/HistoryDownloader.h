@@ -0,0 +1,133 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#ifndef HISTORYDOWNLOADER_H
+#define HISTORYDOWNLOADER_H
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <cstdio>
+#include <cstdint>
+#include <functional>
+#include "KrakenApi.h"
+
+namespace API {
+
+    static const char COLUMNS_MAGIC[4] = {'R', 'C', 'O', 'L'};
+    static const uint32_t COLUMNS_VERSION = 100;
+
+    /*
+     * Position atteinte dans un historique : horodatage de la dernière ligne
+     * livrée, et identifiants déjà livrés à cette seconde (Kraken ne borne
+     * qu'à la seconde). Une synchronisation suivante repart de là et ne
+     * télécharge que les nouvelles lignes.
+     */
+    struct HistoryCursor {
+        long timestamp = 0;
+        std::vector<std::string> ids;
+
+        bool Load(const std::string& path);
+        bool Save(const std::string& path) const;
+
+        // false si la ligne a déjà été livrée ; sinon le curseur avance
+        bool Advance(long time, const std::string& id);
+    };
+
+    /*
+     * Fichier colonnes de trades, en blocs ajoutés à la suite :
+     *
+     *     COLUMNS_MAGIC | COLUMNS_VERSION u32
+     *     bloc : lignes u32 | paires u16 + noms (\0) | time i64[] | price f64[] |
+     *            volume f64[] | side u8[] | paire u16[] | id (\0)[]
+     *
+     * Chaque colonne d'un bloc est contiguë : une lecture d'une seule colonne
+     * saute les autres. Ouvert en ajout pour reprendre une synchronisation.
+     */
+    class TradeColumnWriter {
+        public:
+            TradeColumnWriter();
+            ~TradeColumnWriter();
+
+            bool Open(const std::string& path, size_t blockRows = 4096);
+            bool Append(const Trade& trade);
+            bool Flush();
+            void Close();
+
+            static bool Read(const std::string& path, std::function<bool(const Trade&)> row);
+
+        private:
+            FILE* mFile;
+            size_t mBlockRows;
+            std::vector<Trade> mBlock;
+    };
+
+    /*
+     * Téléchargement parallèle des historiques, livrés dans l'ordre.
+     *
+     * Historiques privés : la première page (ofs = 0) donne le total de la
+     * fenêtre ]start, end], dont la borne haute est figée ; les pages
+     * suivantes partent ensuite en parallèle, des plus anciennes aux plus
+     * récentes. Trades publics : la fenêtre est découpée en tranches de
+     * temps, parcourues chacune par "since".
+     *
+     *     HistoryCursor cursor;
+     *     cursor.Load("fills.cursor");
+     *     HistoryDownloader history(api);
+     *     history.TradeHistory(cursor, [&](const Trade& trade) {
+     *         return file.Append(trade);
+     *     });
+     *     cursor.Save("fills.cursor");
+     *
+     * Les lignes arrivent de la plus ancienne à la plus récente, sur le
+     * thread appelant ; un rappel qui renvoie false arrête le téléchargement
+     * et le curseur reste sur la dernière ligne livrée. Les requêtes passent
+     * par les budgets de rate-limit de l'api ; une page en échec est
+     * redemandée (lectures sans effet de bord). En parallèle, les nonces
+     * privés peuvent arriver dans le désordre : prévoir une fenêtre de nonce
+     * sur la clé.
+     */
+    class HistoryDownloader {
+        public:
+            explicit HistoryDownloader(KrakenApi& api);
+            ~HistoryDownloader();
+
+            void SetConcurrency(int threads);
+            void SetRetries(int retries);
+
+            // end = 0 : jusqu'à maintenant ; start = 0 : depuis le début (ou le curseur)
+            bool TradeHistory(HistoryCursor& cursor, std::function<bool(const Trade&)> row,
+                              long start = 0, long end = 0);
+            bool ClosedOrders(HistoryCursor& cursor, std::function<bool(const Order&)> row,
+                              long start = 0, long end = 0);
+            // Trades publics : start obligatoire si le curseur est vide
+            bool RecentTrades(const std::string& pair, HistoryCursor& cursor,
+                              std::function<bool(const Trade&)> row, long start = 0, long end = 0);
+
+            unsigned long GetPages() const;
+            std::string GetLastError() const;
+
+        private:
+            // Unités (pages ou tranches) téléchargées en parallèle, livrées dans l'ordre des indices
+            template <typename Row>
+            bool Gather(int units, std::function<bool(int unit, std::vector<Row>& rows)> fetch,
+                        HistoryCursor& cursor, const std::function<bool(const Row&)>& row);
+
+            bool Fetch(const std::function<bool()>& request);
+            void SetError(const std::string& error);
+
+            KrakenApi& mApi;
+            int mConcurrency;
+            int mRetries;
+            std::atomic<unsigned long> mPages;
+            std::atomic<bool> mStopping;
+
+            mutable std::mutex mMutex;
+            std::string mLastError;
+    };
+
+} // API
+
+#endif //HISTORYDOWNLOADER_H
@@ -0,0 +1,362 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#include "KeyPool.h"
+#include <thread>
+#include <algorithm>
+#include "../core/Logger.h"
+
+namespace API {
+
+    thread_local std::string KeyPool::tLastError;
+
+    KeyPool::KeyPool() :
+        mRouting(eRoutePairAffinity),
+        mRisk(new RiskGate()) {
+    }
+
+    KeyPool::~KeyPool() {
+    }
+
+    // ===== CLÉS =====
+
+    size_t KeyPool::AddKey(const std::string& apiKey, const std::string& apiSecret) {
+        std::unique_ptr<SKey> key(new SKey());
+        key->owned.reset(new KrakenApi());
+        key->api = key->owned.get();
+        key->api->SetCredentials(apiKey, apiSecret);
+        key->api->SetRiskGate(mRisk);
+        mKeys.push_back(std::move(key));
+        return mKeys.size() - 1;
+    }
+
+    size_t KeyPool::AddKey(KrakenApi& api) {
+        std::unique_ptr<SKey> key(new SKey());
+        key->api = &api;
+        key->api->SetRiskGate(mRisk);
+        mKeys.push_back(std::move(key));
+        return mKeys.size() - 1;
+    }
+
+    size_t KeyPool::GetSize() const {
+        return mKeys.size();
+    }
+
+    KrakenApi& KeyPool::GetKey(size_t index) {
+        return *mKeys[index]->api;
+    }
+
+    void KeyPool::ForEach(const std::function<void(KrakenApi&)>& apply) {
+        for (auto& key : mKeys) {
+            apply(*key->api);
+        }
+    }
+
+    void KeyPool::SetRouting(EKeyRouting routing) {
+        mRouting.store(routing, std::memory_order_relaxed);
+    }
+
+    EKeyRouting KeyPool::ParseRouting(const std::string& name) {
+        return name == "least_loaded" ? eRouteLeastLoaded : eRoutePairAffinity;
+    }
+
+    // ===== ROUTAGE =====
+
+    size_t KeyPool::Route(const std::string& pair) {
+        if (mKeys.size() <= 1) {
+            return 0;
+        }
+
+        if (mRouting.load(std::memory_order_relaxed) == eRoutePairAffinity) {
+            // FNV-1a : les limites d'ordres par paire de Kraken restent sur un seul compte
+            uint32_t hash = 2166136261u;
+            for (char c : pair) {
+                hash = (hash ^ (uint8_t) c) * 16777619u;
+            }
+            return hash % mKeys.size();
+        }
+
+        // Moins d'appels en cours, puis plus de marge dans le compteur privé, puis moins d'ordres
+        size_t best = 0;
+        int bestInflight = 0;
+        double bestHeadroom = 0.0;
+        unsigned long bestOrders = 0;
+        for (size_t i = 0; i < mKeys.size(); ++i) {
+            SKey& key = *mKeys[i];
+            int inflight = key.inflight.load(std::memory_order_relaxed);
+            double headroom = key.api->GetPrivateHeadroom();
+            if (headroom < 0.0) {
+                headroom = 1e9;
+            }
+            unsigned long orders = key.orders.load(std::memory_order_relaxed);
+            if (i == 0 || inflight < bestInflight ||
+                (inflight == bestInflight && (headroom > bestHeadroom ||
+                                              (headroom == bestHeadroom && orders < bestOrders)))) {
+                best = i;
+                bestInflight = inflight;
+                bestHeadroom = headroom;
+                bestOrders = orders;
+            }
+        }
+        return best;
+    }
+
+    // ===== PROPRIÉTAIRES DES ORDRES =====
+
+    void KeyPool::Remember(const std::string& orderId, size_t index) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mOwners[orderId] = index;
+    }
+
+    void KeyPool::Forget(const std::string& orderId) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mOwners.erase(orderId);
+    }
+
+    bool KeyPool::FindOwner(const std::string& orderId, size_t& index) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mOwners.find(orderId);
+        if (it == mOwners.end()) {
+            return false;
+        }
+        index = it->second;
+        return true;
+    }
+
+    // ===== ORDRES =====
+
+    std::string KeyPool::PlaceOrder(const std::string& pair, const std::string& type,
+                                    const std::string& orderType, double volume,
+                                    double price, const std::map<std::string, std::string>& options) {
+        if (mKeys.empty()) {
+            tLastError = "Key pool is empty";
+            return "";
+        }
+
+        // Jamais rejoué sur une autre clé : un AddOrder en timeout a pu être exécuté
+        size_t index = Route(pair);
+        SKey& key = *mKeys[index];
+        key.inflight++;
+        std::string orderId = key.api->PlaceOrder(pair, type, orderType, volume, price, options);
+        key.inflight--;
+
+        if (orderId.empty()) {
+            tLastError = key.api->GetLastError();
+            return "";
+        }
+        key.orders++;
+        Remember(orderId, index);
+        tLastError.clear();
+        return orderId;
+    }
+
+    std::string KeyPool::PlaceMarketOrder(const std::string& pair, const std::string& type, double volume) {
+        return PlaceOrder(pair, type, "market", volume);
+    }
+
+    std::string KeyPool::PlaceLimitOrder(const std::string& pair, const std::string& type,
+                                         double volume, double price) {
+        return PlaceOrder(pair, type, "limit", volume, price);
+    }
+
+    bool KeyPool::CancelOrder(const std::string& orderId) {
+        size_t index;
+        if (FindOwner(orderId, index)) {
+            SKey& key = *mKeys[index];
+            key.inflight++;
+            bool cancelled = key.api->CancelOrder(orderId);
+            key.inflight--;
+            tLastError = cancelled ? "" : key.api->GetLastError();
+            if (cancelled) {
+                Forget(orderId);
+            }
+            return cancelled;
+        }
+
+        // Ordre placé hors du pool : la clé qui le connaît est la seule à pouvoir l'annuler
+        for (auto& key : mKeys) {
+            if (key->api->CancelOrder(orderId)) {
+                tLastError.clear();
+                return true;
+            }
+            tLastError = key->api->GetLastError();
+        }
+        return false;
+    }
+
+    bool KeyPool::CancelAllOrders() {
+        std::vector<int> cancelled = Gather<int>([](KrakenApi& api) {
+            return api.CancelAllOrders() ? 1 : 0;
+        });
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mOwners.clear();
+        }
+        return std::all_of(cancelled.begin(), cancelled.end(), [](int ok) {
+            return ok != 0;
+        });
+    }
+
+    Order KeyPool::GetOrderInfo(const std::string& orderId) {
+        size_t index;
+        if (FindOwner(orderId, index)) {
+            Order order = mKeys[index]->api->GetOrderInfo(orderId);
+            tLastError = order.orderId.empty() ? mKeys[index]->api->GetLastError() : "";
+            return order;
+        }
+
+        for (size_t i = 0; i < mKeys.size(); ++i) {
+            Order order = mKeys[i]->api->GetOrderInfo(orderId);
+            if (!order.orderId.empty()) {
+                Remember(orderId, i);
+                tLastError.clear();
+                return order;
+            }
+            tLastError = mKeys[i]->api->GetLastError();
+        }
+        return Order();
+    }
+
+    // ===== AGRÉGATS =====
+
+    template <typename R>
+    std::vector<R> KeyPool::Gather(const std::function<R(KrakenApi&)>& call) {
+        // Une requête par clé, en parallèle : chaque clé a son budget, rien ne se sérialise
+        std::vector<R> results(mKeys.size());
+        std::vector<std::string> errors(mKeys.size());
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < mKeys.size(); ++i) {
+            threads.emplace_back([this, &call, &results, &errors, i]() {
+                results[i] = call(*mKeys[i]->api);
+                errors[i] = mKeys[i]->api->GetLastError();
+            });
+        }
+        if (!mKeys.empty()) {
+            results[0] = call(*mKeys[0]->api);
+            errors[0] = mKeys[0]->api->GetLastError();
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        tLastError.clear();
+        for (size_t i = 0; i < errors.size(); ++i) {
+            if (!errors[i].empty()) {
+                tLastError = "Key " + std::to_string(i) + ": " + errors[i];
+                LOG_WARNING("Key pool: key {} failed: {}", i, errors[i]);
+                break;
+            }
+        }
+        return results;
+    }
+
+    std::vector<Balance> KeyPool::GetAccountBalance() {
+        std::vector<std::vector<Balance>> perKey = Gather<std::vector<Balance>>([](KrakenApi& api) {
+            return api.GetAccountBalance();
+        });
+
+        std::map<std::string, Balance> totals;
+        for (const auto& balances : perKey) {
+            for (const auto& balance : balances) {
+                auto inserted = totals.emplace(balance.currency, balance);
+                if (!inserted.second) {
+                    Balance& total = inserted.first->second;
+                    total.available += balance.available;
+                    total.locked += balance.locked;
+                    total.total += balance.total;
+                }
+            }
+        }
+
+        std::vector<Balance> result;
+        result.reserve(totals.size());
+        for (auto& entry : totals) {
+            result.push_back(entry.second);
+        }
+        return result;
+    }
+
+    std::vector<Order> KeyPool::GetOpenOrders(const std::string& pair) {
+        std::vector<std::vector<Order>> perKey = Gather<std::vector<Order>>([&pair](KrakenApi& api) {
+            return api.GetOpenOrders(pair);
+        });
+
+        // Les ordres ouverts rattachent aussi ceux placés avant le pool à leur clé
+        std::vector<Order> result;
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (size_t i = 0; i < perKey.size(); ++i) {
+            for (auto& order : perKey[i]) {
+                mOwners[order.orderId] = i;
+                result.push_back(std::move(order));
+            }
+        }
+        return result;
+    }
+
+    std::vector<Order> KeyPool::GetClosedOrders(const std::string& pair, int count) {
+        std::vector<std::vector<Order>> perKey = Gather<std::vector<Order>>([&pair, count](KrakenApi& api) {
+            return api.GetClosedOrders(pair, count);
+        });
+
+        std::vector<Order> result;
+        for (auto& orders : perKey) {
+            std::move(orders.begin(), orders.end(), std::back_inserter(result));
+        }
+        std::sort(result.begin(), result.end(), [](const Order& a, const Order& b) {
+            return a.timestamp > b.timestamp;
+        });
+        if (count >= 0 && result.size() > (size_t) count) {
+            result.resize(count);
+        }
+        return result;
+    }
+
+    std::vector<Trade> KeyPool::GetTradeHistory(const std::string& pair, int count) {
+        std::vector<std::vector<Trade>> perKey = Gather<std::vector<Trade>>([&pair, count](KrakenApi& api) {
+            return api.GetTradeHistory(pair, count);
+        });
+
+        std::vector<Trade> result;
+        for (auto& trades : perKey) {
+            std::move(trades.begin(), trades.end(), std::back_inserter(result));
+        }
+        std::sort(result.begin(), result.end(), [](const Trade& a, const Trade& b) {
+            return a.timestamp > b.timestamp;
+        });
+        if (count >= 0 && result.size() > (size_t) count) {
+            result.resize(count);
+        }
+        return result;
+    }
+
+    // ===== RISQUE =====
+
+    RiskGate& KeyPool::GetRiskGate() {
+        return *mRisk;
+    }
+
+    void KeyPool::SetRiskGate(std::shared_ptr<RiskGate> gate) {
+        mRisk = gate;
+        for (auto& key : mKeys) {
+            key->api->SetRiskGate(gate);
+        }
+    }
+
+    void KeyPool::OnTicker(const TickerData& ticker) {
+        mRisk->OnTicker(ticker);
+    }
+
+    void KeyPool::Trip() {
+        mRisk->Trip();
+    }
+
+    void KeyPool::Reset() {
+        mRisk->Reset();
+    }
+
+    std::string KeyPool::GetLastError() {
+        return tLastError;
+    }
+
+} // API
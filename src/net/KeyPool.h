@@ -0,0 +1,130 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#ifndef KEYPOOL_H
+#define KEYPOOL_H
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include "KrakenApi.h"
+#include "RiskGate.h"
+
+namespace API {
+
+    enum EKeyRouting : uint8_t {
+        eRoutePairAffinity = 0,     // une paire toujours sur la même clé
+        eRouteLeastLoaded           // clé la moins occupée, puis la plus de marge de rate-limit
+    };
+
+    /*
+     * Pool de clés API (comptes ou sous-comptes) derrière une façade unique.
+     *
+     * Chaque clé a son propre KrakenApi : connexions, source de nonce et
+     * budget de rate-limit privé. Les ordres sont répartis selon la
+     * politique de routage ; annulations et consultations suivent la clé
+     * qui a placé l'ordre. Soldes et ordres sont agrégés sur toutes les
+     * clés, interrogées en parallèle.
+     *
+     *     KeyPool pool;
+     *     pool.AddKey(api);               // clé principale, déjà utilisée ailleurs
+     *     pool.AddKey(key2, secret2);
+     *     pool.ForEach([](KrakenApi& api) { api.SetRateLimits(1, 15); });
+     *     std::string id = pool.PlaceLimitOrder("XBTUSD", "buy", 0.01, 60000.0);
+     *     pool.CancelOrder(id);
+     *
+     * Les clés sont ajoutées avant le premier appel ; ensuite la façade
+     * s'utilise depuis plusieurs threads. Toutes les clés partagent un seul
+     * contrôle pré-trade : limites, positions et coupe-circuit valent pour
+     * le compte entier, quel que soit le nombre de clés.
+     */
+    class KeyPool {
+        public:
+            KeyPool();
+            ~KeyPool();
+
+            // Indice de la nouvelle clé
+            size_t AddKey(const std::string& apiKey, const std::string& apiSecret);
+            // Clé portée par un KrakenApi existant (non possédé, doit survivre au pool) :
+            // une clé n'a qu'une instance, donc qu'une source de nonce
+            size_t AddKey(KrakenApi& api);
+            size_t GetSize() const;
+            KrakenApi& GetKey(size_t index);
+
+            // Réglage commun (timeouts, budgets, limites de risque, url)
+            void ForEach(const std::function<void(KrakenApi&)>& apply);
+
+            void SetRouting(EKeyRouting routing);
+            static EKeyRouting ParseRouting(const std::string& name);
+
+            // ===== ORDRES =====
+
+            std::string PlaceOrder(const std::string& pair, const std::string& type,
+                                   const std::string& orderType, double volume,
+                                   double price = 0.0, const std::map<std::string, std::string>& options = {});
+            std::string PlaceMarketOrder(const std::string& pair, const std::string& type, double volume);
+            std::string PlaceLimitOrder(const std::string& pair, const std::string& type,
+                                        double volume, double price);
+
+            bool CancelOrder(const std::string& orderId);
+            bool CancelAllOrders();
+            Order GetOrderInfo(const std::string& orderId);
+
+            // ===== AGRÉGATS =====
+
+            std::vector<Balance> GetAccountBalance();
+            std::vector<Order> GetOpenOrders(const std::string& pair = "");
+            std::vector<Order> GetClosedOrders(const std::string& pair = "", int count = 50);
+            std::vector<Trade> GetTradeHistory(const std::string& pair = "", int count = 50);
+
+            // ===== RISQUE =====
+
+            // Contrôle commun, posé sur chaque clé ; à partager avec le KrakenApi principal
+            // (SetRiskGate avant AddKey et le premier ordre)
+            RiskGate& GetRiskGate();
+            void SetRiskGate(std::shared_ptr<RiskGate> gate);
+            void OnTicker(const TickerData& ticker);
+            void Trip();
+            void Reset();
+
+            // Clé choisie pour la paire, selon la politique courante
+            size_t Route(const std::string& pair);
+
+            // Dernière erreur du thread appelant (toutes clés confondues)
+            static std::string GetLastError();
+
+        private:
+            struct SKey {
+                std::unique_ptr<KrakenApi> owned;
+                KrakenApi* api = nullptr;
+                std::atomic<int> inflight{0};
+                std::atomic<unsigned long> orders{0};
+            };
+
+            // Clé connue de l'ordre, sinon essai de chaque clé
+            bool FindOwner(const std::string& orderId, size_t& index);
+            void Remember(const std::string& orderId, size_t index);
+            void Forget(const std::string& orderId);
+
+            template <typename R>
+            std::vector<R> Gather(const std::function<R(KrakenApi&)>& call);
+
+            std::vector<std::unique_ptr<SKey>> mKeys;
+            std::atomic<EKeyRouting> mRouting;
+            std::shared_ptr<RiskGate> mRisk;
+
+            mutable std::mutex mMutex;
+            std::map<std::string, size_t> mOwners;      // txid -> clé
+
+            static thread_local std::string tLastError;
+    };
+
+} // API
+
+#endif //KEYPOOL_H
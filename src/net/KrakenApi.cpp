@@ -3,12 +3,30 @@
 //
 
 #include "KrakenApi.h"
+#include "SingleFlight.h"
+#include "RefDataCache.h"
+#include "RequestPolicy.h"
+#include "KrakenFeed.h"
+#include "MarketBus.h"
+#include "RiskGate.h"
+#include "Endpoints.h"
+#include "LatencyProbe.h"
+#include "Transport.h"
+#include "ConnectionPool.h"
+#include "FeeEngine.h"
+#include "FundsLedger.h"
+#include "PositionTracker.h"
+#include "../core/Logger.h"
+#include "../core/Metrics.h"
+#include "../core/ThreadLayout.h"
 #include <iostream>
 #include <sstream>
 #include <iomanip>
 #include <chrono>
 #include <ctime>
 #include <algorithm>
+#include <cctype>
+#include <thread>
 #include <curl/curl.h>
 #include <openssl/hmac.h>
 #include <openssl/sha.h>
@@ -25,19 +43,116 @@ namespace API {
         return size * nmemb;
     }
 
+    // Callback CURL appelé à la création de chaque socket
+    static int SockOptCallback(void* clientp, curl_socket_t fd, curlsocktype purpose) {
+        int busyPollUs = ((std::atomic<int>*) clientp)->load(std::memory_order_relaxed);
+        if (purpose == CURLSOCKTYPE_IPCXN && busyPollUs > 0) {
+            Richy::CThreadLayout::EnableBusyPoll(fd, busyPollUs);
+        }
+        return CURL_SOCKOPT_OK;
+    }
+
+    // Callback CURL de trace (sondes de latence actives) : en-têtes de la requête envoyés
+    static int DebugCallback(CURL*, curl_infotype type, char*, size_t, void*) {
+        if (type == CURLINFO_HEADER_OUT) {
+            LatencyProbe::Mark(eStageWrite);
+        }
+        return 0;
+    }
+
+    thread_local std::string KrakenApi::mLastError;
+
     KrakenApi::KrakenApi() : 
         mApiKey(""), 
         mApiSecret(""), 
         mBaseUrl("https://api.kraken.com"),
         mSandboxMode(false),
-        mLastError("") {
+        mBusyPollUs(0),
+        mTradeVolume(0.0),
+        mRequestTimeoutMs(30000),
+        mConnectTimeoutMs(5000),
+        mMaxRetries(2),
+        mRetryBaseMs(50),
+        mHedging(false),
+        mLastNonce(0),
+        mLatency(new LatencyTracker()),
+        mPublicBudget(new RateBudget()),
+        mPrivateBudget(new RateBudget()),
+        mSingleFlight(new SingleFlight()),
+        mRisk(new RiskGate()),
+        mPendingOrders(0),
+        mFeed(new KrakenFeed()) {
         
         // Initialisation de CURL
         curl_global_init(CURL_GLOBAL_DEFAULT);
+        mConnections.reset(new ConnectionPool());
+        mRefData.reset(new RefDataCache());
+        mRefData->SetPublishHandler([this]() {
+            RebuildFees();
+        });
+        RebuildFees();
+        
+        // Le flux relaie vers le contrôle pré-trade, l'éditeur éventuel puis les callbacks courants
+        mFeed->SetTickerHandler([this](const TickerData& ticker) {
+            mRisk->OnTicker(ticker);
+            if (mPositions) {
+                mPositions->OnTicker(ticker);
+            }
+            if (mTransport) {
+                mTransport->OnTicker(ticker);
+            }
+            if (mPublisher) {
+                mPublisher->PublishTicker(ticker);
+            }
+            if (mTickerCallback) {
+                LatencyProbe::Mark(eStageDispatch);
+                mTickerCallback(ticker);
+            }
+        });
+        mFeed->SetOrderBookHandler([this](const OrderBook& book) {
+            if (mTransport) {
+                mTransport->OnOrderBook(book);
+            }
+            if (mPublisher) {
+                mPublisher->PublishBook(book);
+            }
+            if (mOrderBookCallback) {
+                LatencyProbe::Mark(eStageDispatch);
+                mOrderBookCallback(book);
+            }
+        });
+        mFeed->SetTradeHandler([this](const Trade& trade) {
+            if (mTransport) {
+                mTransport->OnTrade(trade);
+            }
+            if (mPublisher) {
+                mPublisher->PublishTrade(trade);
+            }
+            if (mTradeCallback) {
+                mTradeCallback(trade);
+            }
+        });
+        mFeed->SetGapHandler([this](const FeedGap& gap) {
+            if (mPublisher) {
+                mPublisher->PublishGap(gap);
+            }
+            if (mGapCallback) {
+                mGapCallback(gap);
+            }
+        });
+        
+        mTickerBatcher.reset(new TickerBatcher([this](const std::vector<std::string>& pairs, std::string& error) {
+            std::vector<TickerData> tickers = GetMultipleTickers(pairs);
+            error = mLastError;
+            return tickers;
+        }));
     }
 
     KrakenApi::~KrakenApi() {
         DisconnectWebSocket();
+        // Le rafraîchissement de fond utilise les connexions
+        mRefData.reset();
+        mConnections.reset();
         curl_global_cleanup();
     }
 
@@ -55,31 +170,234 @@ namespace API {
         }
     }
 
+    void KrakenApi::SetBaseUrl(const std::string& baseUrl) {
+        // Proxy, passerelle locale ou exchange simulé
+        mBaseUrl = baseUrl;
+    }
+
+    void KrakenApi::SetTransport(std::shared_ptr<Transport> transport) {
+        // À poser avant ConnectWebSocket : le thread du flux le lit sans verrou
+        mTransport = transport;
+    }
+
+    void KrakenApi::SetTickerBatchWindow(long microseconds) {
+        mTickerBatcher->SetWindow(microseconds);
+    }
+
+    unsigned long KrakenApi::GetCoalescedRequests() const {
+        return mSingleFlight->GetShared();
+    }
+
+    void KrakenApi::SetBusyPoll(int microseconds) {
+        mBusyPollUs = microseconds;
+        mFeed->SetBusyPoll(microseconds);
+    }
+
+    void KrakenApi::SetTimeouts(long requestMs, long connectMs) {
+        mRequestTimeoutMs = requestMs;
+        mConnectTimeoutMs = connectMs;
+        mFeed->SetConnectTimeout(connectMs);
+    }
+
+    void KrakenApi::SetRetryPolicy(int maxRetries, long baseBackoffMs) {
+        mMaxRetries = maxRetries;
+        mRetryBaseMs = baseBackoffMs;
+    }
+
+    void KrakenApi::SetHedging(bool enabled) {
+        mHedging = enabled;
+    }
+
+    void KrakenApi::SetRateLimits(int publicPerSecond, int privateCounter, double privateDecayPerSecond) {
+        mPublicBudget->SetLimits(publicPerSecond, publicPerSecond);
+        mPrivateBudget->SetLimits(privateCounter, privateDecayPerSecond);
+    }
+
+    double KrakenApi::GetPrivateHeadroom() {
+        return mPrivateBudget->GetHeadroom();
+    }
+
+    RiskGate& KrakenApi::GetRiskGate() {
+        return *mRisk;
+    }
+
+    void KrakenApi::SetRiskGate(std::shared_ptr<RiskGate> gate) {
+        // Lu sans verrou par le thread du flux et le chemin des ordres
+        mRisk = gate;
+    }
+
+    void KrakenApi::SetBalanceLedger(std::shared_ptr<FundsLedger> ledger) {
+        mLedger = ledger;
+    }
+
+    void KrakenApi::SetPositionTracker(std::shared_ptr<PositionTracker> positions) {
+        mPositions = positions;
+    }
+
+    std::shared_ptr<PositionTracker> KrakenApi::GetPositionTracker() const {
+        return mPositions;
+    }
+
+    // ===== MÉTRIQUES =====
+
+    // Compteurs d'un endpoint, partagés par toutes les instances
+    struct SEndpointMetrics {
+        Richy::CCounter requests;
+        Richy::CCounter errors;
+        Richy::CHistogram latency;
+
+        explicit SEndpointMetrics(const char* name) {
+            std::string label = std::string("{endpoint=\"") + name + "\"}";
+            requests = Richy::CMetrics::Counter("richy_requests_total" + label);
+            errors = Richy::CMetrics::Counter("richy_request_errors_total" + label);
+            latency = Richy::CMetrics::Histogram("richy_request_latency_us" + label);
+        }
+    };
+
+    // Un appel complet (retries et décodage compris) ; en échec tant que Succeed() n'est pas appelé
+    class CallScope {
+        public:
+            explicit CallScope(SEndpointMetrics& metrics) :
+                mMetrics(metrics),
+                mStart(std::chrono::steady_clock::now()),
+                mSucceeded(false) {
+                mMetrics.requests.Add();
+            }
+
+            ~CallScope() {
+                mMetrics.latency.Observe((uint64_t) std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - mStart
+                ).count());
+                if (!mSucceeded) {
+                    mMetrics.errors.Add();
+                }
+            }
+
+            void Succeed() {
+                mSucceeded = true;
+            }
+
+        private:
+            SEndpointMetrics& mMetrics;
+            std::chrono::steady_clock::time_point mStart;
+            bool mSucceeded;
+    };
+
+    struct STransportMetrics {
+        Richy::CCounter retries = Richy::CMetrics::Counter("richy_request_retries_total");
+        Richy::CCounter rateLimited = Richy::CMetrics::Counter("richy_rate_limited_total");
+        Richy::CGauge publicHeadroom = Richy::CMetrics::Gauge("richy_rate_headroom{scope=\"public\"}");
+        Richy::CGauge privateHeadroom = Richy::CMetrics::Gauge("richy_rate_headroom{scope=\"private\"}");
+    };
+
+    // Enregistrées au premier appel, jamais pendant l'initialisation statique
+    static STransportMetrics& TransportMetrics() {
+        static STransportMetrics metrics;
+        return metrics;
+    }
+
     // ===== MÉTHODES PRIVÉES =====
 
-    std::string KrakenApi::MakeRequest(const std::string& endpoint, const std::string& method, 
-                                     const std::map<std::string, std::string>& params, 
-                                     bool authenticated) {
-        CURL* curl;
-        CURLcode res;
-        std::string readBuffer;
+    template <EEndpoint E>
+    bool KrakenApi::Call(const std::map<std::string, std::string>& params, typename Endpoint<E>::Result& result) {
+        constexpr const EndpointInfo& endpoint = ENDPOINTS[E];
+        static SEndpointMetrics metrics(endpoint.name);
+        CallScope scope(metrics);
+        mLastError.clear();
+        
+        std::string response = MakeRequest(endpoint, params);
+        if (response.empty()) {
+            return false;
+        }
         
-        curl = curl_easy_init();
-        if (!curl) {
-            mLastError = "Failed to initialize CURL";
-            return "";
+        Json::Value root;
+        Json::Reader reader;
+        if (!reader.parse(response, root)) {
+            mLastError = std::string(endpoint.name) + " failed: invalid JSON response";
+            LOG_ERROR("{} failed: invalid JSON response ({} bytes)", endpoint.name, response.size());
+            return false;
+        }
+        if (!root["error"].empty()) {
+            mLastError = std::string(endpoint.name) + " failed: " + root["error"][0].asString();
+            LOG_ERROR("{} failed: {}", endpoint.name, root["error"][0].asString());
+            return false;
+        }
+        if (!Endpoint<E>::Decode(root["result"], result)) {
+            mLastError = std::string(endpoint.name) + " failed: unexpected response";
+            LOG_ERROR("{} failed: unexpected response", endpoint.name);
+            return false;
+        }
+        scope.Succeed();
+        return true;
+    }
+
+    // Encodage application/x-www-form-urlencoded des valeurs
+    static std::string Encode(const std::string& value) {
+        static const char* HEX = "0123456789ABCDEF";
+        std::string encoded;
+        encoded.reserve(value.size());
+        for (unsigned char c : value) {
+            if (isalnum(c) || c == '-' || c == '_' || c == '.' || c == '~' || c == ',') {
+                encoded.push_back((char) c);
+            } else {
+                encoded.push_back('%');
+                encoded.push_back(HEX[c >> 4]);
+                encoded.push_back(HEX[c & 0x0F]);
+            }
+        }
+        return encoded;
+    }
+
+    std::string KrakenApi::MakeRequest(const EndpointInfo& endpoint, 
+                                     const std::map<std::string, std::string>& params) {
+        // Transport en processus : ni HTTP, ni signature, ni budget de rate-limit
+        if (mTransport) {
+            std::string response = mTransport->Request(endpoint, params);
+            if (response.empty()) {
+                mLastError = "Transport failed for " + std::string(endpoint.path);
+            }
+            return response;
+        }
+        
+        // Les requêtes privées ne sont jamais fusionnées (nonce, effets de bord)
+        if (endpoint.authenticated) {
+            return PerformRequest(endpoint, params);
+        }
+        
+        std::string key = endpoint.path;
+        for (const auto& param : params) {
+            key += "&" + param.first + "=" + param.second;
         }
         
-        std::string url = mBaseUrl + endpoint;
+        // Erreur du meneur recopiée dans chaque appelant qui partage la réponse
+        FlightResult result = mSingleFlight->Do(key, [&]() {
+            FlightResult flight;
+            flight.body = PerformRequest(endpoint, params);
+            flight.error = mLastError;
+            return flight;
+        });
+        mLastError = result.error;
+        return result.body;
+    }
+
+    std::string KrakenApi::PerformRequest(const EndpointInfo& endpoint, 
+                                        const std::map<std::string, std::string>& params) {
+        const bool authenticated = endpoint.authenticated;
+        const bool post = endpoint.post;
+        std::string url = mBaseUrl + endpoint.path;
         std::string postData = "";
         
-        // Construction des paramètres POST
+        // Construction des paramètres (corps POST ou query string GET)
         if (!params.empty()) {
             for (auto it = params.begin(); it != params.end(); ++it) {
                 if (it != params.begin()) postData += "&";
-                postData += it->first + "=" + it->second;
+                postData += it->first + "=" + Encode(it->second);
             }
         }
+        if (!post && !postData.empty()) {
+            url += "?" + postData;
+        }
+        LatencyProbe::Mark(eStageBuild);
         
         // Headers
         struct curl_slist* headers = NULL;
@@ -91,45 +409,247 @@ namespace API {
             std::string nonce = GenerateNonce();
             postData = "nonce=" + nonce + (postData.empty() ? "" : "&" + postData);
             
-            std::string signature = GenerateSignature(endpoint, nonce, postData);
+            std::string signature = GenerateSignature(endpoint.path, nonce, postData);
             std::string apiKeyHeader = "API-Key: " + mApiKey;
             std::string signHeader = "API-Sign: " + signature;
             
             headers = curl_slist_append(headers, apiKeyHeader.c_str());
             headers = curl_slist_append(headers, signHeader.c_str());
+            LatencyProbe::Mark(eStageSign);
+        }
+        
+        // Échéance : celle du thread appelant si elle existe, sinon le timeout par défaut
+        long budget = ScopedDeadline::Remaining();
+        if (budget < 0) {
+            budget = mRequestTimeoutMs;
+        }
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(budget);
+        
+        // Le coût de l'endpoint est prélevé une seule fois, retries compris
+        RateBudget& rateBudget = authenticated ? *mPrivateBudget : *mPublicBudget;
+        bool acquired = rateBudget.Acquire(endpoint.cost, budget);
+        STransportMetrics& metrics = TransportMetrics();
+        (authenticated ? metrics.privateHeadroom : metrics.publicHeadroom).Set((int64_t) rateBudget.GetHeadroom());
+        if (!acquired) {
+            metrics.rateLimited.Add();
+            mLastError = "Rate limit budget exhausted for " + std::string(endpoint.path);
+            LOG_WARNING("Rate limit budget exhausted for {}", endpoint.path);
+            curl_slist_free_all(headers);
+            return "";
+        }
+        
+        // Les requêtes privées ne sont jamais rejouées : un AddOrder répété peut être exécuté deux fois
+        int attempts = authenticated ? 1 : 1 + mMaxRetries;
+        std::string readBuffer;
+        
+        for (int attempt = 0; attempt < attempts; ++attempt) {
+            long left = (long) std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()
+            ).count();
+            if (left <= 0) {
+                mLastError = "Deadline exceeded for " + std::string(endpoint.path);
+                LOG_WARNING("Deadline exceeded for {} after {} attempt(s)", endpoint.path, attempt);
+                break;
+            }
+            
+            // Lecture publique lente : doublée sur une seconde connexion au-delà du p95
+            long hedgeDelayMs = (!authenticated && mHedging) ? mLatency->GetP95(endpoint.path) / 1000 : 0;
+            
+            long status = 0;
+            readBuffer.clear();
+            auto start = std::chrono::steady_clock::now();
+            CURLcode res = hedgeDelayMs > 0 && hedgeDelayMs < left ?
+                           ExecuteHedged(url, postData, post, headers, left, hedgeDelayMs, readBuffer, status) :
+                           Execute(url, postData, post, headers, left, readBuffer, status);
+            
+            if (res == CURLE_OK && status < 500 && status != 429) {
+                mLatency->Record(endpoint.path, (long) std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start
+                ).count());
+                curl_slist_free_all(headers);
+                return readBuffer;
+            }
+            
+            if (res != CURLE_OK) {
+                mLastError = "CURL error: " + std::string(curl_easy_strerror(res));
+                LOG_WARNING("{} attempt {}: CURL error {}", endpoint.path, attempt + 1, curl_easy_strerror(res));
+            } else {
+                mLastError = "HTTP error " + std::to_string(status) + " on " + endpoint.path;
+                LOG_WARNING("{} attempt {}: HTTP {}", endpoint.path, attempt + 1, status);
+            }
+            
+            if (!IsRetryable(res) || attempt + 1 >= attempts) {
+                break;
+            }
+            metrics.retries.Add();
+            
+            // Attente avec gigue, sans dépasser l'échéance
+            long wait = std::min(RetryBackoff(attempt, mRetryBaseMs, 1000), left);
+            std::this_thread::sleep_for(std::chrono::milliseconds(wait));
+        }
+        
+        curl_slist_free_all(headers);
+        return "";
+    }
+
+    bool KrakenApi::IsRetryable(CURLcode res) {
+        switch (res) {
+            case CURLE_OK: // HTTP 5xx ou 429
+            case CURLE_COULDNT_RESOLVE_HOST:
+            case CURLE_COULDNT_CONNECT:
+            case CURLE_OPERATION_TIMEDOUT:
+            case CURLE_SSL_CONNECT_ERROR:
+            case CURLE_SEND_ERROR:
+            case CURLE_RECV_ERROR:
+            case CURLE_GOT_NOTHING:
+            case CURLE_PARTIAL_FILE:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    CURL* KrakenApi::CreateHandle(const std::string& url, const std::string& postData, bool post, 
+                                  struct curl_slist* headers, long timeoutMs, std::string* buffer) {
+        CURL* curl = curl_easy_init();
+        if (!curl) {
+            return NULL;
         }
         
         // Configuration CURL
         curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
         curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readBuffer);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, buffer);
         curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-        curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
+        curl_easy_setopt(curl, CURLOPT_TIMEOUT_MS, timeoutMs);
+        curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT_MS, std::min(timeoutMs, mConnectTimeoutMs.load()));
+        curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+        curl_easy_setopt(curl, CURLOPT_SOCKOPTFUNCTION, SockOptCallback);
+        curl_easy_setopt(curl, CURLOPT_SOCKOPTDATA, &mBusyPollUs);
+        mConnections->Attach(curl);
+        if (LatencyProbe::IsEnabled()) {
+            // Le rappel de trace signale l'écriture de la requête dans la socket
+            curl_easy_setopt(curl, CURLOPT_DEBUGFUNCTION, DebugCallback);
+            curl_easy_setopt(curl, CURLOPT_VERBOSE, 1L);
+        }
+        
+        if (post) {
+            curl_easy_setopt(curl, CURLOPT_COPYPOSTFIELDS, postData.c_str());
+        }
         
-        if (method == "POST" || authenticated) {
-            curl_easy_setopt(curl, CURLOPT_POSTFIELDS, postData.c_str());
+        return curl;
+    }
+
+    CURLcode KrakenApi::Execute(const std::string& url, const std::string& postData, bool post, 
+                                struct curl_slist* headers, long timeoutMs, 
+                                std::string& response, long& status) {
+        CURL* curl = CreateHandle(url, postData, post, headers, timeoutMs, &response);
+        if (!curl) {
+            return CURLE_FAILED_INIT;
         }
         
         // Exécution
-        res = curl_easy_perform(curl);
+        CURLcode res = curl_easy_perform(curl);
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
         
         // Nettoyage
-        curl_slist_free_all(headers);
         curl_easy_cleanup(curl);
+        return res;
+    }
+
+    CURLcode KrakenApi::ExecuteHedged(const std::string& url, const std::string& postData, bool post, 
+                                      struct curl_slist* headers, long timeoutMs, long hedgeDelayMs, 
+                                      std::string& response, long& status) {
+        CURLM* multi = curl_multi_init();
+        if (!multi) {
+            return Execute(url, postData, post, headers, timeoutMs, response, status);
+        }
         
-        if (res != CURLE_OK) {
-            mLastError = "CURL error: " + std::string(curl_easy_strerror(res));
-            return "";
+        std::string buffers[2];
+        CURL* handles[2] = {CreateHandle(url, postData, post, headers, timeoutMs, &buffers[0]), NULL};
+        CURLcode results[2] = {CURLE_OPERATION_TIMEDOUT, CURLE_OPERATION_TIMEDOUT};
+        bool done[2] = {false, false};
+        if (!handles[0]) {
+            curl_multi_cleanup(multi);
+            return CURLE_FAILED_INIT;
+        }
+        curl_multi_add_handle(multi, handles[0]);
+        
+        auto start = std::chrono::steady_clock::now();
+        int winner = -1;
+        int launched = 1;
+        
+        while (winner < 0) {
+            int running = 0;
+            curl_multi_perform(multi, &running);
+            
+            CURLMsg* message;
+            int pending;
+            while ((message = curl_multi_info_read(multi, &pending))) {
+                if (message->msg != CURLMSG_DONE) {
+                    continue;
+                }
+                int index = (message->easy_handle == handles[0]) ? 0 : 1;
+                done[index] = true;
+                results[index] = message->data.result;
+                if (results[index] == CURLE_OK && winner < 0) {
+                    winner = index;
+                }
+            }
+            if (winner >= 0) {
+                break;
+            }
+            
+            // Toutes les requêtes lancées ont échoué : on rend la dernière erreur
+            if (done[0] && (launched == 1 || done[1])) {
+                winner = launched - 1;
+                break;
+            }
+            
+            long elapsed = (long) std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start
+            ).count();
+            
+            if (launched == 1 && !done[0] && elapsed >= hedgeDelayMs) {
+                // La première requête dépasse le p95 : doublon sur une nouvelle connexion
+                handles[1] = CreateHandle(url, postData, post, headers, std::max(1L, timeoutMs - elapsed), &buffers[1]);
+                if (handles[1]) {
+                    curl_easy_setopt(handles[1], CURLOPT_FRESH_CONNECT, 1L);
+                    curl_multi_add_handle(multi, handles[1]);
+                    launched = 2;
+                }
+                continue;
+            }
+            
+            int wait = launched == 1 ? (int) std::max(1L, std::min(10L, hedgeDelayMs - elapsed)) : 10;
+            curl_multi_poll(multi, NULL, 0, wait, NULL);
         }
         
-        return readBuffer;
+        response = buffers[winner];
+        curl_easy_getinfo(handles[winner], CURLINFO_RESPONSE_CODE, &status);
+        CURLcode res = results[winner];
+        
+        // Nettoyage (la requête perdante est abandonnée)
+        for (int i = 0; i < launched; ++i) {
+            curl_multi_remove_handle(multi, handles[i]);
+            curl_easy_cleanup(handles[i]);
+        }
+        curl_multi_cleanup(multi);
+        return res;
     }
 
     std::string KrakenApi::GenerateNonce() {
-        auto now = std::chrono::duration_cast<std::chrono::microseconds>(
+        long long now = std::chrono::duration_cast<std::chrono::microseconds>(
             std::chrono::system_clock::now().time_since_epoch()
         ).count();
-        return std::to_string(now);
+
+        // Strictement croissant, même pour deux appels concurrents dans la même microseconde
+        long long last = mLastNonce.load();
+        long long nonce;
+        do {
+            nonce = std::max(now, last + 1);
+        } while (!mLastNonce.compare_exchange_weak(last, nonce));
+        return std::to_string(nonce);
     }
 
     std::string KrakenApi::GenerateSignature(const std::string& path, const std::string& nonce, 
@@ -186,79 +706,125 @@ namespace API {
 
     std::vector<std::string> KrakenApi::GetTradingPairs() {
         std::vector<std::string> pairs;
-        std::string response = MakeRequest("/0/public/AssetPairs");
-        
-        if (response.empty()) {
-            return pairs;
+        for (const auto& pair : GetPairInfo()) {
+            pairs.push_back(pair.first);
         }
-        
-        Json::Value root;
-        Json::Reader reader;
-        
-        if (reader.parse(response, root)) {
-            if (root["error"].empty() && root["result"].isObject()) {
-                for (const auto& member : root["result"].getMemberNames()) {
-                    pairs.push_back(member);
-                }
-            }
-        }
-        
         return pairs;
     }
 
     std::map<std::string, std::string> KrakenApi::GetAssetInfo() {
-        std::map<std::string, std::string> assets;
-        std::string response = MakeRequest("/0/public/Assets");
-        
-        if (response.empty()) {
-            return assets;
+        std::shared_ptr<const RefData> data = GetReferenceData();
+        return data ? data->assets : std::map<std::string, std::string>();
+    }
+
+    std::map<std::string, PairInfo> KrakenApi::GetPairInfo() {
+        std::shared_ptr<const RefData> data = GetReferenceData();
+        return data ? data->pairs : std::map<std::string, PairInfo>();
+    }
+
+    std::shared_ptr<const RefData> KrakenApi::GetReferenceData() {
+        // Servi par le cache de référence ; sans cache chargé, téléchargé une fois et publié
+        std::shared_ptr<const RefData> data = mRefData->Get();
+        if (!data && mRefData->Refresh([this](RefData& downloaded) { return DownloadReferenceData(downloaded); })) {
+            data = mRefData->Get();
+        }
+        return data;
+    }
+
+    void KrakenApi::RebuildFees() {
+        // Sous verrou de bout en bout : la dernière reconstruction voit le dernier instantané
+        std::lock_guard<std::mutex> lock(mFeesMutex);
+        std::shared_ptr<FeeEngine> fees = std::make_shared<FeeEngine>();
+        std::shared_ptr<const RefData> data = mRefData->Get();
+        if (data) {
+            fees->Load(data->pairs);
         }
+        fees->SetVolume(mTradeVolume);
+        mFees.store(fees, std::memory_order_release);
+    }
+
+    std::shared_ptr<const PairInfo> KrakenApi::FindPairInfo(const std::string& pair) const {
+        // Pointeur dans l'instantané, qu'il garde en vie
+        std::shared_ptr<const RefData> data = mRefData->Get();
+        const PairInfo* info = data ? data->Find(pair) : nullptr;
+        return info ? std::shared_ptr<const PairInfo>(data, info) : nullptr;
+    }
+
+    bool KrakenApi::DownloadReferenceData(RefData& data) {
+        // Le palier de frais est relu avec les barèmes (appliqué à la publication)
+        if (!mApiKey.empty() && !mApiSecret.empty()) {
+            double volume = 0.0;
+            if (Call<eTradeVolume>({}, volume)) {
+                mTradeVolume = volume;
+            }
+        }
+        data.assets = DownloadAssetInfo();
+        data.pairs = DownloadPairInfo();
+        return !data.assets.empty() && !data.pairs.empty();
+    }
+
+    bool KrakenApi::LoadReferenceCache(const std::string& path, long maxAgeSeconds) {
+        mRefData->SetPath(path);
         
-        Json::Value root;
-        Json::Reader reader;
+        RefDataCache::Loader loader = [this](RefData& data) {
+            return DownloadReferenceData(data);
+        };
         
-        if (reader.parse(response, root)) {
-            if (root["error"].empty() && root["result"].isObject()) {
-                for (const auto& member : root["result"].getMemberNames()) {
-                    assets[member] = root["result"][member]["altname"].asString();
-                }
-            }
+        // Pas de cache valide : téléchargement synchrone, on ne peut pas trader sans
+        if (!mRefData->Load() && !mRefData->Refresh(loader)) {
+            return false;
         }
         
+        // Puis rafraîchi en tâche de fond à chaque péremption (tout de suite s'il est déjà ancien)
+        mRefData->StartRefresh(loader, maxAgeSeconds);
+        return true;
+    }
+
+    std::map<std::string, std::string> KrakenApi::DownloadAssetInfo() {
+        std::map<std::string, std::string> assets;
+        Call<eAssets>({}, assets);
         return assets;
     }
 
+    std::map<std::string, PairInfo> KrakenApi::DownloadPairInfo() {
+        std::map<std::string, PairInfo> pairs;
+        Call<eAssetPairs>({}, pairs);
+        return pairs;
+    }
+
+    // Réponses indexées par le nom Kraken (XXBTZUSD) : nom demandé, nom canonique ou réponse unique
+    template <typename T>
+    static const T* FindPair(const std::map<std::string, T>& results, const std::string& pair, 
+                             const std::string& canonical) {
+        auto it = results.find(pair);
+        if (it == results.end()) {
+            it = results.find(canonical);
+        }
+        if (it == results.end() && results.size() == 1) {
+            it = results.begin();
+        }
+        return it != results.end() ? &it->second : NULL;
+    }
+
     TickerData KrakenApi::GetTicker(const std::string& pair) {
-        TickerData ticker;
-        ticker.pair = pair;
-        
-        std::map<std::string, std::string> params;
-        params["pair"] = pair;
-        
-        std::string response = MakeRequest("/0/public/Ticker", "GET", params);
-        
-        if (response.empty()) {
+        // Regroupement avec les autres paires demandées dans la même fenêtre
+        if (mTickerBatcher->GetWindow() > 0) {
+            std::string error;
+            TickerData ticker = mTickerBatcher->Get(pair, error);
+            mLastError = error;
             return ticker;
         }
         
-        Json::Value root;
-        Json::Reader reader;
+        TickerData ticker = {};
+        ticker.pair = pair;
         
-        if (reader.parse(response, root)) {
-            if (root["error"].empty() && root["result"].isObject()) {
-                auto pairData = root["result"][pair];
-                if (!pairData.isNull()) {
-                    ticker.ask = std::stod(pairData["a"][0].asString());
-                    ticker.bid = std::stod(pairData["b"][0].asString());
-                    ticker.last = std::stod(pairData["c"][0].asString());
-                    ticker.volume = std::stod(pairData["v"][1].asString());
-                    ticker.high = std::stod(pairData["h"][1].asString());
-                    ticker.low = std::stod(pairData["l"][1].asString());
-                    ticker.open = std::stod(pairData["o"].asString());
-                    ticker.timestamp = std::chrono::duration_cast<std::chrono::seconds>(
-                        std::chrono::system_clock::now().time_since_epoch()
-                    ).count();
-                }
+        Endpoint<eTicker>::Result tickers;
+        if (Call<eTicker>({{"pair", pair}}, tickers)) {
+            const TickerData* found = FindPair(tickers, pair, CanonicalPair(pair));
+            if (found) {
+                ticker = *found;
+                ticker.pair = pair;
+                mRisk->OnTicker(ticker);
             }
         }
         
@@ -274,38 +840,18 @@ namespace API {
             pairList += pairs[i];
         }
         
-        std::map<std::string, std::string> params;
-        params["pair"] = pairList;
-        
-        std::string response = MakeRequest("/0/public/Ticker", "GET", params);
-        
-        if (response.empty()) {
+        Endpoint<eTicker>::Result results;
+        if (!Call<eTicker>({{"pair", pairList}}, results)) {
             return tickers;
         }
         
-        Json::Value root;
-        Json::Reader reader;
-        
-        if (reader.parse(response, root)) {
-            if (root["error"].empty() && root["result"].isObject()) {
-                for (const auto& pair : pairs) {
-                    auto pairData = root["result"][pair];
-                    if (!pairData.isNull()) {
-                        TickerData ticker;
-                        ticker.pair = pair;
-                        ticker.ask = std::stod(pairData["a"][0].asString());
-                        ticker.bid = std::stod(pairData["b"][0].asString());
-                        ticker.last = std::stod(pairData["c"][0].asString());
-                        ticker.volume = std::stod(pairData["v"][1].asString());
-                        ticker.high = std::stod(pairData["h"][1].asString());
-                        ticker.low = std::stod(pairData["l"][1].asString());
-                        ticker.open = std::stod(pairData["o"].asString());
-                        ticker.timestamp = std::chrono::duration_cast<std::chrono::seconds>(
-                            std::chrono::system_clock::now().time_since_epoch()
-                        ).count();
-                        tickers.push_back(ticker);
-                    }
-                }
+        for (const auto& pair : pairs) {
+            const TickerData* found = FindPair(results, pair, CanonicalPair(pair));
+            if (found) {
+                TickerData ticker = *found;
+                ticker.pair = pair;
+                mRisk->OnTicker(ticker);
+                tickers.push_back(ticker);
             }
         }
         
@@ -314,42 +860,14 @@ namespace API {
 
     OrderBook KrakenApi::GetOrderBook(const std::string& pair, int depth) {
         OrderBook orderBook;
-        
-        std::map<std::string, std::string> params;
-        params["pair"] = pair;
-        params["count"] = std::to_string(depth);
-        
-        std::string response = MakeRequest("/0/public/Depth", "GET", params);
-        
-        if (response.empty()) {
-            return orderBook;
-        }
-        
-        Json::Value root;
-        Json::Reader reader;
-        
-        if (reader.parse(response, root)) {
-            if (root["error"].empty() && root["result"].isObject()) {
-                auto pairData = root["result"][pair];
-                if (!pairData.isNull()) {
-                    // Asks (vendeurs)
-                    for (const auto& ask : pairData["asks"]) {
-                        OrderBookEntry entry;
-                        entry.price = std::stod(ask[0].asString());
-                        entry.volume = std::stod(ask[1].asString());
-                        entry.timestamp = ask[2].asInt64();
-                        orderBook.asks.push_back(entry);
-                    }
-                    
-                    // Bids (acheteurs)
-                    for (const auto& bid : pairData["bids"]) {
-                        OrderBookEntry entry;
-                        entry.price = std::stod(bid[0].asString());
-                        entry.volume = std::stod(bid[1].asString());
-                        entry.timestamp = bid[2].asInt64();
-                        orderBook.bids.push_back(entry);
-                    }
-                }
+        orderBook.pair = pair;
+        
+        Endpoint<eDepth>::Result books;
+        if (Call<eDepth>({{"pair", pair}, {"count", std::to_string(depth)}}, books)) {
+            const OrderBook* found = FindPair(books, pair, CanonicalPair(pair));
+            if (found) {
+                orderBook = *found;
+                orderBook.pair = pair;
             }
         }
         
@@ -357,181 +875,161 @@ namespace API {
     }
 
     std::vector<Balance> KrakenApi::GetAccountBalance() {
+        // BalanceEx expose la part bloquée par les ordres ouverts (hold_trade)
         std::vector<Balance> balances;
-        
-        std::string response = MakeRequest("/0/private/Balance", "POST", {}, true);
-        
-        if (response.empty()) {
-            return balances;
-        }
-        
-        Json::Value root;
-        Json::Reader reader;
-        
-        if (reader.parse(response, root)) {
-            if (root["error"].empty() && root["result"].isObject()) {
-                for (const auto& member : root["result"].getMemberNames()) {
-                    Balance balance;
-                    balance.currency = member;
-                    balance.total = std::stod(root["result"][member].asString());
-                    balance.available = balance.total; // Kraken ne distingue pas available/locked dans Balance
-                    balance.locked = 0.0;
-                    balances.push_back(balance);
-                }
-            }
-        }
-        
+        Call<eBalanceEx>({}, balances);
         return balances;
     }
 
     std::string KrakenApi::PlaceMarketOrder(const std::string& pair, const std::string& type, double volume) {
-        std::map<std::string, std::string> params;
-        params["pair"] = pair;
-        params["type"] = type;
-        params["ordertype"] = "market";
-        params["volume"] = std::to_string(volume);
-        
-        std::string response = MakeRequest("/0/private/AddOrder", "POST", params, true);
-        
-        if (response.empty()) {
-            return "";
-        }
-        
-        Json::Value root;
-        Json::Reader reader;
-        
-        if (reader.parse(response, root)) {
-            if (root["error"].empty() && root["result"].isObject()) {
-                if (root["result"]["txid"].isArray() && root["result"]["txid"].size() > 0) {
-                    return root["result"]["txid"][0].asString();
-                }
-            } else {
-                mLastError = "Order failed: " + root["error"][0].asString();
-            }
-        }
-        
-        return "";
+        return PlaceOrder(pair, type, "market", volume);
     }
 
     std::string KrakenApi::PlaceLimitOrder(const std::string& pair, const std::string& type, 
                                          double volume, double price) {
-        std::map<std::string, std::string> params;
-        params["pair"] = pair;
-        params["type"] = type;
-        params["ordertype"] = "limit";
-        params["volume"] = std::to_string(volume);
-        params["price"] = std::to_string(price);
-        
-        std::string response = MakeRequest("/0/private/AddOrder", "POST", params, true);
-        
-        if (response.empty()) {
-            return "";
-        }
-        
-        Json::Value root;
-        Json::Reader reader;
-        
-        if (reader.parse(response, root)) {
-            if (root["error"].empty() && root["result"].isObject()) {
-                if (root["result"]["txid"].isArray() && root["result"]["txid"].size() > 0) {
-                    return root["result"]["txid"][0].asString();
-                }
-            } else {
-                mLastError = "Order failed: " + root["error"][0].asString();
-            }
-        }
-        
-        return "";
+        return PlaceOrder(pair, type, "limit", volume, price);
     }
 
     bool KrakenApi::CancelOrder(const std::string& orderId) {
-        std::map<std::string, std::string> params;
-        params["txid"] = orderId;
-        
-        std::string response = MakeRequest("/0/private/CancelOrder", "POST", params, true);
-        
-        if (response.empty()) {
+        int count = 0;
+        if (!Call<eCancelOrder>({{"txid", orderId}}, count)) {
             return false;
         }
-        
-        Json::Value root;
-        Json::Reader reader;
-        
-        if (reader.parse(response, root)) {
-            if (root["error"].empty()) {
-                return true;
-            } else {
-                mLastError = "Cancel failed: " + root["error"][0].asString();
-            }
+        LOG_INFO("Order {} canceled", orderId);
+        // État final : les exécutions d'avant l'annulation comptent dans la position
+        if (!QueryOrders({orderId})) {
+            CloseOrder(orderId);
         }
-        
-        return false;
+        return true;
     }
 
     std::vector<Order> KrakenApi::GetOpenOrders(const std::string& pair) {
         std::vector<Order> orders;
-        
-        std::map<std::string, std::string> params;
-        if (!pair.empty()) {
-            params["pair"] = pair;
+        if (!Call<eOpenOrders>({}, orders)) {
+            return orders;
         }
-        
-        std::string response = MakeRequest("/0/private/OpenOrders", "POST", params, true);
-        
-        if (response.empty()) {
+        ObserveOrders(orders);
+        if (pair.empty()) {
             return orders;
         }
         
-        Json::Value root;
-        Json::Reader reader;
-        
-        if (reader.parse(response, root)) {
-            if (root["error"].empty() && root["result"].isObject()) {
-                auto openOrders = root["result"]["open"];
-                for (const auto& member : openOrders.getMemberNames()) {
-                    Order order;
-                    order.orderId = member;
-                    auto orderData = openOrders[member];
-                    order.pair = orderData["descr"]["pair"].asString();
-                    order.type = orderData["descr"]["type"].asString();
-                    order.orderType = orderData["descr"]["ordertype"].asString();
-                    order.volume = std::stod(orderData["vol"].asString());
-                    order.price = std::stod(orderData["descr"]["price"].asString());
-                    order.filled = std::stod(orderData["vol_exec"].asString());
-                    order.status = orderData["status"].asString();
-                    order.timestamp = orderData["opentm"].asInt64();
-                    orders.push_back(order);
+        // OpenOrders ne filtre pas par paire
+        orders.erase(std::remove_if(orders.begin(), orders.end(), [this, &pair](const Order& order) {
+            return !SamePair(order.pair, pair);
+        }), orders.end());
+        return orders;
+    }
+
+    std::vector<Position> KrakenApi::GetOpenPositions() {
+        std::vector<Position> positions;
+        Call<eOpenPositions>({{"docalcs", "true"}}, positions);
+        return positions;
+    }
+
+    bool KrakenApi::SyncPositions(const std::vector<std::string>& pairs) {
+        std::vector<Position> positions;
+        if (!Call<eOpenPositions>({{"docalcs", "true"}}, positions)) {
+            return false;
+        }
+        std::vector<Position> matched;
+        for (const auto& pair : pairs) {
+            double net = 0.0;
+            for (const auto& position : positions) {
+                if (SamePair(position.pair, pair)) {
+                    net += position.type == "short" ? -position.volume : position.volume;
+                    matched.push_back(position);
+                    matched.back().pair = pair;
                 }
             }
+            mRisk->SetPosition(pair, net);
         }
-        
-        return orders;
+        if (mPositions) {
+            mPositions->Load(matched);
+        }
+        return true;
     }
 
-    // ===== MÉTHODES UTILITAIRES =====
+    // ===== SUIVI DES ORDRES =====
 
-    bool KrakenApi::ValidatePair(const std::string& pair) {
-        auto pairs = GetTradingPairs();
-        return std::find(pairs.begin(), pairs.end(), pair) != pairs.end();
+    void KrakenApi::ObserveOrders(const std::vector<Order>& orders) {
+        for (const auto& order : orders) {
+            OrderFill fill = mRisk->OnOrder(order);
+            if (mPositions && fill.volume > 0.0) {
+                mPositions->OnFill(fill.pair, fill.type, fill.volume, fill.price, fill.fee);
+            }
+            if (mLedger) {
+                std::shared_ptr<const PairInfo> info = FindPairInfo(order.pair);
+                if (info) {
+                    mLedger->OnOrder(order, info->base, info->quote);
+                }
+            }
+        }
     }
 
-    std::string KrakenApi::GetServerTime() {
-        std::string response = MakeRequest("/0/public/Time");
-        
-        if (response.empty()) {
-            return "";
+    void KrakenApi::CloseOrder(const std::string& orderId) {
+        mRisk->Close(orderId);
+        if (mLedger) {
+            mLedger->Release(orderId);
         }
-        
-        Json::Value root;
-        Json::Reader reader;
-        
-        if (reader.parse(response, root)) {
-            if (root["error"].empty() && root["result"].isObject()) {
-                return root["result"]["rfc1123"].asString();
+    }
+
+    bool KrakenApi::QueryOrders(const std::vector<std::string>& orderIds) {
+        // QueryOrders accepte 50 txid par appel
+        static const size_t BATCH = 50;
+        bool success = true;
+        for (size_t first = 0; first < orderIds.size(); first += BATCH) {
+            std::string txids;
+            for (size_t i = first; i < std::min(first + BATCH, orderIds.size()); ++i) {
+                txids += (txids.empty() ? "" : ",") + orderIds[i];
+            }
+            std::vector<Order> orders;
+            if (Call<eQueryOrders>({{"txid", txids}}, orders)) {
+                ObserveOrders(orders);
+            } else {
+                success = false;
             }
         }
-        
-        return "";
+        return success;
+    }
+
+    bool KrakenApi::RefreshOrders() {
+        // Uniquement les ordres de cette clé : les autres clés du contrôle partagé ne les voient pas
+        return QueryOrders(mRisk->GetTrackedOrders(this));
+    }
+
+    // ===== MÉTHODES UTILITAIRES =====
+
+    std::string KrakenApi::CanonicalPair(const std::string& pair) const {
+        // Uniquement depuis le cache de référence : jamais de requête ici
+        std::shared_ptr<const PairInfo> info = FindPairInfo(pair);
+        return info ? info->name : pair;
+    }
+
+    bool KrakenApi::SamePair(const std::string& pair, const std::string& other) const {
+        return pair == other || CanonicalPair(pair) == CanonicalPair(other);
+    }
+
+    std::string KrakenApi::FormatNumber(double value) {
+        // 8 décimales au plus, sans zéros de fin (Kraken refuse les décimales en trop)
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "%.8f", value);
+        std::string text(buffer);
+        text.erase(text.find_last_not_of('0') + 1);
+        if (!text.empty() && text.back() == '.') {
+            text.pop_back();
+        }
+        return text;
+    }
+
+    bool KrakenApi::ValidatePair(const std::string& pair) {
+        GetReferenceData();
+        return FindPairInfo(pair) != nullptr;
+    }
+
+    std::string KrakenApi::GetServerTime() {
+        std::string serverTime;
+        Call<eTime>({}, serverTime);
+        return serverTime;
     }
 
     bool KrakenApi::TestConnection() {
@@ -545,24 +1043,168 @@ namespace API {
             return false;
         }
         
-        std::string response = MakeRequest("/0/private/Balance", "POST", {}, true);
+        Endpoint<eBalance>::Result balances;
+        return Call<eBalance>({}, balances);
+    }
+
+    bool KrakenApi::Warmup(int connections, long timeoutMs, WarmupReport& report) {
+        mLastError.clear();
+        report = WarmupReport();
+        bool ok = true;
+        
+        // Avec un transport en processus, ni DNS ni connexion à préparer
+        if (!mTransport) {
+            // Hôte et port de l'URL de base
+            std::string host = mBaseUrl;
+            int port = 443;
+            size_t scheme = host.find("://");
+            if (scheme != std::string::npos) {
+                port = host.compare(0, scheme, "http") == 0 ? 80 : 443;
+                host = host.substr(scheme + 3);
+            }
+            host = host.substr(0, host.find('/'));
+            size_t colon = host.rfind(':');
+            if (colon != std::string::npos) {
+                port = atoi(host.c_str() + colon + 1);
+                host.resize(colon);
+            }
+            
+            auto start = std::chrono::steady_clock::now();
+            report.pinned = mConnections->Pin(host, port);
+            report.resolveUs = (long) std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start
+            ).count();
+            if (report.pinned.empty()) {
+                mLastError = "Cannot resolve " + host;
+                LOG_WARNING("Warm-up: cannot resolve {}", host);
+                ok = false;
+            }
+            
+            if (ok && connections > 0) {
+                start = std::chrono::steady_clock::now();
+                report.connections = OpenConnections(connections, timeoutMs);
+                report.connectUs = (long) std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start
+                ).count();
+                if (report.connections < connections) {
+                    mLastError = "Warm-up opened " + std::to_string(report.connections) + " of " +
+                                 std::to_string(connections) + " connections to " + host;
+                    LOG_WARNING("Warm-up: {} of {} connections opened to {}", report.connections, connections, host);
+                    ok = false;
+                }
+            }
+        }
+        
+        auto start = std::chrono::steady_clock::now();
+        WarmCodePaths();
+        report.codeUs = (long) std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start
+        ).count();
         
-        if (response.empty()) {
-            return false;
+        LOG_INFO("Warm-up: resolve {} us ({}), {} connection(s) in {} us, code paths {} us",
+                 report.resolveUs, report.pinned, report.connections, report.connectUs, report.codeUs);
+        return ok;
+    }
+    
+    int KrakenApi::OpenConnections(int count, long timeoutMs) {
+        CURLM* multi = curl_multi_init();
+        if (!multi) {
+            return 0;
         }
         
-        Json::Value root;
-        Json::Reader reader;
+        // Requêtes publiques simultanées : une connexion chacune, gardée ensuite par le partage
+        std::string url = mBaseUrl + ENDPOINTS[eTime].path;
+        std::vector<std::string> buffers((size_t) count);
+        std::vector<CURL*> handles;
+        for (int i = 0; i < count; ++i) {
+            if (!mPublicBudget->Acquire(ENDPOINTS[eTime].cost, timeoutMs)) {
+                break;
+            }
+            CURL* curl = CreateHandle(url, "", false, NULL, timeoutMs, &buffers[i]);
+            if (!curl) {
+                break;
+            }
+            curl_multi_add_handle(multi, curl);
+            handles.push_back(curl);
+        }
         
-        if (reader.parse(response, root)) {
-            if (root["error"].empty()) {
-                return true;
-            } else {
-                mLastError = "Authentication failed: " + root["error"][0].asString();
+        // Chaque handle est borné par son timeout
+        int running = (int) handles.size();
+        while (running > 0) {
+            curl_multi_perform(multi, &running);
+            if (running > 0) {
+                curl_multi_poll(multi, NULL, 0, 100, NULL);
+            }
+        }
+        
+        int opened = 0;
+        CURLMsg* message;
+        int pending;
+        while ((message = curl_multi_info_read(multi, &pending))) {
+            if (message->msg == CURLMSG_DONE && message->data.result == CURLE_OK) {
+                opened++;
             }
         }
         
-        return false;
+        for (CURL* curl : handles) {
+            curl_multi_remove_handle(multi, curl);
+            curl_easy_cleanup(curl);
+        }
+        curl_multi_cleanup(multi);
+        return opened;
+    }
+    
+    // Réponses Kraken factices, au format des vraies
+    static const char* WARMUP_TICKER =
+        "{\"error\":[],\"result\":{\"XXBTZUSD\":{\"a\":[\"60000.1\",\"1\",\"1.000\"],\"b\":[\"60000.0\",\"2\",\"2.000\"],"
+        "\"c\":[\"60000.0\",\"0.01\"],\"v\":[\"100.0\",\"1000.0\"],\"p\":[\"60000.0\",\"60000.0\"],\"t\":[10,100],"
+        "\"l\":[\"59000.0\",\"59000.0\"],\"h\":[\"61000.0\",\"61000.0\"],\"o\":\"60000.0\"}}}";
+    static const char* WARMUP_DEPTH =
+        "{\"error\":[],\"result\":{\"XXBTZUSD\":{\"asks\":[[\"60000.1\",\"1.000\",1700000000]],"
+        "\"bids\":[[\"60000.0\",\"2.000\",1700000000]]}}}";
+    static const char* WARMUP_ADD_ORDER =
+        "{\"error\":[],\"result\":{\"descr\":{\"order\":\"buy 0.00100000 XBTUSD @ limit 60000.0\"},"
+        "\"txid\":[\"OAAAAA-AAAAA-AAAAAA\"]}}";
+    static const char* WARMUP_CANCEL_ORDER = "{\"error\":[],\"result\":{\"count\":1}}";
+    static const char* WARMUP_ORDERS =
+        "{\"error\":[],\"result\":{\"OAAAAA-AAAAA-AAAAAA\":{\"status\":\"open\",\"opentm\":1700000000.0,"
+        "\"descr\":{\"pair\":\"XBTUSD\",\"type\":\"buy\",\"ordertype\":\"limit\",\"price\":\"60000.0\"},"
+        "\"vol\":\"0.00100000\",\"vol_exec\":\"0.00000000\",\"price\":\"0.0\"}}}";
+    static const char* WARMUP_BALANCE =
+        "{\"error\":[],\"result\":{\"ZUSD\":{\"balance\":\"1000.0\",\"hold_trade\":\"0.0\"}}}";
+    
+    template <EEndpoint E>
+    static bool DecodeSample(const char* response) {
+        Json::Value root;
+        Json::Reader reader;
+        typename Endpoint<E>::Result result;
+        return reader.parse(response, root) && root["error"].empty() && Endpoint<E>::Decode(root["result"], result);
+    }
+    
+    void KrakenApi::WarmCodePaths() {
+        // Corps d'un AddOrder tel que PerformRequest le construit ; signé seulement, jamais envoyé
+        std::map<std::string, std::string> params = {
+            {"ordertype", "limit"}, {"pair", "XBTUSD"}, {"price", FormatNumber(60000.0)},
+            {"type", "buy"}, {"volume", FormatNumber(0.001)}
+        };
+        std::string postData = "nonce=0";
+        for (const auto& param : params) {
+            postData += "&" + param.first + "=" + Encode(param.second);
+        }
+        if (!mApiSecret.empty()) {
+            GenerateSignature(ENDPOINTS[eAddOrder].path, "0", postData);
+        }
+        
+        // Décodeurs du chemin d'un ordre et de son suivi
+        bool decoded = DecodeSample<eTicker>(WARMUP_TICKER) &&
+                       DecodeSample<eDepth>(WARMUP_DEPTH) &&
+                       DecodeSample<eAddOrder>(WARMUP_ADD_ORDER) &&
+                       DecodeSample<eCancelOrder>(WARMUP_CANCEL_ORDER) &&
+                       DecodeSample<eQueryOrders>(WARMUP_ORDERS) &&
+                       DecodeSample<eBalanceEx>(WARMUP_BALANCE);
+        if (!decoded) {
+            LOG_WARNING("Warm-up: sample response not decoded");
+        }
     }
 
     std::string KrakenApi::GetLastError() const {
@@ -573,137 +1215,374 @@ namespace API {
         return !mLastError.empty();
     }
 
-    // ===== MÉTHODES WEBSOCKET (STUBS) =====
+    // ===== MÉTHODES WEBSOCKET =====
 
     bool KrakenApi::ConnectWebSocket() {
-        // TODO: Implémenter WebSocket
-        mLastError = "WebSocket not implemented yet";
-        return false;
+        mLastError.clear();
+        if (!mFeed->Start()) {
+            mLastError = "WebSocket connection failed: " + mFeed->GetLastError();
+            return false;
+        }
+        return true;
     }
 
     void KrakenApi::DisconnectWebSocket() {
-        // TODO: Implémenter WebSocket
+        mFeed->Stop();
+    }
+
+    bool KrakenApi::IsWebSocketConnected() const {
+        return mFeed->IsConnected();
+    }
+
+    void KrakenApi::SetWebSocketUrl(const std::string& url) {
+        mFeed->SetUrl(url);
+    }
+
+    void KrakenApi::SetHeartbeatTimeout(long milliseconds) {
+        mFeed->SetHeartbeatTimeout(milliseconds);
+    }
+
+    void KrakenApi::SetFeedThreadHook(std::function<void()> hook) {
+        mFeed->SetThreadHook(hook);
+    }
+
+    std::string KrakenApi::ToWsName(const std::string& pair) {
+        if (pair.find('/') != std::string::npos) {
+            return pair;
+        }
+
+        // Le flux WebSocket nomme les paires "XBT/USD"
+        GetReferenceData();
+        std::shared_ptr<const PairInfo> info = FindPairInfo(pair);
+        if (info && !info->wsname.empty()) {
+            return info->wsname;
+        }
+        return pair;
     }
 
     bool KrakenApi::SubscribeToTicker(const std::string& pair) {
-        // TODO: Implémenter WebSocket
-        mLastError = "WebSocket not implemented yet";
-        return false;
+        return mFeed->Subscribe("ticker", pair, ToWsName(pair));
     }
 
     void KrakenApi::SetTickerCallback(std::function<void(const TickerData&)> callback) {
         mTickerCallback = callback;
     }
 
-    // ===== MÉTHODES NON IMPLÉMENTÉES (STUBS) =====
+    // ===== HISTORIQUE, ORDRES ET FONDS =====
 
     std::vector<Trade> KrakenApi::GetRecentTrades(const std::string& pair, int count) {
-        // TODO: Implémenter
-        return std::vector<Trade>();
+        TradePage page;
+        if (Call<eRecentTrades>({{"pair", pair}, {"count", std::to_string(count)}}, page)) {
+            for (auto& trade : page.trades) {
+                trade.pair = pair;
+            }
+        }
+        return page.trades;
+    }
+
+    bool KrakenApi::GetTradesPage(const std::string& pair, const std::string& since, TradePage& page) {
+        std::map<std::string, std::string> params = {{"pair", pair}, {"count", "1000"}};
+        if (!since.empty()) {
+            params["since"] = since;
+        }
+        if (!Call<eRecentTrades>(params, page)) {
+            return false;
+        }
+        for (auto& trade : page.trades) {
+            trade.pair = pair;
+        }
+        return true;
+    }
+
+    // Paramètres de pagination communs aux historiques privés
+    static std::map<std::string, std::string> PageParams(long start, long end, int offset) {
+        std::map<std::string, std::string> params = {{"ofs", std::to_string(offset)}};
+        if (start > 0) {
+            params["start"] = std::to_string(start);
+        }
+        if (end > 0) {
+            params["end"] = std::to_string(end);
+        }
+        return params;
     }
 
     std::vector<std::vector<double>> KrakenApi::GetOHLC(const std::string& pair, int interval) {
-        // TODO: Implémenter
-        return std::vector<std::vector<double>>();
+        std::vector<std::vector<double>> candles;
+        Call<eOHLC>({{"pair", pair}, {"interval", std::to_string(interval)}}, candles);
+        return candles;
     }
 
     std::string KrakenApi::GetSystemStatus() {
-        // TODO: Implémenter
-        return "";
+        std::string status;
+        Call<eSystemStatus>({}, status);
+        return status;
     }
 
     std::map<std::string, double> KrakenApi::GetTradingBalance() {
-        // TODO: Implémenter
-        return std::map<std::string, double>();
+        std::map<std::string, double> tradeBalance;
+        Call<eTradeBalance>({}, tradeBalance);
+        return tradeBalance;
+    }
+
+    double KrakenApi::GetTradeVolume() {
+        // Volume 30 jours en USD, détermine le palier de frais
+        double volume = 0.0;
+        if (Call<eTradeVolume>({}, volume) && volume != mTradeVolume) {
+            mTradeVolume = volume;
+            RebuildFees();
+        }
+        return mTradeVolume;
     }
 
     std::string KrakenApi::PlaceOrder(const std::string& pair, const std::string& type, 
                                      const std::string& orderType, double volume, 
                                      double price, const std::map<std::string, std::string>& options) {
-        // TODO: Implémenter version générique
-        return "";
+        // Contrôle pré-trade en mémoire : un refus ne part jamais sur le réseau
+        ERiskCheck verdict = mRisk->Check(pair, type, volume, price);
+        if (verdict != eRiskAccepted) {
+            mLastError = std::string("Order rejected by risk gate: ") + RiskGate::ToString(verdict);
+            LOG_WARNING("Order {} {} {} {} @ {} rejected: {}", orderType, type, volume, pair, price,
+                        RiskGate::ToString(verdict));
+            return "";
+        }
+        
+        // Fonds réservés localement avant l'envoi : achat en cotation (frais taker compris), vente en base
+        std::string reservation;
+        if (mLedger && mLedger->GetLastSync() != 0) {
+            std::shared_ptr<const PairInfo> info = FindPairInfo(pair);
+            if (info) {
+                bool buy = !type.empty() && type[0] == 'b';
+                std::string currency = buy ? info->quote : info->base;
+                double amount = volume;
+                if (buy) {
+                    std::shared_ptr<const FeeEngine> fees = mFees.load(std::memory_order_acquire);
+                    // Ordre au marché : valorisé au prix qu'il traversera (0 sans référence : rien à réserver)
+                    double estimate = price > 0.0 ? price : mRisk->GetReferencePrice(pair, true);
+                    amount = volume * estimate * (1.0 + fees->GetTakerRate(fees->Find(info->name)));
+                }
+                reservation = "pending-" + std::to_string(mPendingOrders.fetch_add(1, std::memory_order_relaxed));
+                if (!mLedger->Reserve(reservation, currency, amount)) {
+                    mRisk->Release(pair, type, volume);
+                    mLastError = "Insufficient funds: " + FormatNumber(amount) + " " + currency + " needed, " +
+                                 FormatNumber(mLedger->GetAvailable(currency)) + " available";
+                    LOG_WARNING("Order {} {} {} {} @ {} rejected: insufficient {}", orderType, type, volume, pair,
+                                price, currency);
+                    return "";
+                }
+            }
+        }
+        
+        // Options Kraken (oflags, timeinforce, userref...) complétées par les champs obligatoires
+        std::map<std::string, std::string> params(options);
+        params["pair"] = pair;
+        params["type"] = type;
+        params["ordertype"] = orderType;
+        params["volume"] = FormatNumber(volume);
+        if (price > 0.0) {
+            params["price"] = FormatNumber(price);
+        }
+        
+        std::string txid;
+        if (Call<eAddOrder>(params, txid)) {
+            LOG_INFO("Order {} {} {} {} @ {} -> {}", orderType, type, params["volume"], pair, price, txid);
+            // Réservé jusqu'à exécution ou clôture
+            if (!reservation.empty()) {
+                mLedger->Rename(reservation, txid);
+            }
+            mRisk->Track(txid, pair, type, volume, this);
+        } else {
+            mRisk->Release(pair, type, volume);
+            if (!reservation.empty()) {
+                mLedger->Release(reservation);
+            }
+        }
+        return txid;
     }
 
     std::string KrakenApi::PlaceStopLossOrder(const std::string& pair, const std::string& type, 
                                              double volume, double stopPrice) {
-        // TODO: Implémenter
-        return "";
+        return PlaceOrder(pair, type, "stop-loss", volume, stopPrice);
     }
 
     bool KrakenApi::CancelAllOrders(const std::string& pair) {
-        // TODO: Implémenter
-        return false;
+        int count = 0;
+        std::vector<std::string> canceled;
+        bool success = true;
+        if (pair.empty()) {
+            if (!Call<eCancelAll>({}, count)) {
+                return false;
+            }
+            canceled = mRisk->GetTrackedOrders(this);
+        } else {
+            // CancelAll ne filtre pas par paire : annulation ordre par ordre
+            std::vector<Order> orders;
+            if (!Call<eOpenOrders>({}, orders)) {
+                return false;
+            }
+            for (const auto& order : orders) {
+                if (!SamePair(order.pair, pair)) {
+                    continue;
+                }
+                if (Call<eCancelOrder>({{"txid", order.orderId}}, count)) {
+                    canceled.push_back(order.orderId);
+                } else {
+                    success = false;
+                }
+            }
+        }
+        
+        // États finaux des ordres suivis ; à défaut, réservations libérées
+        if (!QueryOrders(canceled)) {
+            for (const auto& orderId : canceled) {
+                CloseOrder(orderId);
+            }
+        }
+        return success;
     }
 
     std::vector<Order> KrakenApi::GetClosedOrders(const std::string& pair, int count) {
-        // TODO: Implémenter
-        return std::vector<Order>();
+        // Plus récents en premier, page par page jusqu'à "count" ordres retenus
+        std::vector<Order> orders;
+        for (int offset = 0; count < 0 || orders.size() < (size_t) count;) {
+            OrderPage page;
+            if (!GetClosedOrdersPage(0, 0, offset, page) || page.orders.empty()) {
+                break;
+            }
+            offset += (int) page.orders.size();
+            for (auto& order : page.orders) {
+                if (pair.empty() || SamePair(order.pair, pair)) {
+                    orders.push_back(std::move(order));
+                }
+            }
+            if (offset >= page.count) {
+                break;
+            }
+        }
+        if (count >= 0 && orders.size() > (size_t) count) {
+            orders.resize(count);
+        }
+        return orders;
+    }
+
+    bool KrakenApi::GetClosedOrdersPage(long start, long end, int offset, OrderPage& page) {
+        // Fenêtre sur l'heure de clôture (Order::closed) : un ordre ouvert avant la
+        // dernière synchronisation et clos après tombe dans la fenêtre suivante
+        std::map<std::string, std::string> params = PageParams(start, end, offset);
+        params["closetime"] = "close";
+        if (!Call<eClosedOrders>(params, page)) {
+            return false;
+        }
+        ObserveOrders(page.orders);
+        return true;
     }
 
     Order KrakenApi::GetOrderInfo(const std::string& orderId) {
-        // TODO: Implémenter
-        return Order();
+        std::vector<Order> orders;
+        if (!Call<eQueryOrders>({{"txid", orderId}}, orders) || orders.empty()) {
+            return Order();
+        }
+        ObserveOrders(orders);
+        return orders[0];
     }
 
     std::vector<Trade> KrakenApi::GetTradeHistory(const std::string& pair, int count) {
-        // TODO: Implémenter
-        return std::vector<Trade>();
+        std::vector<Trade> trades;
+        for (int offset = 0; count < 0 || trades.size() < (size_t) count;) {
+            TradePage page;
+            if (!GetTradeHistoryPage(0, 0, offset, page) || page.trades.empty()) {
+                break;
+            }
+            offset += (int) page.trades.size();
+            for (auto& trade : page.trades) {
+                if (pair.empty() || SamePair(trade.pair, pair)) {
+                    trades.push_back(std::move(trade));
+                }
+            }
+            if (offset >= page.count) {
+                break;
+            }
+        }
+        if (count >= 0 && trades.size() > (size_t) count) {
+            trades.resize(count);
+        }
+        return trades;
     }
 
-    std::vector<Position> KrakenApi::GetOpenPositions() {
-        // TODO: Implémenter
-        return std::vector<Position>();
+    bool KrakenApi::GetTradeHistoryPage(long start, long end, int offset, TradePage& page) {
+        return Call<eTradesHistory>(PageParams(start, end, offset), page);
     }
 
     std::vector<std::string> KrakenApi::GetDepositMethods(const std::string& asset) {
-        // TODO: Implémenter
-        return std::vector<std::string>();
+        std::vector<std::string> methods;
+        Call<eDepositMethods>({{"asset", asset}}, methods);
+        return methods;
     }
 
     std::string KrakenApi::GetDepositAddress(const std::string& asset, const std::string& method) {
-        // TODO: Implémenter
-        return "";
+        std::string address;
+        Call<eDepositAddresses>({{"asset", asset}, {"method", method}}, address);
+        return address;
     }
 
     std::string KrakenApi::RequestWithdrawal(const std::string& asset, const std::string& key, 
                                             double amount) {
-        // TODO: Implémenter
-        return "";
+        std::string refid;
+        if (mRisk->IsTripped()) {
+            mLastError = "Withdrawal rejected by risk gate: kill_switch";
+            return refid;
+        }
+        Call<eWithdraw>({{"asset", asset}, {"key", key}, {"amount", FormatNumber(amount)}}, refid);
+        return refid;
     }
 
     double KrakenApi::GetMinOrderSize(const std::string& pair) {
-        // TODO: Implémenter
+        GetReferenceData();
+        std::shared_ptr<const PairInfo> info = FindPairInfo(pair);
+        if (info) {
+            return info->orderMin;
+        }
+        mLastError = "Unknown pair: " + pair;
         return 0.0;
     }
 
     double KrakenApi::GetTickSize(const std::string& pair) {
-        // TODO: Implémenter
+        GetReferenceData();
+        std::shared_ptr<const PairInfo> info = FindPairInfo(pair);
+        if (info) {
+            return info->tickSize;
+        }
+        mLastError = "Unknown pair: " + pair;
         return 0.0;
     }
 
     double KrakenApi::CalculateOrderValue(const std::string& pair, double volume, double price) {
-        // TODO: Implémenter
         return volume * price;
     }
 
     double KrakenApi::CalculateFees(const std::string& pair, double volume, const std::string& type) {
-        // TODO: Implémenter (frais Kraken ~0.26% pour maker, ~0.16% pour taker)
-        return volume * 0.0026;
+        // Barème de la paire au palier de notre volume 30 jours ; paire inconnue : taux de base du côté demandé
+        GetReferenceData();
+        std::shared_ptr<const FeeEngine> fees = mFees.load(std::memory_order_acquire);
+        std::shared_ptr<const PairInfo> info = FindPairInfo(pair);
+        PairId id = fees->Find(info ? info->name : pair);
+        return volume * (type == "maker" ? fees->GetMakerRate(id) : fees->GetTakerRate(id));
     }
 
-    bool KrakenApi::SubscribeToOrderBook(const std::string& pair) {
-        // TODO: Implémenter WebSocket
-        return false;
+    bool KrakenApi::SubscribeToOrderBook(const std::string& pair, int depth) {
+        // Profondeurs acceptées par Kraken : 10, 25, 100, 500, 1000
+        return mFeed->Subscribe("book", pair, ToWsName(pair), depth);
     }
 
     bool KrakenApi::SubscribeToTrades(const std::string& pair) {
-        // TODO: Implémenter WebSocket
-        return false;
+        return mFeed->Subscribe("trade", pair, ToWsName(pair));
     }
 
-    bool KrakenApi::SubscribeToOwnTrades() {
-        // TODO: Implémenter WebSocket
-        return false;
+    bool KrakenApi::UnsubscribeFromPair(const std::string& pair) {
+        std::string wsname = ToWsName(pair);
+        bool removed = mFeed->Unsubscribe("ticker", wsname);
+        removed = mFeed->Unsubscribe("book", wsname) || removed;
+        removed = mFeed->Unsubscribe("trade", wsname) || removed;
+        return removed;
     }
 
     void KrakenApi::SetOrderBookCallback(std::function<void(const OrderBook&)> callback) {
@@ -714,4 +1593,23 @@ namespace API {
         mTradeCallback = callback;
     }
 
+    void KrakenApi::SetGapCallback(std::function<void(const FeedGap&)> callback) {
+        mGapCallback = callback;
+    }
+
+    bool KrakenApi::EnableMarketPublisher(const std::string& segment) {
+        if (mPublisher) {
+            return true;
+        }
+        std::unique_ptr<MarketPublisher> publisher(new MarketPublisher());
+        if (!publisher->Open(segment)) {
+            mLastError = publisher->GetLastError();
+            LOG_ERROR("Market publisher disabled: {}", mLastError);
+            return false;
+        }
+        LOG_INFO("Publishing market data on {}", segment);
+        mPublisher = std::move(publisher);
+        return true;
+    }
+
 } // API
\ No newline at end of file
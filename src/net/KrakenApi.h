@@ -9,6 +9,11 @@
 #include <vector>
 #include <map>
 #include <memory>
+#include <functional>
+#include <atomic>
+#include <mutex>
+#include <cstdint>
+#include <curl/curl.h>
 #include "../core/def.h"
 
 namespace API {
@@ -35,6 +40,7 @@ namespace API {
     struct OrderBook {
         std::vector<OrderBookEntry> asks;
         std::vector<OrderBookEntry> bids;
+        std::string pair;
     };
 
     struct Trade {
@@ -42,6 +48,16 @@ namespace API {
         double volume;
         long timestamp;
         std::string type; // "buy" or "sell"
+        std::string pair;
+        std::string id;   // txid (historique privé) ou numéro du trade public
+    };
+
+    // Trou dans le flux temps réel : les données du canal sont à reconstruire
+    struct FeedGap {
+        std::string channel;  // "ticker", "book" ou "trade"
+        std::string pair;
+        std::string reason;   // "disconnect", "heartbeat", "checksum"
+        long timestamp;
     };
 
     struct Balance {
@@ -59,8 +75,11 @@ namespace API {
         double volume;
         double price;
         double filled;
+        double cost;    // cumul exécuté, en devise de cotation
+        double fee;
         std::string status; // "open", "closed", "canceled"
         long timestamp;
+        long closed;    // heure de clôture (0 tant que l'ordre est ouvert)
     };
 
     struct Position {
@@ -73,6 +92,57 @@ namespace API {
         long timestamp;
     };
 
+    // Identifiant compact d'une paire, à résoudre une seule fois hors du chemin critique
+    typedef uint32_t PairId;
+    const PairId INVALID_PAIR = 0xFFFFFFFF;
+
+    // Palier de frais : volume 30 jours (USD) à partir duquel s'applique le pourcentage
+    struct FeeTier {
+        double volume;
+        double percent;
+    };
+
+    struct PairInfo {
+        std::string name;
+        std::string altname;
+        std::string wsname;
+        std::string base;
+        std::string quote;
+        int pairDecimals;
+        int lotDecimals;
+        double orderMin;
+        double tickSize;
+        std::vector<FeeTier> fees;        // taker
+        std::vector<FeeTier> feesMaker;
+    };
+
+    // Pages d'historique : "last" sert de curseur pour la page suivante des trades publics,
+    // "count" donne le total de la fenêtre start/end des historiques privés (pagination par ofs)
+    struct TradePage {
+        std::vector<Trade> trades;
+        std::string last;
+        int count = 0;
+    };
+
+    struct OrderPage {
+        std::vector<Order> orders;
+        int count = 0;
+    };
+
+    // Durées des étapes du préchauffage (µs)
+    struct WarmupReport {
+        long resolveUs = 0;
+        long connectUs = 0;
+        long codeUs = 0;
+        int connections = 0;      // connexions ouvertes et gardées
+        std::string pinned;       // adresses figées de l'hôte REST
+    };
+
+    // Table des endpoints (Endpoints.h)
+    enum EEndpoint : int;
+    struct EndpointInfo;
+    template <EEndpoint E> struct Endpoint;
+
     class KrakenApi {
         public:
             KrakenApi();
@@ -81,12 +151,50 @@ namespace API {
             // Configuration
             void SetCredentials(const std::string& apiKey, const std::string& apiSecret);
             void SetSandboxMode(bool enabled);
+            void SetBaseUrl(const std::string& baseUrl);
+            // Transport en processus à la place de HTTP (SimTransport : exchange simulé)
+            void SetTransport(std::shared_ptr<class Transport> transport);
+            
+            // Fusion des requêtes publiques (0 = regroupement des tickers désactivé)
+            void SetTickerBatchWindow(long microseconds);
+            unsigned long GetCoalescedRequests() const;
+            
+            // Busy-poll des sockets (SO_BUSY_POLL, 0 = désactivé)
+            void SetBusyPoll(int microseconds);
+            
+            // Timeouts, retries des requêtes publiques et requêtes doublées au p95
+            // (une échéance par appel se pose avec API::ScopedDeadline)
+            void SetTimeouts(long requestMs, long connectMs);
+            void SetRetryPolicy(int maxRetries, long baseBackoffMs);
+            void SetHedging(bool enabled);
+            
+            // Budgets de rate-limit : requêtes/s publiques, compteur privé Kraken (0 = pas de limite)
+            void SetRateLimits(int publicPerSecond, int privateCounter, double privateDecayPerSecond = 0.33);
+            double GetPrivateHeadroom();   // points privés disponibles sans attente (-1 : pas de limite)
+            
+            // Contrôle pré-trade appliqué à chaque ordre (limites, coupe-circuit)
+            class RiskGate& GetRiskGate();
+            // Contrôle partagé entre plusieurs clés d'un même compte (avant ConnectWebSocket et le premier ordre)
+            void SetRiskGate(std::shared_ptr<class RiskGate> gate);
+            // Soldes locaux réservés à l'envoi, consommés aux exécutions, libérés à la clôture
+            // (registre déjà synchronisé, partagé entre les clés d'un même compte ; avant le premier ordre)
+            void SetBalanceLedger(std::shared_ptr<class FundsLedger> ledger);
+            // Positions et PnL : exécutions des ordres suivis, réévaluation à chaque ticker du flux
+            // (partagées entre les clés d'un même compte ; avant ConnectWebSocket et le premier ordre)
+            void SetPositionTracker(std::shared_ptr<class PositionTracker> positions);
+            std::shared_ptr<class PositionTracker> GetPositionTracker() const;
             
             // ===== MÉTHODES PUBLIQUES (sans authentification) =====
             
             // Informations sur les paires de trading
             std::vector<std::string> GetTradingPairs();
+            // Instantané du cache de référence (téléchargé au premier appel sans cache), valide
+            // pendant toute la vie de l'objet ; vide si le téléchargement échoue
             std::map<std::string, std::string> GetAssetInfo();
+            std::map<std::string, PairInfo> GetPairInfo();
+            
+            // Cache disque des données de référence (rafraîchi en tâche de fond à chaque péremption)
+            bool LoadReferenceCache(const std::string& path = CACHE_FILE, long maxAgeSeconds = 86400);
             
             // Données de marché en temps réel
             TickerData GetTicker(const std::string& pair);
@@ -97,6 +205,8 @@ namespace API {
             
             // Historique des trades
             std::vector<Trade> GetRecentTrades(const std::string& pair, int count = 100);
+            // Page brute depuis "since" (ns, ou vide), pour HistoryDownloader
+            bool GetTradesPage(const std::string& pair, const std::string& since, TradePage& page);
             
             // Données OHLC (chandelier)
             std::vector<std::vector<double>> GetOHLC(const std::string& pair, int interval = 1);
@@ -110,6 +220,7 @@ namespace API {
             // Gestion du compte
             std::vector<Balance> GetAccountBalance();
             std::map<std::string, double> GetTradingBalance();
+            double GetTradeVolume();
             
             // Gestion des ordres
             std::string PlaceOrder(const std::string& pair, const std::string& type, 
@@ -128,13 +239,21 @@ namespace API {
             // Consultation des ordres
             std::vector<Order> GetOpenOrders(const std::string& pair = "");
             std::vector<Order> GetClosedOrders(const std::string& pair = "", int count = 50);
+            // Page de 50 lignes à partir de "offset" dans la fenêtre ]start, end] sur l'heure de clôture (0 = non bornée)
+            bool GetClosedOrdersPage(long start, long end, int offset, OrderPage& page);
             Order GetOrderInfo(const std::string& orderId);
+            // État des ordres envoyés par ce processus : exécutions et clôtures reportées
+            // au contrôle pré-trade (à appeler périodiquement, les expirations n'arrivent que par là)
+            bool RefreshOrders();
             
             // Historique des trades personnels
             std::vector<Trade> GetTradeHistory(const std::string& pair = "", int count = 50);
+            bool GetTradeHistoryPage(long start, long end, int offset, TradePage& page);
             
             // Positions (pour le trading sur marge)
             std::vector<Position> GetOpenPositions();
+            // Position nette de chaque paire recalée dans le contrôle pré-trade (et chargée dans le suivi des positions)
+            bool SyncPositions(const std::vector<std::string>& pairs);
             
             // Dépôts et retraits
             std::vector<std::string> GetDepositMethods(const std::string& asset);
@@ -151,9 +270,9 @@ namespace API {
             
             // Calculs
             double CalculateOrderValue(const std::string& pair, double volume, double price);
-            double CalculateFees(const std::string& pair, double volume, const std::string& type);
+            double CalculateFees(const std::string& pair, double volume, const std::string& type); // type = "maker" ou "taker"
             
-            // Gestion des erreurs
+            // Gestion des erreurs (dernière erreur du thread appelant)
             std::string GetLastError() const;
             bool HasError() const;
             
@@ -161,24 +280,72 @@ namespace API {
             bool ConnectWebSocket();
             void DisconnectWebSocket();
             bool SubscribeToTicker(const std::string& pair);
-            bool SubscribeToOrderBook(const std::string& pair);
+            bool SubscribeToOrderBook(const std::string& pair, int depth = 10);
             bool SubscribeToTrades(const std::string& pair);
-            bool SubscribeToOwnTrades();
+            // Retire les canaux ticker, book et trade de la paire
+            bool UnsubscribeFromPair(const std::string& pair);
+            bool IsWebSocketConnected() const;
+            void SetWebSocketUrl(const std::string& url);
+            void SetHeartbeatTimeout(long milliseconds);
+            void SetFeedThreadHook(std::function<void()> hook);   // appelé au démarrage du thread de flux
             
-            // Callback pour les données WebSocket
+            // Callback pour les données WebSocket (à définir avant ConnectWebSocket)
             void SetTickerCallback(std::function<void(const TickerData&)> callback);
             void SetOrderBookCallback(std::function<void(const OrderBook&)> callback);
             void SetTradeCallback(std::function<void(const Trade&)> callback);
+            void SetGapCallback(std::function<void(const FeedGap&)> callback);
+
+            // Mode éditeur : le flux est aussi diffusé en mémoire partagée (à activer avant ConnectWebSocket)
+            bool EnableMarketPublisher(const std::string& segment = MARKET_SEGMENT);
             
             // Test de connectivité
             bool TestConnection();
             bool TestAuthentication();
             
+            // Préchauffage avant le premier ordre : DNS figé, connexions ouvertes et gardées,
+            // signature et décodeurs exercés sur des données factices (rien n'est envoyé de privé)
+            bool Warmup(int connections, long timeoutMs, WarmupReport& report);
+            
         private:
             // Méthodes internes
-            std::string MakeRequest(const std::string& endpoint, const std::string& method = "GET", 
-                                  const std::map<std::string, std::string>& params = {}, 
-                                  bool authenticated = false);
+            // Appel typé : chemin, authentification, coût et décodeur résolus à la compilation
+            template <EEndpoint E>
+            bool Call(const std::map<std::string, std::string>& params, typename Endpoint<E>::Result& result);
+            
+            std::string MakeRequest(const EndpointInfo& endpoint, 
+                                  const std::map<std::string, std::string>& params = {});
+            std::string PerformRequest(const EndpointInfo& endpoint, 
+                                     const std::map<std::string, std::string>& params);
+            
+            CURL* CreateHandle(const std::string& url, const std::string& postData, bool post, 
+                               struct curl_slist* headers, long timeoutMs, std::string* buffer);
+            CURLcode Execute(const std::string& url, const std::string& postData, bool post, 
+                             struct curl_slist* headers, long timeoutMs, 
+                             std::string& response, long& status);
+            CURLcode ExecuteHedged(const std::string& url, const std::string& postData, bool post, 
+                                   struct curl_slist* headers, long timeoutMs, long hedgeDelayMs, 
+                                   std::string& response, long& status);
+            static bool IsRetryable(CURLcode res);
+            int OpenConnections(int count, long timeoutMs);
+            // Ordres observés (QueryOrders, OpenOrders, ClosedOrders) : suivi des ordres envoyés
+            void ObserveOrders(const std::vector<Order>& orders);
+            bool QueryOrders(const std::vector<std::string>& orderIds);
+            // Clôture sans état connu : réservations libérées
+            void CloseOrder(const std::string& orderId);
+            void WarmCodePaths();
+            
+            std::map<std::string, std::string> DownloadAssetInfo();
+            std::map<std::string, PairInfo> DownloadPairInfo();
+            bool DownloadReferenceData(struct RefData& data);
+            std::shared_ptr<const struct RefData> GetReferenceData();
+            // Nouveau barème pour l'instantané de référence et le volume courants
+            void RebuildFees();
+            // Nom Kraken, altname ou wsname ; nullptr si inconnu (jamais de requête)
+            std::shared_ptr<const PairInfo> FindPairInfo(const std::string& pair) const;
+            std::string ToWsName(const std::string& pair);
+            std::string CanonicalPair(const std::string& pair) const;
+            bool SamePair(const std::string& pair, const std::string& other) const;
+            static std::string FormatNumber(double value);
             
             std::string GenerateNonce();
             std::string GenerateSignature(const std::string& path, const std::string& nonce, 
@@ -189,13 +356,50 @@ namespace API {
             std::string mApiSecret;
             std::string mBaseUrl;
             bool mSandboxMode;
-            std::string mLastError;
+            std::shared_ptr<class Transport> mTransport;
+            // Par thread, comme errno : les appels concurrents ne s'écrasent pas
+            static thread_local std::string mLastError;
+            // Relus à chaque requête : un rechargement s'applique sans verrou
+            std::atomic<int> mBusyPollUs;
+            std::atomic<double> mTradeVolume;
+            
+            // Politique de requête
+            std::atomic<long> mRequestTimeoutMs;
+            std::atomic<long> mConnectTimeoutMs;
+            int mMaxRetries;
+            long mRetryBaseMs;
+            bool mHedging;
+            std::atomic<long long> mLastNonce;
+            std::unique_ptr<class LatencyTracker> mLatency;
+            std::unique_ptr<class RateBudget> mPublicBudget;
+            std::unique_ptr<class RateBudget> mPrivateBudget;
+            std::unique_ptr<class ConnectionPool> mConnections;
+            
+            // Fusion des requêtes publiques identiques
+            std::unique_ptr<class SingleFlight> mSingleFlight;
+            std::unique_ptr<class TickerBatcher> mTickerBatcher;
+            
+            // Barèmes de frais, reconstruits à chaque instantané de référence ou
+            // changement de volume ; un ancien barème vit tant qu'un lecteur le tient
+            std::atomic<std::shared_ptr<const class FeeEngine>> mFees;
+            std::mutex mFeesMutex;
+
+            // Données de référence (après les barèmes : son thread de fond les reconstruit)
+            std::unique_ptr<class RefDataCache> mRefData;
+            
+            // Contrôle pré-trade
+            std::shared_ptr<class RiskGate> mRisk;
+            std::shared_ptr<class FundsLedger> mLedger;
+            std::shared_ptr<class PositionTracker> mPositions;
+            std::atomic<unsigned long> mPendingOrders;      // identifiants de réservation avant txid
             
             // WebSocket
-            std::unique_ptr<class WebSocketClient> mWebSocket;
+            std::unique_ptr<class KrakenFeed> mFeed;
+            std::unique_ptr<class MarketPublisher> mPublisher;
             std::function<void(const TickerData&)> mTickerCallback;
             std::function<void(const OrderBook&)> mOrderBookCallback;
             std::function<void(const Trade&)> mTradeCallback;
+            std::function<void(const FeedGap&)> mGapCallback;
     };
 
 } // API
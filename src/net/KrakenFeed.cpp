@@ -0,0 +1,607 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#include "KrakenFeed.h"
+#include "WebSocketClient.h"
+#include "RequestPolicy.h"
+#include "LatencyProbe.h"
+#include "../core/Logger.h"
+#include "../core/Metrics.h"
+#include "../core/ThreadLayout.h"
+#include <chrono>
+#include <cstdlib>
+#include <json/json.h>
+
+namespace API {
+
+    // Tranche de lecture : délai maximal avant de traiter les souscriptions en attente
+    static const int READ_SLICE_MS = 20;
+    static const long BACKOFF_BASE_MS = 100;
+    static const long BACKOFF_MAX_MS = 5000;
+    // Kraken calcule le checksum sur les 10 meilleurs niveaux de chaque côté
+    static const size_t CHECKSUM_LEVELS = 10;
+
+    static long long NowMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()
+        ).count();
+    }
+
+    static double ToDouble(const Json::Value& value) {
+        return value.isString() ? std::atof(value.asCString()) : value.asDouble();
+    }
+
+    // ===== MÉTRIQUES =====
+
+    struct SChannelMetrics {
+        Richy::CCounter updates;
+        Richy::CHistogram callbackLatency;
+
+        explicit SChannelMetrics(const char* channel) {
+            std::string label = std::string("{channel=\"") + channel + "\"}";
+            updates = Richy::CMetrics::Counter("richy_feed_updates_total" + label);
+            callbackLatency = Richy::CMetrics::Histogram("richy_callback_latency_us" + label);
+        }
+    };
+
+    struct SFeedMetrics {
+        Richy::CCounter messages = Richy::CMetrics::Counter("richy_feed_messages_total");
+        Richy::CCounter gaps = Richy::CMetrics::Counter("richy_feed_gaps_total");
+        Richy::CCounter reconnects = Richy::CMetrics::Counter("richy_feed_reconnects_total");
+        Richy::CGauge connected = Richy::CMetrics::Gauge("richy_feed_connected");
+        SChannelMetrics ticker{"ticker"};
+        SChannelMetrics trade{"trade"};
+        SChannelMetrics book{"book"};
+    };
+
+    static SFeedMetrics& FeedMetrics() {
+        static SFeedMetrics metrics;
+        return metrics;
+    }
+
+    // Appel d'un handler utilisateur, durée comptée dans l'histogramme du canal
+    template <typename Handler, typename Value>
+    static void Dispatch(SChannelMetrics& metrics, const Handler& handler, const Value& value) {
+        auto start = std::chrono::steady_clock::now();
+        handler(value);
+        metrics.callbackLatency.Observe((uint64_t) std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start
+        ).count());
+    }
+
+    KrakenFeed::KrakenFeed(const std::string& url) :
+        mUrl(url),
+        mHeartbeatTimeoutMs(3000),
+        mConnectTimeoutMs(5000),
+        mBusyPollUs(0),
+        mClient(new WebSocketClient()),
+        mRunning(false),
+        mConnected(false),
+        mReconnects(0),
+        mGaps(0),
+        mLastMessageMs(0),
+        mLastPingMs(0) {
+    }
+
+    KrakenFeed::~KrakenFeed() {
+        Stop();
+    }
+
+    // ===== PARAMÈTRES =====
+
+    void KrakenFeed::SetUrl(const std::string& url) {
+        mUrl = url;
+    }
+
+    void KrakenFeed::SetHeartbeatTimeout(long milliseconds) {
+        mHeartbeatTimeoutMs = milliseconds;
+    }
+
+    void KrakenFeed::SetConnectTimeout(long milliseconds) {
+        mConnectTimeoutMs = milliseconds;
+    }
+
+    void KrakenFeed::SetBusyPoll(int microseconds) {
+        mBusyPollUs = microseconds;
+    }
+
+    void KrakenFeed::SetThreadHook(std::function<void()> hook) {
+        mThreadHook = hook;
+    }
+
+    void KrakenFeed::SetTickerHandler(std::function<void(const TickerData&)> handler) {
+        mTickerHandler = handler;
+    }
+
+    void KrakenFeed::SetOrderBookHandler(std::function<void(const OrderBook&)> handler) {
+        mOrderBookHandler = handler;
+    }
+
+    void KrakenFeed::SetTradeHandler(std::function<void(const Trade&)> handler) {
+        mTradeHandler = handler;
+    }
+
+    void KrakenFeed::SetGapHandler(std::function<void(const FeedGap&)> handler) {
+        mGapHandler = handler;
+    }
+
+    unsigned long KrakenFeed::GetReconnects() const {
+        return mReconnects.load(std::memory_order_relaxed);
+    }
+
+    unsigned long KrakenFeed::GetGaps() const {
+        return mGaps.load(std::memory_order_relaxed);
+    }
+
+    std::string KrakenFeed::GetLastError() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mLastError;
+    }
+
+    void KrakenFeed::SetError(const std::string& error) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mLastError = error;
+    }
+
+    // ===== CYCLE DE VIE =====
+
+    bool KrakenFeed::Start() {
+        if (mRunning) {
+            return true;
+        }
+        if (!Connect()) {
+            return false;
+        }
+        mRunning = true;
+        mThread = std::thread(&KrakenFeed::Run, this);
+        return true;
+    }
+
+    void KrakenFeed::Stop() {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mRunning = false;
+            mDroppedBooks.clear();
+        }
+        mStopCondition.notify_all();
+        if (mThread.joinable()) {
+            mThread.join();
+        }
+        mClient->Close();
+        mConnected = false;
+        FeedMetrics().connected.Set(0);
+        mBooks.clear();
+    }
+
+    bool KrakenFeed::IsRunning() const {
+        return mRunning;
+    }
+
+    bool KrakenFeed::IsConnected() const {
+        return mConnected;
+    }
+
+    bool KrakenFeed::Subscribe(const std::string& channel, const std::string& pair,
+                               const std::string& wsname, int depth) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (const auto& subscription : mSubscriptions) {
+            if (subscription.channel == channel && subscription.wsname == wsname) {
+                return true;
+            }
+        }
+
+        // Conservée pour être renvoyée à chaque reconnexion
+        SSubscription subscription = {channel, pair, wsname, depth};
+        mSubscriptions.push_back(subscription);
+        if (mConnected) {
+            mOutbox.push_back(SubscribeMessage(subscription, "subscribe"));
+        }
+        return true;
+    }
+
+    bool KrakenFeed::Unsubscribe(const std::string& channel, const std::string& wsname) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (auto it = mSubscriptions.begin(); it != mSubscriptions.end(); ++it) {
+            if (it->channel == channel && it->wsname == wsname) {
+                if (mConnected) {
+                    mOutbox.push_back(SubscribeMessage(*it, "unsubscribe"));
+                }
+                if (channel == "book") {
+                    // Le carnet appartient au thread du flux : effacé au prochain Flush
+                    mDroppedBooks.push_back(it->pair);
+                }
+                mSubscriptions.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool KrakenFeed::Connect() {
+        if (!mClient->Connect(mUrl, mConnectTimeoutMs)) {
+            SetError(mClient->GetLastError());
+            return false;
+        }
+
+        int busyPollUs = mBusyPollUs;
+        if (busyPollUs > 0) {
+            Richy::CThreadLayout::EnableBusyPoll(mClient->GetFd(), busyPollUs);
+        }
+
+        mLastMessageMs = NowMs();
+        mLastPingMs = mLastMessageMs;
+
+        // Les snapshots renvoyés par Kraken reconstruisent les carnets
+        std::lock_guard<std::mutex> lock(mMutex);
+        mOutbox.clear();
+        for (const auto& subscription : mSubscriptions) {
+            if (!mClient->SendText(SubscribeMessage(subscription, "subscribe"))) {
+                mLastError = "Cannot resubscribe " + subscription.channel + " " + subscription.wsname;
+                mClient->Close();
+                return false;
+            }
+        }
+        mConnected = true;
+        FeedMetrics().connected.Set(1);
+        return true;
+    }
+
+    void KrakenFeed::Disconnect(const std::string& reason) {
+        std::string error = mClient->GetLastError();
+        mClient->Close();
+
+        std::vector<SSubscription> subscriptions;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mConnected = false;
+            mOutbox.clear();
+            mDroppedBooks.clear();
+            FeedMetrics().connected.Set(0);
+            mLastError = reason == "heartbeat" ? "Heartbeat timeout" : error;
+            subscriptions = mSubscriptions;
+        }
+
+        // Tout l'état local est désormais suspect
+        mBooks.clear();
+        for (const auto& subscription : subscriptions) {
+            ReportGap(subscription, reason);
+        }
+    }
+
+    void KrakenFeed::Flush() {
+        std::vector<std::string> outbox;
+        std::vector<std::string> dropped;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mOutbox.empty() && mDroppedBooks.empty()) {
+                return;
+            }
+            outbox.swap(mOutbox);
+            dropped.swap(mDroppedBooks);
+        }
+        for (const auto& pair : dropped) {
+            mBooks.erase(pair);
+        }
+        for (const auto& message : outbox) {
+            mClient->SendText(message);
+        }
+    }
+
+    void KrakenFeed::Run() {
+        if (mThreadHook) {
+            mThreadHook();
+        }
+
+        int attempt = 0;
+        std::string message;
+        while (mRunning) {
+            if (!mConnected) {
+                long delay = RetryBackoff(attempt, BACKOFF_BASE_MS, BACKOFF_MAX_MS);
+                {
+                    std::unique_lock<std::mutex> lock(mMutex);
+                    mStopCondition.wait_for(lock, std::chrono::milliseconds(delay), [this]() {
+                        return !mRunning;
+                    });
+                }
+                if (!mRunning) {
+                    break;
+                }
+                if (!Connect()) {
+                    attempt++;
+                    continue;
+                }
+                LOG_INFO("WebSocket reconnected to {} after {} attempt(s)", mUrl, attempt + 1);
+                attempt = 0;
+                mReconnects++;
+                FeedMetrics().reconnects.Add();
+                continue;
+            }
+
+            Flush();
+
+            int res = mClient->Receive(message, READ_SLICE_MS, mBusyPollUs > 0);
+            long long now = NowMs();
+            if (res < 0) {
+                Disconnect("disconnect");
+                continue;
+            }
+            if (res > 0) {
+                FeedMetrics().messages.Add();
+                mLastMessageMs = now;
+                LatencyProbe::Begin();
+                Handle(message);
+                LatencyProbe::End();
+                continue;
+            }
+
+            // Kraken émet un heartbeat par seconde : le silence signale une connexion morte
+            long long silence = now - mLastMessageMs;
+            if (silence > mHeartbeatTimeoutMs) {
+                Disconnect("heartbeat");
+            } else if (silence > mHeartbeatTimeoutMs / 2 && now - mLastPingMs > mHeartbeatTimeoutMs / 2) {
+                mClient->SendText("{\"event\":\"ping\"}");
+                mLastPingMs = now;
+            }
+        }
+    }
+
+    void KrakenFeed::ReportGap(const SSubscription& subscription, const std::string& reason) {
+        mGaps++;
+        FeedMetrics().gaps.Add();
+        LOG_WARNING("Feed gap on {} {}: {}", subscription.channel, subscription.pair, reason);
+        if (!mGapHandler) {
+            return;
+        }
+
+        FeedGap gap;
+        gap.channel = subscription.channel;
+        gap.pair = subscription.pair;
+        gap.reason = reason;
+        gap.timestamp = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()
+        ).count();
+        mGapHandler(gap);
+    }
+
+    std::string KrakenFeed::SubscribeMessage(const SSubscription& subscription, const std::string& event) {
+        std::string message = "{\"event\":\"" + event + "\",\"pair\":[\"" + subscription.wsname +
+                              "\"],\"subscription\":{\"name\":\"" + subscription.channel + "\"";
+        if (subscription.channel == "book" && subscription.depth > 0) {
+            message += ",\"depth\":" + std::to_string(subscription.depth);
+        }
+        message += "}}";
+        return message;
+    }
+
+    // ===== MESSAGES =====
+
+    void KrakenFeed::Handle(const std::string& message) {
+        Json::Value root;
+        Json::Reader reader;
+        if (!reader.parse(message, root)) {
+            return;
+        }
+        LatencyProbe::Mark(eStageDecode);
+
+        // Événements : heartbeat, pong, systemStatus, subscriptionStatus
+        if (root.isObject()) {
+            if (root["event"].asString() == "subscriptionStatus" && root["status"].asString() == "error") {
+                SetError("Subscription error: " + root["errorMessage"].asString());
+                LOG_ERROR("WebSocket subscription error: {}", root["errorMessage"].asString());
+            }
+            return;
+        }
+
+        // Données : [channelID, ..., "nom-canal", "paire"]
+        if (!root.isArray() || root.size() < 4) {
+            return;
+        }
+        std::string name = root[root.size() - 2].asString();
+        std::string wsname = root[root.size() - 1].asString();
+        std::string channel = name.substr(0, name.find('-'));
+
+        SSubscription subscription;
+        bool found = false;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            for (const auto& candidate : mSubscriptions) {
+                if (candidate.channel == channel && candidate.wsname == wsname) {
+                    subscription = candidate;
+                    found = true;
+                    break;
+                }
+            }
+        }
+        if (!found) {
+            return;
+        }
+
+        if (channel == "ticker") {
+            HandleTicker(subscription, root[1]);
+        } else if (channel == "trade") {
+            HandleTrades(subscription, root[1]);
+        } else if (channel == "book") {
+            HandleBook(subscription, root);
+        }
+    }
+
+    void KrakenFeed::HandleTicker(const SSubscription& subscription, const Json::Value& data) {
+        FeedMetrics().ticker.updates.Add();
+        if (!mTickerHandler) {
+            return;
+        }
+
+        // Même champs que /0/public/Ticker, valeurs sur 24h
+        TickerData ticker;
+        ticker.pair = subscription.pair;
+        ticker.ask = ToDouble(data["a"][0]);
+        ticker.bid = ToDouble(data["b"][0]);
+        ticker.last = ToDouble(data["c"][0]);
+        ticker.volume = ToDouble(data["v"][1]);
+        ticker.high = ToDouble(data["h"][1]);
+        ticker.low = ToDouble(data["l"][1]);
+        ticker.open = ToDouble(data["o"][1]);
+        ticker.timestamp = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()
+        ).count();
+        Dispatch(FeedMetrics().ticker, mTickerHandler, ticker);
+    }
+
+    void KrakenFeed::HandleTrades(const SSubscription& subscription, const Json::Value& data) {
+        FeedMetrics().trade.updates.Add();
+        if (!mTradeHandler) {
+            return;
+        }
+
+        // [prix, volume, horodatage, côté, type, divers]
+        for (const auto& entry : data) {
+            Trade trade;
+            trade.price = ToDouble(entry[0]);
+            trade.volume = ToDouble(entry[1]);
+            trade.timestamp = (long) ToDouble(entry[2]);
+            trade.type = entry[3].asString() == "b" ? "buy" : "sell";
+            trade.pair = subscription.pair;
+            Dispatch(FeedMetrics().trade, mTradeHandler, trade);
+        }
+    }
+
+    // ===== CARNETS =====
+
+    // Niveaux [prix, volume, horodatage(, "r")] ; volume nul = suppression
+    template <typename Side>
+    static void ApplyLevels(Side& side, const Json::Value& levels) {
+        for (const auto& level : levels) {
+            std::string price = level[0].asString();
+            std::string volume = level[1].asString();
+            double key = std::atof(price.c_str());
+            if (std::atof(volume.c_str()) == 0.0) {
+                side.erase(key);
+            } else {
+                side[key] = {price, volume, ToDouble(level[2])};
+            }
+        }
+    }
+
+    template <typename Side>
+    static void Truncate(Side& side, size_t depth) {
+        while (depth > 0 && side.size() > depth) {
+            side.erase(std::prev(side.end()));
+        }
+    }
+
+    void KrakenFeed::HandleBook(const SSubscription& subscription, const Json::Value& message) {
+        FeedMetrics().book.updates.Add();
+        SBook& book = mBooks[subscription.pair];
+
+        // Les mises à jour peuvent porter "a" et "b" dans deux objets distincts
+        std::string checksum;
+        for (Json::ArrayIndex i = 1; i + 2 < message.size(); ++i) {
+            const Json::Value& part = message[i];
+            if (part.isMember("as") || part.isMember("bs")) {
+                book.asks.clear();
+                book.bids.clear();
+                ApplyLevels(book.asks, part["as"]);
+                ApplyLevels(book.bids, part["bs"]);
+                book.synced = true;
+            }
+            if (part.isMember("a")) {
+                ApplyLevels(book.asks, part["a"]);
+            }
+            if (part.isMember("b")) {
+                ApplyLevels(book.bids, part["b"]);
+            }
+            if (part.isMember("c")) {
+                checksum = part["c"].asString();
+            }
+        }
+
+        // En attente du snapshot après une resynchronisation
+        if (!book.synced) {
+            return;
+        }
+
+        Truncate(book.asks, (size_t) subscription.depth);
+        Truncate(book.bids, (size_t) subscription.depth);
+
+        if (!checksum.empty() && std::to_string(Checksum(book)) != checksum) {
+            ReportGap(subscription, "checksum");
+            Resync(subscription);
+            return;
+        }
+
+        if (!mOrderBookHandler) {
+            return;
+        }
+
+        OrderBook snapshot;
+        snapshot.pair = subscription.pair;
+        snapshot.asks.reserve(book.asks.size());
+        snapshot.bids.reserve(book.bids.size());
+        for (const auto& level : book.asks) {
+            snapshot.asks.push_back({level.first, std::atof(level.second.volume.c_str()), (long) level.second.timestamp});
+        }
+        for (const auto& level : book.bids) {
+            snapshot.bids.push_back({level.first, std::atof(level.second.volume.c_str()), (long) level.second.timestamp});
+        }
+        Dispatch(FeedMetrics().book, mOrderBookHandler, snapshot);
+    }
+
+    void KrakenFeed::Resync(const SSubscription& subscription) {
+        // Un nouvel abonnement déclenche un nouveau snapshot
+        mBooks[subscription.pair] = SBook();
+        mClient->SendText(SubscribeMessage(subscription, "unsubscribe"));
+        mClient->SendText(SubscribeMessage(subscription, "subscribe"));
+    }
+
+    // Chiffres du prix puis du volume, sans point ni zéros de tête
+    static void AppendDigits(std::string& out, const std::string& value) {
+        bool leading = true;
+        for (char c : value) {
+            if (c == '.' || (leading && c == '0')) {
+                continue;
+            }
+            leading = false;
+            out.push_back(c);
+        }
+    }
+
+    static unsigned int Crc32(const std::string& data) {
+        static const struct STable {
+            unsigned int values[256];
+            STable() {
+                for (unsigned int i = 0; i < 256; ++i) {
+                    unsigned int crc = i;
+                    for (int bit = 0; bit < 8; ++bit) {
+                        crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+                    }
+                    values[i] = crc;
+                }
+            }
+        } table;
+
+        unsigned int crc = 0xFFFFFFFFu;
+        for (unsigned char c : data) {
+            crc = table.values[(crc ^ c) & 0xFF] ^ (crc >> 8);
+        }
+        return crc ^ 0xFFFFFFFFu;
+    }
+
+    unsigned int KrakenFeed::Checksum(const SBook& book) {
+        std::string payload;
+        payload.reserve(CHECKSUM_LEVELS * 2 * 32);
+
+        size_t count = 0;
+        for (auto it = book.asks.begin(); it != book.asks.end() && count < CHECKSUM_LEVELS; ++it, ++count) {
+            AppendDigits(payload, it->second.price);
+            AppendDigits(payload, it->second.volume);
+        }
+        count = 0;
+        for (auto it = book.bids.begin(); it != book.bids.end() && count < CHECKSUM_LEVELS; ++it, ++count) {
+            AppendDigits(payload, it->second.price);
+            AppendDigits(payload, it->second.volume);
+        }
+        return Crc32(payload);
+    }
+
+} // API
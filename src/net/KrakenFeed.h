@@ -0,0 +1,143 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#ifndef KRAKENFEED_H
+#define KRAKENFEED_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <condition_variable>
+#include "KrakenApi.h"
+
+namespace Json {
+    class Value;
+}
+
+namespace API {
+
+    class WebSocketClient;
+
+    /*
+     * Flux temps réel Kraken (WebSocket v1) avec reprise automatique.
+     *
+     * Un thread dédié porte la connexion : il surveille les heartbeats,
+     * détecte les coupures, se reconnecte avec un backoff à gigue et
+     * renvoie toutes les souscriptions. Les carnets sont reconstruits à
+     * partir du snapshot envoyé par Kraken et vérifiés à chaque mise à jour
+     * par le checksum CRC32 ; en cas d'écart le carnet est resouscrit.
+     *
+     * Chaque trou (coupure, heartbeat manquant, checksum faux) est signalé
+     * aux consommateurs par un FeedGap, par paire et par canal.
+     */
+    class KrakenFeed {
+        public:
+            explicit KrakenFeed(const std::string& url = "wss://ws.kraken.com");
+            ~KrakenFeed();
+
+            // Paramètres (avant Start)
+            void SetUrl(const std::string& url);
+            void SetHeartbeatTimeout(long milliseconds);
+            void SetConnectTimeout(long milliseconds);
+            void SetBusyPoll(int microseconds);
+            void SetThreadHook(std::function<void()> hook);
+
+            // Consommateurs (appelés depuis le thread du flux)
+            void SetTickerHandler(std::function<void(const TickerData&)> handler);
+            void SetOrderBookHandler(std::function<void(const OrderBook&)> handler);
+            void SetTradeHandler(std::function<void(const Trade&)> handler);
+            void SetGapHandler(std::function<void(const FeedGap&)> handler);
+
+            // Première connexion synchrone, reprises dans le thread du flux
+            bool Start();
+            void Stop();
+            bool IsRunning() const;
+            bool IsConnected() const;
+
+            // channel : "ticker", "book" ou "trade" ; wsname : paire au format WebSocket (XBT/USD)
+            bool Subscribe(const std::string& channel, const std::string& pair,
+                           const std::string& wsname, int depth = 0);
+            // Les messages encore en vol pour ce canal sont ignorés
+            bool Unsubscribe(const std::string& channel, const std::string& wsname);
+
+            unsigned long GetReconnects() const;
+            unsigned long GetGaps() const;
+            std::string GetLastError() const;
+
+        private:
+            struct SSubscription {
+                std::string channel;
+                std::string pair;
+                std::string wsname;
+                int depth;
+            };
+
+            struct SLevel {
+                std::string price;    // chaînes d'origine, nécessaires au checksum
+                std::string volume;
+                double timestamp;
+            };
+
+            struct SBook {
+                std::map<double, SLevel, std::greater<double>> bids;
+                std::map<double, SLevel> asks;
+                bool synced = false;
+            };
+
+            void Run();
+            bool Connect();
+            void Disconnect(const std::string& reason);
+            void Flush();
+            void Handle(const std::string& message);
+            void HandleTicker(const SSubscription& subscription, const Json::Value& data);
+            void HandleTrades(const SSubscription& subscription, const Json::Value& data);
+            void HandleBook(const SSubscription& subscription, const Json::Value& message);
+            void Resync(const SSubscription& subscription);
+            void ReportGap(const SSubscription& subscription, const std::string& reason);
+            void SetError(const std::string& error);
+
+            static std::string SubscribeMessage(const SSubscription& subscription, const std::string& event);
+            static unsigned int Checksum(const SBook& book);
+
+            std::string mUrl;
+            long mHeartbeatTimeoutMs;
+            // Modifiables à chaud depuis un autre thread (pris en compte à la connexion suivante)
+            std::atomic<long> mConnectTimeoutMs;
+            std::atomic<int> mBusyPollUs;
+            std::function<void()> mThreadHook;
+
+            std::function<void(const TickerData&)> mTickerHandler;
+            std::function<void(const OrderBook&)> mOrderBookHandler;
+            std::function<void(const Trade&)> mTradeHandler;
+            std::function<void(const FeedGap&)> mGapHandler;
+
+            std::unique_ptr<WebSocketClient> mClient;
+            std::thread mThread;
+            std::atomic<bool> mRunning;
+            std::atomic<bool> mConnected;
+            std::atomic<unsigned long> mReconnects;
+            std::atomic<unsigned long> mGaps;
+            long long mLastMessageMs;
+            long long mLastPingMs;
+
+            // Partagé avec les threads qui souscrivent
+            mutable std::mutex mMutex;
+            std::condition_variable mStopCondition;
+            std::vector<SSubscription> mSubscriptions;
+            std::vector<std::string> mOutbox;
+            std::vector<std::string> mDroppedBooks;   // carnets désabonnés, à effacer par le thread du flux
+            std::string mLastError;
+
+            // Propre au thread du flux
+            std::map<std::string, SBook> mBooks;
+    };
+
+} // API
+
+#endif //KRAKENFEED_H
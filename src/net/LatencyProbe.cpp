@@ -0,0 +1,167 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#include "LatencyProbe.h"
+#include <bit>
+#include <algorithm>
+
+namespace API {
+
+    // Histogramme log-linéaire : valeurs exactes sous 16 ns, puis 8 cases par puissance de 2
+    static const int LINEAR = 16;
+    static const int SUB_BITS = 3;
+    static const int BUCKETS = LINEAR + (64 - 4) * (1 << SUB_BITS);
+
+    struct SHistogram {
+        std::atomic<uint64_t> buckets[BUCKETS];
+        std::atomic<uint64_t> max;
+    };
+
+    // Une par étape, plus le total
+    static SHistogram sHistograms[eStageCount + 1];
+
+    struct STrace {
+        uint64_t stamps[eStageCount];
+        uint32_t marked = 0;
+        bool active = false;
+    };
+
+    static thread_local STrace tTrace;
+
+    std::atomic<bool> LatencyProbe::sEnabled(false);
+    thread_local uint64_t LatencyProbe::tLastRead = 0;
+
+    static int Bucket(uint64_t ns) {
+        if (ns < (uint64_t) LINEAR) {
+            return (int) ns;
+        }
+        int msb = std::bit_width(ns) - 1;
+        int sub = (int) ((ns >> (msb - SUB_BITS)) & ((1 << SUB_BITS) - 1));
+        return LINEAR + (msb - 4) * (1 << SUB_BITS) + sub;
+    }
+
+    // Milieu de la case
+    static uint64_t BucketValue(int bucket) {
+        if (bucket < LINEAR) {
+            return (uint64_t) bucket;
+        }
+        int msb = (bucket - LINEAR) / (1 << SUB_BITS) + 4;
+        int sub = (bucket - LINEAR) % (1 << SUB_BITS);
+        uint64_t low = (uint64_t) ((1 << SUB_BITS) + sub) << (msb - SUB_BITS);
+        return low + ((1ULL << (msb - SUB_BITS)) >> 1);
+    }
+
+    static void Record(SHistogram& histogram, uint64_t ticks) {
+        uint64_t ns = Richy::CTscClock::ToNs(ticks);
+        histogram.buckets[Bucket(ns)].fetch_add(1, std::memory_order_relaxed);
+        uint64_t max = histogram.max.load(std::memory_order_relaxed);
+        while (ns > max && !histogram.max.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+        }
+    }
+
+    void LatencyProbe::Enable(bool enabled) {
+        if (enabled) {
+            // Étalonnage hors du chemin mesuré
+            Richy::CTscClock::NsPerTick();
+        }
+        sEnabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    void LatencyProbe::Begin() {
+        if (!IsEnabled()) {
+            return;
+        }
+        STrace& trace = tTrace;
+        trace.stamps[eStageSocketRead] = tLastRead ? tLastRead : Richy::CTscClock::Now();
+        trace.marked = 1u << eStageSocketRead;
+        trace.active = true;
+    }
+
+    void LatencyProbe::MarkNow(ELatencyStage stage) {
+        STrace& trace = tTrace;
+        // Hors trace (autre thread, requête sans message à l'origine) ou déjà franchie : ignorée
+        if (!trace.active || (trace.marked & (1u << stage))) {
+            return;
+        }
+        trace.stamps[stage] = Richy::CTscClock::Now();
+        trace.marked |= 1u << stage;
+    }
+
+    void LatencyProbe::End() {
+        STrace& trace = tTrace;
+        if (!trace.active) {
+            return;
+        }
+        trace.active = false;
+
+        // Écart avec l'étape franchie précédente ; les étapes sautées ne comptent pas
+        uint64_t previous = trace.stamps[eStageSocketRead];
+        for (int stage = eStageSocketRead + 1; stage < eStageCount; ++stage) {
+            if (trace.marked & (1u << stage)) {
+                uint64_t stamp = std::max(trace.stamps[stage], previous);
+                Record(sHistograms[stage], stamp - previous);
+                previous = stamp;
+            }
+        }
+        if (trace.marked & (1u << eStageWrite)) {
+            Record(sHistograms[eStageCount], previous - trace.stamps[eStageSocketRead]);
+        }
+    }
+
+    static StageStats Summarize(const SHistogram& histogram) {
+        uint64_t counts[BUCKETS];
+        StageStats stats;
+        for (int i = 0; i < BUCKETS; ++i) {
+            counts[i] = histogram.buckets[i].load(std::memory_order_relaxed);
+            stats.count += counts[i];
+        }
+        stats.max = histogram.max.load(std::memory_order_relaxed);
+        if (stats.count == 0) {
+            return stats;
+        }
+
+        const double quantiles[] = {0.50, 0.90, 0.99, 0.999};
+        uint64_t* targets[] = {&stats.p50, &stats.p90, &stats.p99, &stats.p999};
+        uint64_t seen = 0;
+        int next = 0;
+        for (int i = 0; i < BUCKETS && next < 4; ++i) {
+            seen += counts[i];
+            while (next < 4 && (double) seen >= quantiles[next] * (double) stats.count) {
+                *targets[next++] = std::min(BucketValue(i), stats.max);
+            }
+        }
+        return stats;
+    }
+
+    StageStats LatencyProbe::GetStats(ELatencyStage stage) {
+        return Summarize(sHistograms[stage]);
+    }
+
+    StageStats LatencyProbe::GetTotal() {
+        return Summarize(sHistograms[eStageCount]);
+    }
+
+    void LatencyProbe::Reset() {
+        for (auto& histogram : sHistograms) {
+            for (auto& bucket : histogram.buckets) {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+            histogram.max.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    const char* LatencyProbe::ToString(ELatencyStage stage) {
+        switch (stage) {
+            case eStageSocketRead:  return "socket_read";
+            case eStageDecode:      return "decode";
+            case eStageDispatch:    return "dispatch";
+            case eStageDecision:    return "decision";
+            case eStageBuild:       return "build";
+            case eStageSign:        return "sign";
+            case eStageWrite:       return "write";
+            default:                return "unknown";
+        }
+    }
+
+} // API
@@ -0,0 +1,92 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#ifndef LATENCYPROBE_H
+#define LATENCYPROBE_H
+
+#include <atomic>
+#include <cstdint>
+#include "../core/TscClock.h"
+
+namespace API {
+
+    // Étapes du chemin tick-to-trade, dans l'ordre où elles sont franchies
+    enum ELatencyStage : uint8_t {
+        eStageSocketRead = 0,   // octets lus sur la socket du flux
+        eStageDecode,           // message JSON décodé
+        eStageDispatch,         // entrée dans mTickerCallback / mOrderBookCallback
+        eStageDecision,         // décision de la stratégie (marquée par elle)
+        eStageBuild,            // requête d'ordre construite (contrôle pré-trade compris)
+        eStageSign,             // nonce et signature HMAC
+        eStageWrite,            // requête écrite dans la socket HTTP
+        eStageCount
+    };
+
+    // Distribution en ns ; "total" : de la lecture socket à l'écriture de l'ordre
+    struct StageStats {
+        uint64_t count = 0;
+        uint64_t p50 = 0;
+        uint64_t p90 = 0;
+        uint64_t p99 = 0;
+        uint64_t p999 = 0;
+        uint64_t max = 0;
+    };
+
+    /*
+     * Horodatage TSC de chaque étape d'un message du flux, sur le thread
+     * du flux : la lecture socket ouvre une trace, chaque étape y pose son
+     * horodatage, la fin du traitement du message enregistre les écarts
+     * entre étapes successives dans des histogrammes log-linéaires (8
+     * sous-cases par puissance de 2, soit ±6 %).
+     *
+     *     LatencyProbe::Enable(true);
+     *     api.SetTickerCallback([&](const TickerData& ticker) {
+     *         LatencyProbe::Mark(eStageDecision);
+     *         api.PlaceLimitOrder(...);
+     *     });
+     *     StageStats build = LatencyProbe::GetStats(eStageBuild);
+     *
+     * Désactivée, une étape coûte une lecture atomique. Une étape franchie
+     * sur un autre thread que celui du flux (stratégie asynchrone) n'entre
+     * pas dans la trace.
+     */
+    class LatencyProbe {
+        public:
+            static void Enable(bool enabled);
+            static bool IsEnabled() {
+                return sEnabled.load(std::memory_order_relaxed);
+            }
+
+            // Lecture socket (WebSocketClient) : horodatage gardé pour le prochain message
+            static void NoteRead() {
+                if (IsEnabled()) {
+                    tLastRead = Richy::CTscClock::Now();
+                }
+            }
+
+            // Message complet reçu : ouvre la trace à l'horodatage de sa dernière lecture
+            static void Begin();
+            static void Mark(ELatencyStage stage) {
+                if (IsEnabled()) {
+                    MarkNow(stage);
+                }
+            }
+            // Fin du traitement du message : écarts enregistrés, trace close
+            static void End();
+
+            static StageStats GetStats(ELatencyStage stage);
+            static StageStats GetTotal();
+            static void Reset();
+            static const char* ToString(ELatencyStage stage);
+
+        private:
+            static void MarkNow(ELatencyStage stage);
+
+            static std::atomic<bool> sEnabled;
+            static thread_local uint64_t tLastRead;
+    };
+
+} // API
+
+#endif //LATENCYPROBE_H
@@ -0,0 +1,391 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#include "MarketBus.h"
+#include "../core/Metrics.h"
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#ifndef MAP_POPULATE
+#define MAP_POPULATE 0
+#endif
+
+namespace API {
+
+    static int64_t NowNs() {
+        return (int64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()
+        ).count();
+    }
+
+    static void CopyName(char* destination, size_t size, const std::string& source) {
+        size_t length = std::min(source.size(), size - 1);
+        std::memcpy(destination, source.data(), length);
+        destination[length] = '\0';
+    }
+
+    // ===== PUBLICATION =====
+
+    MarketPublisher::MarketPublisher() :
+        mHeader(NULL),
+        mPairs(NULL),
+        mRing(NULL),
+        mNext(0) {
+    }
+
+    MarketPublisher::~MarketPublisher() {
+        Close();
+    }
+
+    bool MarketPublisher::Open(const std::string& name) {
+        if (mHeader) {
+            return true;
+        }
+
+        // Nouveau segment : un lecteur encore attaché à l'ancien garde une projection valide
+        // (tronquer un segment projeté lui enverrait SIGBUS)
+        shm_unlink(name.c_str());
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0) {
+            mLastError = "Cannot create market segment " + name + ": " + std::strerror(errno);
+            return false;
+        }
+
+        void* memory = MAP_FAILED;
+        if (ftruncate(fd, (off_t) BUS_SEGMENT_SIZE) == 0) {
+            // Anneaux pris d'avance : la première publication ne fait pas de défaut de page
+            memory = mmap(NULL, BUS_SEGMENT_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, 0);
+        }
+        close(fd);
+        if (memory == MAP_FAILED) {
+            mLastError = "Cannot map market segment " + name + ": " + std::strerror(errno);
+            shm_unlink(name.c_str());
+            return false;
+        }
+
+        mName = name;
+        mHeader = (BusHeader*) memory;
+        mPairs = (BusPairSlot*) ((char*) memory + sizeof(BusHeader));
+        mRing = (BusRingSlot*) ((char*) mPairs + BUS_MAX_PAIRS * sizeof(BusPairSlot));
+        mNext = 0;
+        mPairIndex.clear();
+
+        mHeader->version = BUS_VERSION;
+        mHeader->pid = (int32_t) getpid();
+        mHeader->ringSize = (uint32_t) BUS_RING_SIZE;
+        mHeader->maxPairs = (uint32_t) BUS_MAX_PAIRS;
+        mHeader->bookDepth = (uint32_t) BUS_BOOK_DEPTH;
+        // Signature écrite en dernier : un lecteur ne s'attache qu'à un en-tête complet
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(mHeader->magic, BUS_MAGIC, sizeof(BUS_MAGIC));
+        return true;
+    }
+
+    void MarketPublisher::Close() {
+        if (!mHeader) {
+            return;
+        }
+        munmap(mHeader, BUS_SEGMENT_SIZE);
+        shm_unlink(mName.c_str());
+        mHeader = NULL;
+        mPairs = NULL;
+        mRing = NULL;
+    }
+
+    bool MarketPublisher::IsOpen() const {
+        return mHeader != NULL;
+    }
+
+    unsigned long MarketPublisher::GetPublished() const {
+        return (unsigned long) mNext;
+    }
+
+    const std::string& MarketPublisher::GetLastError() const {
+        return mLastError;
+    }
+
+    int MarketPublisher::PairIndex(const std::string& pair) {
+        auto it = mPairIndex.find(pair);
+        if (it != mPairIndex.end()) {
+            return it->second;
+        }
+
+        uint32_t count = mHeader->pairCount.load(std::memory_order_relaxed);
+        if (count >= BUS_MAX_PAIRS) {
+            mLastError = "Market bus pair table full, " + pair + " not published";
+            return -1;
+        }
+
+        // Nom écrit avant la publication du compteur
+        CopyName(mPairs[count].name, BUS_PAIR_NAME, pair);
+        mHeader->pairCount.store(count + 1, std::memory_order_release);
+        mPairIndex[pair] = (int) count;
+        return (int) count;
+    }
+
+    MarketEvent& MarketPublisher::Begin(EMarketEvent type, int pair) {
+        BusRingSlot& slot = mRing[mNext & (BUS_RING_SIZE - 1)];
+        slot.stamp.store(2 * mNext + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        MarketEvent& event = slot.event;
+        std::memset(&event, 0, sizeof(event));
+        event.sequence = mNext;
+        event.timestamp = NowNs();
+        event.type = type;
+        event.pair = (uint8_t) pair;
+        return event;
+    }
+
+    void MarketPublisher::Commit() {
+        BusRingSlot& slot = mRing[mNext & (BUS_RING_SIZE - 1)];
+        slot.stamp.store(2 * mNext + 2, std::memory_order_release);
+        mNext++;
+        mHeader->written.store(mNext, std::memory_order_release);
+
+        static Richy::CCounter published = Richy::CMetrics::Counter("richy_bus_events_total");
+        published.Add();
+    }
+
+    BusPairSlot& MarketPublisher::BeginTop(int pair) {
+        BusPairSlot& slot = mPairs[pair];
+        slot.sequence.store(slot.sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        return slot;
+    }
+
+    void MarketPublisher::CommitTop(int pair, int64_t timestamp) {
+        BusPairSlot& slot = mPairs[pair];
+        slot.top.timestamp = timestamp;
+        slot.sequence.store(slot.sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    void MarketPublisher::PublishTicker(const TickerData& ticker) {
+        int pair = mHeader ? PairIndex(ticker.pair) : -1;
+        if (pair < 0) {
+            return;
+        }
+
+        MarketEvent& event = Begin(eMarketTicker, pair);
+        event.bid = ticker.bid;
+        event.ask = ticker.ask;
+        event.price = ticker.last;
+        event.volume = ticker.volume;
+        Commit();
+
+        BusPairSlot& slot = BeginTop(pair);
+        slot.top.bid = ticker.bid;
+        slot.top.ask = ticker.ask;
+        slot.top.last = ticker.last;
+        CommitTop(pair, event.timestamp);
+    }
+
+    void MarketPublisher::PublishTrade(const Trade& trade) {
+        int pair = mHeader ? PairIndex(trade.pair) : -1;
+        if (pair < 0) {
+            return;
+        }
+
+        MarketEvent& event = Begin(eMarketTrade, pair);
+        event.price = trade.price;
+        event.volume = trade.volume;
+        event.side = trade.type == "buy" ? 'b' : 's';
+        Commit();
+
+        BusPairSlot& slot = BeginTop(pair);
+        slot.top.last = trade.price;
+        CommitTop(pair, event.timestamp);
+    }
+
+    void MarketPublisher::PublishBook(const OrderBook& book) {
+        int pair = mHeader ? PairIndex(book.pair) : -1;
+        if (pair < 0) {
+            return;
+        }
+
+        // Meilleurs niveaux en tête (asks croissants, bids décroissants)
+        MarketEvent& event = Begin(eMarketBook, pair);
+        event.askCount = (uint8_t) std::min(book.asks.size(), BUS_BOOK_DEPTH);
+        event.bidCount = (uint8_t) std::min(book.bids.size(), BUS_BOOK_DEPTH);
+        for (size_t i = 0; i < event.askCount; ++i) {
+            event.asks[i] = {book.asks[i].price, book.asks[i].volume};
+        }
+        for (size_t i = 0; i < event.bidCount; ++i) {
+            event.bids[i] = {book.bids[i].price, book.bids[i].volume};
+        }
+        Commit();
+
+        if (book.asks.empty() || book.bids.empty()) {
+            return;
+        }
+        BusPairSlot& slot = BeginTop(pair);
+        slot.top.ask = book.asks[0].price;
+        slot.top.askVolume = book.asks[0].volume;
+        slot.top.bid = book.bids[0].price;
+        slot.top.bidVolume = book.bids[0].volume;
+        CommitTop(pair, event.timestamp);
+    }
+
+    void MarketPublisher::PublishGap(const FeedGap& gap) {
+        int pair = mHeader ? PairIndex(gap.pair) : -1;
+        if (pair < 0) {
+            return;
+        }
+
+        MarketEvent& event = Begin(eMarketGap, pair);
+        CopyName(event.channel, sizeof(event.channel), gap.channel);
+        CopyName(event.reason, sizeof(event.reason), gap.reason);
+        Commit();
+    }
+
+    // ===== ABONNEMENT =====
+
+    MarketSubscriber::MarketSubscriber() :
+        mHeader(NULL),
+        mPairs(NULL),
+        mRing(NULL),
+        mNext(0),
+        mLost(0) {
+    }
+
+    MarketSubscriber::~MarketSubscriber() {
+        Close();
+    }
+
+    bool MarketSubscriber::Open(const std::string& name) {
+        Close();
+
+        int fd = shm_open(name.c_str(), O_RDONLY, 0);
+        if (fd < 0) {
+            mLastError = "No market segment " + name + " (is the publisher running?)";
+            return false;
+        }
+
+        struct stat info;
+        void* memory = MAP_FAILED;
+        if (fstat(fd, &info) == 0 && (size_t) info.st_size >= BUS_SEGMENT_SIZE) {
+            memory = mmap(NULL, BUS_SEGMENT_SIZE, PROT_READ, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+        if (memory == MAP_FAILED) {
+            mLastError = "Cannot map market segment " + name;
+            return false;
+        }
+
+        mHeader = (const BusHeader*) memory;
+        mPairs = (const BusPairSlot*) ((const char*) memory + sizeof(BusHeader));
+        mRing = (const BusRingSlot*) ((const char*) mPairs + BUS_MAX_PAIRS * sizeof(BusPairSlot));
+        if (std::memcmp(mHeader->magic, BUS_MAGIC, sizeof(BUS_MAGIC)) != 0 ||
+            mHeader->version / 100 != BUS_VERSION / 100 || mHeader->ringSize != BUS_RING_SIZE) {
+            mLastError = "Unsupported market segment " + name;
+            Close();
+            return false;
+        }
+
+        mNext = mHeader->written.load(std::memory_order_acquire);
+        mLost = 0;
+        return true;
+    }
+
+    void MarketSubscriber::Close() {
+        if (mHeader) {
+            munmap((void*) mHeader, BUS_SEGMENT_SIZE);
+        }
+        mHeader = NULL;
+        mPairs = NULL;
+        mRing = NULL;
+    }
+
+    bool MarketSubscriber::Poll(MarketEvent& event) {
+        if (!mHeader) {
+            return false;
+        }
+
+        for (;;) {
+            const BusRingSlot& slot = mRing[mNext & (BUS_RING_SIZE - 1)];
+            uint64_t expected = 2 * mNext + 2;
+            uint64_t stamp = slot.stamp.load(std::memory_order_acquire);
+
+            if (stamp == expected) {
+                std::memcpy(&event, &slot.event, sizeof(event));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.stamp.load(std::memory_order_relaxed) == expected) {
+                    mNext++;
+                    return true;
+                }
+            } else if (stamp < expected) {
+                return false;
+            }
+
+            // Écrasé par l'éditeur : reprise sur le direct, les meilleurs prix restent lisibles
+            uint64_t written = mHeader->written.load(std::memory_order_acquire);
+            mLost += (unsigned long) (written - mNext);
+            mNext = written;
+        }
+    }
+
+    int MarketSubscriber::FindPair(const std::string& pair) const {
+        if (!mHeader) {
+            return -1;
+        }
+        uint32_t count = std::min<uint32_t>(mHeader->pairCount.load(std::memory_order_acquire), (uint32_t) BUS_MAX_PAIRS);
+        for (uint32_t i = 0; i < count; ++i) {
+            if (std::strncmp(mPairs[i].name, pair.c_str(), BUS_PAIR_NAME) == 0) {
+                return (int) i;
+            }
+        }
+        return -1;
+    }
+
+    std::string MarketSubscriber::GetPairName(int index) const {
+        if (!mHeader || index < 0 || (uint32_t) index >= mHeader->pairCount.load(std::memory_order_acquire)) {
+            return "";
+        }
+        return std::string(mPairs[index].name, strnlen(mPairs[index].name, BUS_PAIR_NAME));
+    }
+
+    bool MarketSubscriber::ReadTop(int index, TopOfBook& top) const {
+        if (!mHeader || index < 0 || (uint32_t) index >= mHeader->pairCount.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        // L'écriture ne dure que quelques ns : quelques essais suffisent
+        const BusPairSlot& slot = mPairs[index];
+        for (int attempt = 0; attempt < 1000; ++attempt) {
+            uint64_t before = slot.sequence.load(std::memory_order_acquire);
+            if (before & 1) {
+                continue;
+            }
+            std::memcpy(&top, &slot.top, sizeof(top));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == before) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    unsigned long MarketSubscriber::GetLost() const {
+        return mLost;
+    }
+
+    int MarketSubscriber::GetPublisherPid() const {
+        return mHeader ? mHeader->pid : 0;
+    }
+
+    bool MarketSubscriber::IsPublisherAlive() const {
+        return mHeader && mHeader->pid > 0 && (kill(mHeader->pid, 0) == 0 || errno == EPERM);
+    }
+
+    const std::string& MarketSubscriber::GetLastError() const {
+        return mLastError;
+    }
+
+} // API
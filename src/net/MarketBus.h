@@ -0,0 +1,176 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#ifndef MARKETBUS_H
+#define MARKETBUS_H
+
+#include <string>
+#include <map>
+#include <atomic>
+#include <cstdint>
+#include "KrakenApi.h"
+
+namespace API {
+
+    // ===== FORMAT DU SEGMENT =====
+
+    static const char BUS_MAGIC[4] = {'R', 'M', 'K', 'T'};
+    static const uint32_t BUS_VERSION = 100;
+    static const size_t BUS_RING_SIZE = 16384;      // événements (puissance de 2)
+    static const size_t BUS_MAX_PAIRS = 64;
+    static const size_t BUS_PAIR_NAME = 16;
+    static const size_t BUS_BOOK_DEPTH = 10;        // niveaux par côté dans un événement carnet
+    static const size_t BUS_REASON = 16;
+
+    enum EMarketEvent : uint8_t {
+        eMarketTicker = 1,
+        eMarketTrade = 2,
+        eMarketBook = 3,
+        eMarketGap = 4,
+    };
+
+    struct MarketLevel {
+        double price;
+        double volume;
+    };
+
+    // Événement normalisé, de taille fixe ; seuls les champs du type sont renseignés
+    struct MarketEvent {
+        uint64_t sequence;
+        int64_t timestamp;          // ns depuis l'epoch, à la publication
+        uint8_t type;               // EMarketEvent
+        uint8_t pair;               // index dans la table des paires
+        uint8_t askCount;           // carnet : niveaux renseignés
+        uint8_t bidCount;
+        char side;                  // trade : 'b' ou 's'
+        double bid;                 // ticker
+        double ask;                 // ticker
+        double price;               // ticker : dernier prix ; trade : prix
+        double volume;              // ticker : volume 24h ; trade : quantité
+        MarketLevel asks[BUS_BOOK_DEPTH];
+        MarketLevel bids[BUS_BOOK_DEPTH];
+        char channel[8];            // gap
+        char reason[BUS_REASON];    // gap
+    };
+
+    // Meilleurs prix d'une paire, toujours à jour (ticker, carnet et trades confondus)
+    struct TopOfBook {
+        double bid;
+        double bidVolume;
+        double ask;
+        double askVolume;
+        double last;
+        int64_t timestamp;          // ns, dernière mise à jour
+    };
+
+    struct alignas(64) BusPairSlot {
+        char name[BUS_PAIR_NAME];
+        std::atomic<uint64_t> sequence;     // seqlock : impair pendant l'écriture
+        TopOfBook top;
+    };
+
+    struct alignas(64) BusRingSlot {
+        std::atomic<uint64_t> stamp;        // 2n+1 pendant l'écriture de l'événement n, 2n+2 ensuite
+        MarketEvent event;
+    };
+
+    struct alignas(64) BusHeader {
+        char magic[4];
+        uint32_t version;
+        int32_t pid;
+        uint32_t ringSize;
+        uint32_t maxPairs;
+        uint32_t bookDepth;
+        std::atomic<uint32_t> pairCount;
+        alignas(64) std::atomic<uint64_t> written;     // prochain numéro de séquence
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "Market bus needs lock-free 64-bit atomics");
+    static_assert((BUS_RING_SIZE & (BUS_RING_SIZE - 1)) == 0, "Ring size must be a power of two");
+
+    static const size_t BUS_SEGMENT_SIZE = sizeof(BusHeader) + BUS_MAX_PAIRS * sizeof(BusPairSlot) +
+                                           BUS_RING_SIZE * sizeof(BusRingSlot);
+
+    /*
+     * Côté publication : un seul processus possède les flux Kraken et
+     * diffuse les événements normalisés dans /dev/shm. Un seul thread
+     * écrivain (celui du flux) ; les lecteurs ne freinent jamais l'écriture,
+     * un lecteur trop lent perd des événements mais garde les meilleurs prix.
+     */
+    class MarketPublisher {
+        public:
+            MarketPublisher();
+            ~MarketPublisher();
+
+            bool Open(const std::string& name = MARKET_SEGMENT);
+            // Retire le segment ; les lecteurs déjà attachés gardent leur projection
+            void Close();
+            bool IsOpen() const;
+
+            void PublishTicker(const TickerData& ticker);
+            void PublishTrade(const Trade& trade);
+            void PublishBook(const OrderBook& book);
+            void PublishGap(const FeedGap& gap);
+
+            unsigned long GetPublished() const;
+            const std::string& GetLastError() const;
+
+        private:
+            int PairIndex(const std::string& pair);
+            MarketEvent& Begin(EMarketEvent type, int pair);
+            void Commit();
+            BusPairSlot& BeginTop(int pair);
+            void CommitTop(int pair, int64_t timestamp);
+
+            std::string mName;
+            BusHeader* mHeader;
+            BusPairSlot* mPairs;
+            BusRingSlot* mRing;
+            uint64_t mNext;
+            std::map<std::string, int> mPairIndex;
+            std::string mLastError;
+    };
+
+    /*
+     * Côté abonnement : lecture directe du segment projeté, sans appel
+     * système ni désérialisation. Chaque événement est validé par son
+     * tampon de séquence ; la seule copie est celle vers l'événement de
+     * l'appelant, nécessaire pour détecter un écrasement en cours de lecture.
+     */
+    class MarketSubscriber {
+        public:
+            MarketSubscriber();
+            ~MarketSubscriber();
+
+            // La lecture commence aux événements publiés après l'ouverture
+            bool Open(const std::string& name = MARKET_SEGMENT);
+            void Close();
+
+            // true si un événement a été lu
+            bool Poll(MarketEvent& event);
+
+            // -1 si la paire n'est pas (encore) publiée
+            int FindPair(const std::string& pair) const;
+            std::string GetPairName(int index) const;
+            bool ReadTop(int index, TopOfBook& top) const;
+
+            // Événements écrasés avant d'avoir été lus
+            unsigned long GetLost() const;
+            int GetPublisherPid() const;
+            // Un éditeur redémarré crée un nouveau segment : rouvrir quand celui-ci meurt
+            bool IsPublisherAlive() const;
+            const std::string& GetLastError() const;
+
+        private:
+            const BusHeader* mHeader;
+            const BusPairSlot* mPairs;
+            const BusRingSlot* mRing;
+            uint64_t mNext;
+            unsigned long mLost;
+            std::string mLastError;
+    };
+
+} // API
+
+#endif //MARKETBUS_H
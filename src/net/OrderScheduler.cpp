@@ -0,0 +1,252 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#include "OrderScheduler.h"
+#include <atomic>
+#include <algorithm>
+#include "../core/Logger.h"
+
+namespace API {
+
+    // État partagé entre le planificateur, les rappels de la roue et les appels en cours
+    struct OrderScheduler::SSchedule {
+        std::mutex mutex;
+        TimerId timer = 0;
+        std::string orderId;                // recotation : ordre en place
+        int remaining = 0;                  // TWAP : tranches restantes
+        std::function<double()> pricer;
+        std::atomic<bool> busy{false};      // recotation en cours sur le pool bloquant
+        std::atomic<bool> done{false};      // posé sous mutex, avec la reprise de orderId
+    };
+
+    OrderScheduler::OrderScheduler(KrakenApi& api, Richy::CExecutor& executor) :
+        mApi(api),
+        mExecutor(executor) {
+    }
+
+    OrderScheduler::~OrderScheduler() {
+        std::map<TimerId, std::shared_ptr<SSchedule>> schedules;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            schedules.swap(mSchedules);
+        }
+        for (const auto& entry : schedules) {
+            mExecutor.Cancel(entry.first);
+        }
+
+        // Les cotations en place sont retirées avec le planificateur
+        KrakenApi* api = &mApi;
+        for (const auto& entry : schedules) {
+            std::string orderId;
+            {
+                std::lock_guard<std::mutex> lock(entry.second->mutex);
+                entry.second->done = true;
+                orderId.swap(entry.second->orderId);
+            }
+            if (!orderId.empty()) {
+                mExecutor.PostBlocking([api, orderId]() {
+                    api->CancelOrder(orderId);
+                });
+            }
+        }
+    }
+
+    // ===== PROGRAMMATIONS =====
+
+    OrderScheduler::TimerId OrderScheduler::CancelAfter(const std::string& orderId, long milliseconds) {
+        KrakenApi* api = &mApi;
+        Richy::CExecutor* executor = &mExecutor;
+        std::shared_ptr<SSchedule> schedule(new SSchedule());
+
+        TimerId id = mExecutor.After(milliseconds, [api, executor, orderId, schedule]() {
+            executor->PostBlocking([api, orderId, schedule]() {
+                if (!api->CancelOrder(orderId)) {
+                    LOG_WARNING("Scheduled cancel of {} failed: {}", orderId, api->GetLastError());
+                }
+                schedule->done = true;
+            });
+        });
+        return Register(id, schedule);
+    }
+
+    OrderScheduler::TimerId OrderScheduler::PlaceLimitAfter(const std::string& pair, const std::string& type,
+                                                            double volume, double price, long delayMs,
+                                                            long lifetimeMs) {
+        KrakenApi* api = &mApi;
+        Richy::CExecutor* executor = &mExecutor;
+        std::shared_ptr<SSchedule> schedule(new SSchedule());
+
+        TimerId id = mExecutor.After(delayMs, [=]() {
+            executor->PostBlocking([=]() {
+                std::string orderId = api->PlaceLimitOrder(pair, type, volume, price);
+                schedule->done = true;
+                if (orderId.empty()) {
+                    LOG_WARNING("Scheduled {} {} {} @ {} failed: {}", type, volume, pair, price, api->GetLastError());
+                    return;
+                }
+                if (lifetimeMs > 0) {
+                    executor->After(lifetimeMs, [api, executor, orderId]() {
+                        executor->PostBlocking([api, orderId]() {
+                            api->CancelOrder(orderId);
+                        });
+                    });
+                }
+            });
+        });
+        return Register(id, schedule);
+    }
+
+    OrderScheduler::TimerId OrderScheduler::Requote(const std::string& pair, const std::string& type, double volume,
+                                                    long intervalMs, std::function<double()> pricer) {
+        KrakenApi* api = &mApi;
+        Richy::CExecutor* executor = &mExecutor;
+        std::shared_ptr<SSchedule> schedule(new SSchedule());
+        schedule->pricer = pricer;
+
+        auto requote = [=]() {
+            // Un tour encore en cours (réseau lent) : celui-ci est sauté
+            if (schedule->done || schedule->busy.exchange(true)) {
+                return;
+            }
+            executor->PostBlocking([=]() {
+                std::string previous;
+                {
+                    std::lock_guard<std::mutex> lock(schedule->mutex);
+                    previous.swap(schedule->orderId);
+                }
+                if (!previous.empty()) {
+                    api->CancelOrder(previous);
+                }
+
+                double price = schedule->done ? 0.0 : schedule->pricer();
+                if (price > 0.0) {
+                    std::string orderId = api->PlaceLimitOrder(pair, type, volume, price);
+                    if (orderId.empty()) {
+                        LOG_WARNING("Requote {} {} {} @ {} failed: {}", type, volume, pair, price, api->GetLastError());
+                    } else {
+                        // Vérification et mise en place d'un seul tenant : Cancel pose done sous le même mutex
+                        bool stopped;
+                        {
+                            std::lock_guard<std::mutex> lock(schedule->mutex);
+                            stopped = schedule->done;
+                            if (!stopped) {
+                                schedule->orderId = orderId;
+                            }
+                        }
+                        if (stopped) {
+                            // Arrêtée pendant l'envoi : la cotation ne doit pas rester
+                            api->CancelOrder(orderId);
+                        }
+                    }
+                }
+                schedule->busy = false;
+            });
+        };
+
+        // Première cotation tout de suite, puis à chaque intervalle
+        requote();
+        TimerId id = mExecutor.Every(intervalMs, requote);
+        return Register(id, schedule);
+    }
+
+    OrderScheduler::TimerId OrderScheduler::Twap(const std::string& pair, const std::string& type, double volume,
+                                                 int slices, long intervalMs) {
+        KrakenApi* api = &mApi;
+        Richy::CExecutor* executor = &mExecutor;
+        std::shared_ptr<SSchedule> schedule(new SSchedule());
+        slices = std::max(1, slices);
+        schedule->remaining = slices;
+        double slice = volume / slices;
+
+        auto next = [=]() {
+            int remaining;
+            {
+                std::lock_guard<std::mutex> lock(schedule->mutex);
+                if (schedule->done || schedule->remaining <= 0) {
+                    return;
+                }
+                remaining = --schedule->remaining;
+                if (remaining == 0) {
+                    schedule->done = true;
+                    executor->Cancel(schedule->timer);
+                }
+            }
+            // La dernière tranche absorbe l'arrondi
+            double amount = remaining == 0 ? volume - slice * (slices - 1) : slice;
+            executor->PostBlocking([=]() {
+                if (api->PlaceMarketOrder(pair, type, amount).empty()) {
+                    LOG_WARNING("TWAP slice {} {} {} failed: {}", type, amount, pair, api->GetLastError());
+                }
+            });
+        };
+
+        next();
+        if (slices == 1) {
+            return Register(0, schedule);
+        }
+        std::lock_guard<std::mutex> lock(schedule->mutex);
+        schedule->timer = mExecutor.Every(intervalMs, next);
+        return Register(schedule->timer, schedule);
+    }
+
+    // ===== SUIVI =====
+
+    OrderScheduler::TimerId OrderScheduler::Register(TimerId id, std::shared_ptr<SSchedule> schedule) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        // Les programmations terminées sont oubliées au passage
+        for (auto it = mSchedules.begin(); it != mSchedules.end();) {
+            if (it->second->done) {
+                it = mSchedules.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        if (id != 0) {
+            mSchedules[id] = schedule;
+        }
+        return id;
+    }
+
+    bool OrderScheduler::Cancel(TimerId id) {
+        std::shared_ptr<SSchedule> schedule;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            auto it = mSchedules.find(id);
+            if (it == mSchedules.end()) {
+                return false;
+            }
+            schedule = it->second;
+            mSchedules.erase(it);
+        }
+
+        bool stopped = mExecutor.Cancel(id);
+        std::string orderId;
+        {
+            std::lock_guard<std::mutex> lock(schedule->mutex);
+            if (schedule->done.exchange(true)) {
+                return false;
+            }
+            orderId.swap(schedule->orderId);
+        }
+        if (!orderId.empty()) {
+            KrakenApi* api = &mApi;
+            mExecutor.PostBlocking([api, orderId]() {
+                api->CancelOrder(orderId);
+            });
+        }
+        return stopped || !orderId.empty();
+    }
+
+    size_t OrderScheduler::GetScheduled() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        size_t count = 0;
+        for (const auto& entry : mSchedules) {
+            if (!entry.second->done) {
+                count++;
+            }
+        }
+        return count;
+    }
+
+} // API
@@ -0,0 +1,74 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#ifndef ORDERSCHEDULER_H
+#define ORDERSCHEDULER_H
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <functional>
+#include "KrakenApi.h"
+#include "../core/Executor.h"
+
+namespace API {
+
+    /*
+     * Actions d'ordre programmées : expirations, ordres différés,
+     * recotations périodiques et tranches TWAP.
+     *
+     * Les échéances vivent dans la roue de minuteries de l'exécuteur ; à
+     * l'échéance, l'appel REST part sur son pool bloquant. Aucune action
+     * n'occupe de thread en attendant son heure.
+     *
+     *     OrderScheduler scheduler(api, executor);
+     *     std::string id = api.PlaceLimitOrder("XBTUSD", "buy", 0.01, 60000.0);
+     *     scheduler.CancelAfter(id, 5000);
+     *
+     * Les échecs sont journalisés ; l'exécuteur et l'api doivent survivre au
+     * planificateur.
+     */
+    class OrderScheduler {
+        public:
+            typedef Richy::CExecutor::TimerId TimerId;
+
+            OrderScheduler(KrakenApi& api, Richy::CExecutor& executor);
+            ~OrderScheduler();
+
+            // Annulation d'un ordre après un délai
+            TimerId CancelAfter(const std::string& orderId, long milliseconds);
+
+            // Ordre limite différé, annulé au bout de lifetimeMs s'il est encore ouvert (0 = jamais)
+            TimerId PlaceLimitAfter(const std::string& pair, const std::string& type, double volume,
+                                    double price, long delayMs, long lifetimeMs = 0);
+
+            // Toutes les intervalMs, l'ordre courant est annulé et remplacé au prix donné par
+            // pricer (appelé sur le pool bloquant ; <= 0 : pas d'ordre pour ce tour)
+            TimerId Requote(const std::string& pair, const std::string& type, double volume,
+                            long intervalMs, std::function<double()> pricer);
+
+            // Volume découpé en "slices" ordres au marché, un toutes les intervalMs
+            TimerId Twap(const std::string& pair, const std::string& type, double volume,
+                         int slices, long intervalMs);
+
+            // Arrête une programmation ; une recotation annule aussi son ordre en place
+            bool Cancel(TimerId id);
+            size_t GetScheduled() const;
+
+        private:
+            struct SSchedule;
+
+            TimerId Register(TimerId id, std::shared_ptr<SSchedule> schedule);
+
+            KrakenApi& mApi;
+            Richy::CExecutor& mExecutor;
+
+            mutable std::mutex mMutex;
+            std::map<TimerId, std::shared_ptr<SSchedule>> mSchedules;
+    };
+
+} // API
+
+#endif //ORDERSCHEDULER_H
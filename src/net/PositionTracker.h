@@ -0,0 +1,37 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#ifndef POSITIONTRACKER_H
+#define POSITIONTRACKER_H
+
+#include <string>
+#include <vector>
+#include "KrakenApi.h"
+
+namespace API {
+
+    /*
+     * Positions et PnL alimentés par KrakenApi.
+     *
+     * Chaque ticker du flux réévalue la paire, chaque exécution observée
+     * d'un ordre suivi (une seule fois, même avec plusieurs clés) met à
+     * jour la position. Implémenté hors de net (moteur de positions de
+     * trading) : net ne dépend que de cette interface. Appelé depuis le
+     * thread du flux et les threads des requêtes.
+     */
+    class PositionTracker {
+        public:
+            virtual ~PositionTracker() {}
+
+            virtual void OnTicker(const TickerData& ticker) = 0;
+            // type = "buy" ou "sell" ; volume et prix moyen de la nouvelle exécution, frais en devise de cotation
+            virtual void OnFill(const std::string& pair, const std::string& type, double volume, double price,
+                                double fee) = 0;
+            // Positions de l'exchange au démarrage (noms de paires des abonnements)
+            virtual void Load(const std::vector<Position>& positions) = 0;
+    };
+
+} // API
+
+#endif //POSITIONTRACKER_H
@@ -0,0 +1,366 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#include "RefDataCache.h"
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace API {
+
+    // Format du fichier : en-tête fixe puis charge utile
+    static const uint32_t CACHE_MAGIC = 0x59484352; // "RCHY"
+    static const uint32_t CACHE_VERSION = 2;
+    // Rafraîchissement en échec : nouvel essai sans attendre un âge maximal complet
+    static const long REFRESH_RETRY_S = 60;
+
+    struct SCacheHeader {
+        uint32_t magic;
+        uint32_t version;
+        int64_t timestamp;
+        uint32_t assetCount;
+        uint32_t pairCount;
+        uint64_t payloadSize;
+        uint64_t checksum;
+    };
+
+    // FNV-1a 64 bits
+    static uint64_t Checksum(const char* data, size_t size) {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= (unsigned char) data[i];
+            hash *= 0x100000001b3ULL;
+        }
+        return hash;
+    }
+
+    // ===== INDEX =====
+
+    void RefData::BuildIndex() {
+        aliases.clear();
+        aliases.reserve(pairs.size() * 3);
+        for (const auto& entry : pairs) {
+            aliases[entry.first] = entry.first;
+            if (!entry.second.altname.empty()) {
+                aliases.emplace(entry.second.altname, entry.first);
+            }
+            if (!entry.second.wsname.empty()) {
+                aliases.emplace(entry.second.wsname, entry.first);
+            }
+        }
+    }
+
+    const PairInfo* RefData::Find(const std::string& pair) const {
+        auto alias = aliases.find(pair);
+        if (alias == aliases.end()) {
+            return nullptr;
+        }
+        auto it = pairs.find(alias->second);
+        return it != pairs.end() ? &it->second : nullptr;
+    }
+
+    // ===== SÉRIALISATION =====
+
+    static void WriteString(std::string& out, const std::string& value) {
+        uint16_t len = (uint16_t) std::min<size_t>(value.size(), 0xFFFF);
+        out.append((const char*) &len, sizeof(len));
+        out.append(value.data(), len);
+    }
+
+    template<typename T>
+    static void WriteValue(std::string& out, T value) {
+        out.append((const char*) &value, sizeof(T));
+    }
+
+    class CReader {
+        public:
+            CReader(const char* data, size_t size) : mData(data), mEnd(data + size), mOk(true) {
+            }
+
+            std::string String() {
+                uint16_t len = Value<uint16_t>();
+                if (!mOk || mData + len > mEnd) {
+                    mOk = false;
+                    return "";
+                }
+                std::string value(mData, len);
+                mData += len;
+                return value;
+            }
+
+            template<typename T>
+            T Value() {
+                T value = T();
+                if (mData + sizeof(T) > mEnd) {
+                    mOk = false;
+                    return value;
+                }
+                std::memcpy(&value, mData, sizeof(T));
+                mData += sizeof(T);
+                return value;
+            }
+
+            bool Ok() const {
+                return mOk;
+            }
+
+        private:
+            const char* mData;
+            const char* mEnd;
+            bool mOk;
+    };
+
+    static void WriteTiers(std::string& out, const std::vector<FeeTier>& tiers) {
+        WriteValue<uint16_t>(out, (uint16_t) tiers.size());
+        for (const auto& tier : tiers) {
+            WriteValue<double>(out, tier.volume);
+            WriteValue<double>(out, tier.percent);
+        }
+    }
+
+    static void ReadTiers(CReader& reader, std::vector<FeeTier>& tiers) {
+        uint16_t count = reader.Value<uint16_t>();
+        for (uint16_t i = 0; i < count && reader.Ok(); ++i) {
+            FeeTier tier;
+            tier.volume = reader.Value<double>();
+            tier.percent = reader.Value<double>();
+            tiers.push_back(tier);
+        }
+    }
+
+    // ===== CACHE =====
+
+    RefDataCache::RefDataCache(const std::string& path) :
+        mPath(path),
+        mStopRefresh(false) {
+    }
+
+    RefDataCache::~RefDataCache() {
+        StopRefresh();
+    }
+
+    const std::string& RefDataCache::GetPath() const {
+        return mPath;
+    }
+
+    void RefDataCache::SetPath(const std::string& path) {
+        mPath = path;
+    }
+
+    bool RefDataCache::Load() {
+        int fd = open(mPath.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(SCacheHeader)) {
+            close(fd);
+            return false;
+        }
+
+        size_t size = (size_t) st.st_size;
+        void* map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (map == MAP_FAILED) {
+            return false;
+        }
+
+        const char* base = (const char*) map;
+        SCacheHeader header;
+        std::memcpy(&header, base, sizeof(header));
+
+        const char* payload = base + sizeof(SCacheHeader);
+        bool valid = header.magic == CACHE_MAGIC &&
+                     header.version == CACHE_VERSION &&
+                     header.payloadSize == size - sizeof(SCacheHeader) &&
+                     header.checksum == Checksum(payload, header.payloadSize);
+
+        std::shared_ptr<RefData> data;
+        if (valid) {
+            data = std::make_shared<RefData>();
+            data->timestamp = header.timestamp;
+
+            CReader reader(payload, header.payloadSize);
+            for (uint32_t i = 0; i < header.assetCount && reader.Ok(); ++i) {
+                std::string name = reader.String();
+                data->assets[name] = reader.String();
+            }
+            for (uint32_t i = 0; i < header.pairCount && reader.Ok(); ++i) {
+                PairInfo info;
+                info.name = reader.String();
+                info.altname = reader.String();
+                info.wsname = reader.String();
+                info.base = reader.String();
+                info.quote = reader.String();
+                info.pairDecimals = reader.Value<int32_t>();
+                info.lotDecimals = reader.Value<int32_t>();
+                info.orderMin = reader.Value<double>();
+                info.tickSize = reader.Value<double>();
+                ReadTiers(reader, info.fees);
+                ReadTiers(reader, info.feesMaker);
+                data->pairs[info.name] = info;
+            }
+            valid = reader.Ok();
+        }
+
+        munmap(map, size);
+
+        if (!valid) {
+            return false;
+        }
+        Publish(data);
+        return true;
+    }
+
+    bool RefDataCache::Save(const RefData& data) {
+        std::string payload;
+        for (const auto& asset : data.assets) {
+            WriteString(payload, asset.first);
+            WriteString(payload, asset.second);
+        }
+        for (const auto& pair : data.pairs) {
+            const PairInfo& info = pair.second;
+            WriteString(payload, info.name);
+            WriteString(payload, info.altname);
+            WriteString(payload, info.wsname);
+            WriteString(payload, info.base);
+            WriteString(payload, info.quote);
+            WriteValue<int32_t>(payload, info.pairDecimals);
+            WriteValue<int32_t>(payload, info.lotDecimals);
+            WriteValue<double>(payload, info.orderMin);
+            WriteValue<double>(payload, info.tickSize);
+            WriteTiers(payload, info.fees);
+            WriteTiers(payload, info.feesMaker);
+        }
+
+        SCacheHeader header;
+        header.magic = CACHE_MAGIC;
+        header.version = CACHE_VERSION;
+        header.timestamp = data.timestamp;
+        header.assetCount = (uint32_t) data.assets.size();
+        header.pairCount = (uint32_t) data.pairs.size();
+        header.payloadSize = payload.size();
+        header.checksum = Checksum(payload.data(), payload.size());
+
+        // Écriture dans un fichier temporaire puis renommage atomique
+        std::string tmpPath = mPath + ".tmp";
+        FILE* file = fopen(tmpPath.c_str(), "wb");
+        if (!file) {
+            return false;
+        }
+        bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                  fwrite(payload.data(), 1, payload.size(), file) == payload.size();
+        ok = (fclose(file) == 0) && ok;
+
+        if (!ok || rename(tmpPath.c_str(), mPath.c_str()) != 0) {
+            unlink(tmpPath.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    bool RefDataCache::IsLoaded() const {
+        return Get() != nullptr;
+    }
+
+    bool RefDataCache::IsFresh(long maxAgeSeconds) const {
+        std::shared_ptr<const RefData> data = Get();
+        if (!data) {
+            return false;
+        }
+        long now = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()
+        ).count();
+        return now - data->timestamp <= maxAgeSeconds;
+    }
+
+    bool RefDataCache::Refresh(const Loader& loader) {
+        std::shared_ptr<RefData> data = std::make_shared<RefData>();
+        if (!loader(*data) || data->pairs.empty()) {
+            return false;
+        }
+        data->timestamp = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()
+        ).count();
+
+        Save(*data);
+        Publish(data);
+        return true;
+    }
+
+    void RefDataCache::StartRefresh(const Loader& loader, long maxAgeSeconds) {
+        std::lock_guard<std::mutex> lock(mRefreshMutex);
+        if (mRefreshThread.joinable() || maxAgeSeconds <= 0) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> wait(mWaitMutex);
+            mStopRefresh = false;
+        }
+        mRefreshThread = std::thread(&RefDataCache::RefreshLoop, this, loader, maxAgeSeconds);
+    }
+
+    void RefDataCache::StopRefresh() {
+        {
+            std::lock_guard<std::mutex> lock(mWaitMutex);
+            mStopRefresh = true;
+        }
+        mWakeUp.notify_all();
+        std::lock_guard<std::mutex> lock(mRefreshMutex);
+        if (mRefreshThread.joinable()) {
+            mRefreshThread.join();
+        }
+    }
+
+    void RefDataCache::RefreshLoop(Loader loader, long maxAgeSeconds) {
+        auto stopped = [this]() {
+            return mStopRefresh;
+        };
+        std::unique_lock<std::mutex> lock(mWaitMutex);
+        while (!mStopRefresh) {
+            // Attente jusqu'à péremption de l'instantané courant
+            std::shared_ptr<const RefData> data = Get();
+            long now = std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::system_clock::now().time_since_epoch()
+            ).count();
+            long remaining = data ? data->timestamp + maxAgeSeconds - now : 0;
+            if (remaining > 0) {
+                mWakeUp.wait_for(lock, std::chrono::seconds(remaining), stopped);
+                continue;
+            }
+
+            lock.unlock();
+            bool refreshed = Refresh(loader);
+            lock.lock();
+            if (!refreshed) {
+                mWakeUp.wait_for(lock, std::chrono::seconds(std::min(maxAgeSeconds, REFRESH_RETRY_S)), stopped);
+            }
+        }
+    }
+
+    std::shared_ptr<const RefData> RefDataCache::Get() const {
+        return mData.load(std::memory_order_acquire);
+    }
+
+    void RefDataCache::Publish(std::shared_ptr<RefData> data) {
+        data->BuildIndex();
+        std::shared_ptr<const RefData> snapshot = data;
+        std::lock_guard<std::mutex> lock(mPublishMutex);
+        mData.store(snapshot, std::memory_order_release);
+        if (mPublishHandler) {
+            mPublishHandler();
+        }
+    }
+
+    void RefDataCache::SetPublishHandler(std::function<void()> handler) {
+        mPublishHandler = handler;
+    }
+
+} // API
@@ -0,0 +1,91 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#ifndef REFDATACACHE_H
+#define REFDATACACHE_H
+
+#include <string>
+#include <map>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include "KrakenApi.h"
+
+namespace API {
+
+    // Données de référence publiques (Assets + AssetPairs)
+    struct RefData {
+        long timestamp = 0;
+        std::map<std::string, std::string> assets;   // nom -> altname
+        std::map<std::string, PairInfo> pairs;        // nom -> métadonnées
+
+        // Nom Kraken, altname ou wsname -> nom Kraken ; construit une fois à la publication
+        std::unordered_map<std::string, std::string> aliases;
+
+        void BuildIndex();
+        // nullptr si la paire est inconnue (valide tant que l'instantané l'est)
+        const PairInfo* Find(const std::string& pair) const;
+    };
+
+    /*
+     * Cache disque binaire des données de référence.
+     *
+     * Le fichier (voisin de richy.conf) est projeté en mémoire au démarrage
+     * et décodé en quelques microsecondes, au lieu de télécharger et parser
+     * le JSON de /0/public/Assets et /0/public/AssetPairs. Un thread de fond
+     * le rafraîchit dès qu'il dépasse son âge maximal, au démarrage comme
+     * pendant toute la vie du processus, sans bloquer les lecteurs.
+     *
+     * Les lecteurs obtiennent un instantané immuable, échangé atomiquement.
+     */
+    class RefDataCache {
+        public:
+            typedef std::function<bool(RefData&)> Loader;
+
+            RefDataCache(const std::string& path = CACHE_FILE);
+            ~RefDataCache();
+
+            // Fichier
+            bool Load();
+            bool Save(const RefData& data);
+            const std::string& GetPath() const;
+            void SetPath(const std::string& path);   // avant Load
+
+            // Fraîcheur et rafraîchissement
+            bool IsLoaded() const;
+            bool IsFresh(long maxAgeSeconds) const;
+            bool Refresh(const Loader& loader);
+            // Thread de fond : rafraîchit à chaque dépassement de maxAgeSeconds (un seul à la fois)
+            void StartRefresh(const Loader& loader, long maxAgeSeconds);
+            void StopRefresh();
+
+            // Instantané courant (nullptr si rien n'est chargé) ; un ancien instantané
+            // est libéré quand son dernier lecteur le rend
+            std::shared_ptr<const RefData> Get() const;
+            // Appelé après chaque publication, Get() renvoie déjà le nouvel instantané (avant Load)
+            void SetPublishHandler(std::function<void()> handler);
+
+        private:
+            void Publish(std::shared_ptr<RefData> data);
+            void RefreshLoop(Loader loader, long maxAgeSeconds);
+
+            std::string mPath;
+            std::atomic<std::shared_ptr<const RefData>> mData;
+            std::mutex mPublishMutex;
+            std::function<void()> mPublishHandler;
+            std::thread mRefreshThread;
+            std::mutex mRefreshMutex;
+            std::mutex mWaitMutex;
+            std::condition_variable mWakeUp;
+            bool mStopRefresh;
+    };
+
+} // API
+
+#endif //REFDATACACHE_H
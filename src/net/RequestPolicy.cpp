@@ -0,0 +1,145 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#include "RequestPolicy.h"
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <thread>
+
+namespace API {
+
+    // Échéance absolue du thread (ns sur l'horloge monotone), 0 = aucune
+    static thread_local long long sDeadline = 0;
+
+    static long long NowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()
+        ).count();
+    }
+
+    // ===== ÉCHÉANCES =====
+
+    ScopedDeadline::ScopedDeadline(long milliseconds) :
+        mPrevious(sDeadline) {
+        long long deadline = NowNs() + (long long) milliseconds * 1000000LL;
+        if (sDeadline == 0 || deadline < sDeadline) {
+            sDeadline = deadline;
+        }
+    }
+
+    ScopedDeadline::~ScopedDeadline() {
+        sDeadline = mPrevious;
+    }
+
+    long ScopedDeadline::Remaining() {
+        if (sDeadline == 0) {
+            return -1;
+        }
+        long long remaining = (sDeadline - NowNs()) / 1000000LL;
+        return remaining > 0 ? (long) remaining : 0;
+    }
+
+    // ===== LATENCES =====
+
+    static const size_t LATENCY_WINDOW = 256;
+    static const unsigned long LATENCY_MIN_SAMPLES = 20;
+
+    LatencyTracker::LatencyTracker() {
+    }
+
+    LatencyTracker::~LatencyTracker() {
+    }
+
+    void LatencyTracker::Record(const std::string& endpoint, long microseconds) {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        SWindow& window = mWindows[endpoint];
+        if (window.samples.size() < LATENCY_WINDOW) {
+            window.samples.push_back(microseconds);
+        } else {
+            window.samples[window.next] = microseconds;
+        }
+        window.next = (window.next + 1) % LATENCY_WINDOW;
+        window.count++;
+
+        // Recalcul du p95 toutes les 16 mesures seulement
+        if (window.count >= LATENCY_MIN_SAMPLES && (window.count % 16) == 0) {
+            std::vector<long> sorted(window.samples);
+            size_t rank = (sorted.size() * 95) / 100;
+            std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.end());
+            window.p95 = sorted[rank];
+        }
+    }
+
+    long LatencyTracker::GetP95(const std::string& endpoint) const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mWindows.find(endpoint);
+        return it != mWindows.end() ? it->second.p95 : 0;
+    }
+
+    // ===== RATE-LIMIT =====
+
+    RateBudget::RateBudget() :
+        mCapacity(0.0),
+        mDecay(0.0),
+        mLevel(0.0),
+        mUpdatedNs(NowNs()) {
+    }
+
+    RateBudget::~RateBudget() {
+    }
+
+    void RateBudget::SetLimits(double capacity, double decayPerSecond) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mCapacity = capacity;
+        mDecay = decayPerSecond;
+    }
+
+    bool RateBudget::Acquire(int cost, long maxWaitMs) {
+        long long waitNs;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mCapacity <= 0.0 || mDecay <= 0.0 || cost <= 0) {
+                return true;
+            }
+
+            long long now = NowNs();
+            mLevel = std::max(0.0, mLevel - mDecay * (double) (now - mUpdatedNs) / 1e9);
+            mUpdatedNs = now;
+
+            // Le coût est réservé tout de suite : les appels suivants attendent derrière
+            double excess = mLevel + cost - mCapacity;
+            waitNs = excess > 0.0 ? (long long) (excess / mDecay * 1e9) : 0;
+            if (maxWaitMs >= 0 && waitNs > (long long) maxWaitMs * 1000000LL) {
+                return false;
+            }
+            mLevel += cost;
+        }
+
+        if (waitNs > 0) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(waitNs));
+        }
+        return true;
+    }
+
+    double RateBudget::GetHeadroom() {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (mCapacity <= 0.0 || mDecay <= 0.0) {
+            return -1.0;
+        }
+        double level = std::max(0.0, mLevel - mDecay * (double) (NowNs() - mUpdatedNs) / 1e9);
+        return mCapacity - level;
+    }
+
+    // ===== RETRIES =====
+
+    long RetryBackoff(int attempt, long baseMs, long maxMs) {
+        static thread_local std::mt19937 generator(std::random_device{}());
+        long ceiling = std::min(maxMs, baseMs << std::min(attempt, 16));
+        std::uniform_int_distribution<long> distribution(0, std::max(0L, ceiling));
+        return distribution(generator);
+    }
+
+} // API
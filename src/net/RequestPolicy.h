@@ -0,0 +1,94 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#ifndef REQUESTPOLICY_H
+#define REQUESTPOLICY_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+
+namespace API {
+
+    /*
+     * Échéance portée par le thread appelant.
+     *
+     * Tant que l'objet existe, toute requête émise par ce thread doit aboutir
+     * avant l'échéance : elle borne le timeout CURL et les tentatives de retry.
+     * Les échéances imbriquées ne peuvent que raccourcir l'échéance courante.
+     *
+     *     API::ScopedDeadline deadline(50);
+     *     auto ticker = api.GetTicker("XBTUSD");
+     */
+    class ScopedDeadline {
+        public:
+            explicit ScopedDeadline(long milliseconds);
+            ~ScopedDeadline();
+
+            // Temps restant en ms, -1 s'il n'y a pas d'échéance
+            static long Remaining();
+
+        private:
+            long long mPrevious;
+    };
+
+    // Latences observées par endpoint, pour déclencher les requêtes doublées au p95
+    class LatencyTracker {
+        public:
+            LatencyTracker();
+            ~LatencyTracker();
+
+            void Record(const std::string& endpoint, long microseconds);
+
+            // p95 en µs, 0 tant qu'il n'y a pas assez d'échantillons
+            long GetP95(const std::string& endpoint) const;
+
+        private:
+            struct SWindow {
+                std::vector<long> samples;
+                size_t next = 0;
+                unsigned long count = 0;
+                long p95 = 0;
+            };
+
+            mutable std::mutex mMutex;
+            std::map<std::string, SWindow> mWindows;
+    };
+
+    /*
+     * Compteur de rate-limit à décroissance linéaire (modèle Kraken).
+     *
+     * Chaque appel ajoute son coût ; le compteur redescend de "decay" points
+     * par seconde. Au-delà de la capacité, l'appel attend que le compteur
+     * soit redescendu, sans dépasser l'attente autorisée.
+     */
+    class RateBudget {
+        public:
+            RateBudget();
+            ~RateBudget();
+
+            // capacity = 0 : pas de limite
+            void SetLimits(double capacity, double decayPerSecond);
+
+            // false si le coût ne peut pas être absorbé en moins de maxWaitMs
+            bool Acquire(int cost, long maxWaitMs);
+
+            // Unités encore disponibles sans attente (-1 : pas de limite)
+            double GetHeadroom();
+
+        private:
+            std::mutex mMutex;
+            double mCapacity;
+            double mDecay;
+            double mLevel;
+            long long mUpdatedNs;
+    };
+
+    // Attente avant la tentative "attempt" (backoff exponentiel, gigue complète)
+    long RetryBackoff(int attempt, long baseMs, long maxMs);
+
+} // API
+
+#endif //REQUESTPOLICY_H
@@ -0,0 +1,427 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#include "RiskGate.h"
+#include <cmath>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include "../core/Metrics.h"
+
+namespace API {
+
+    static int64_t NowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()
+        ).count();
+    }
+
+    // ===== MÉTRIQUES =====
+
+    struct SRiskMetrics {
+        Richy::CCounter accepted = Richy::CMetrics::Counter("richy_risk_accepted_total");
+        Richy::CCounter rejects[eRiskCheckCount];
+        Richy::CGauge tripped = Richy::CMetrics::Gauge("richy_risk_kill_switch");
+
+        SRiskMetrics() {
+            for (int i = eRiskKillSwitch; i < eRiskCheckCount; ++i) {
+                std::string label = std::string("{reason=\"") + RiskGate::ToString((ERiskCheck) i) + "\"}";
+                rejects[i] = Richy::CMetrics::Counter("richy_risk_rejects_total" + label);
+            }
+        }
+    };
+
+    static SRiskMetrics& RiskMetrics() {
+        static SRiskMetrics metrics;
+        return metrics;
+    }
+
+    RiskGate::RiskGate() :
+        mCount(0),
+        mDefaults(nullptr),
+        mMaxOrdersPerSecond(0),
+        mOrders(0),
+        mTripped(false),
+        mRejected(0) {
+        for (auto& slot : mSlots) {
+            std::memset(slot.name, 0, sizeof(slot.name));
+            slot.hash = 0;
+            slot.limits.store(nullptr, std::memory_order_relaxed);
+            slot.sequence.store(0, std::memory_order_relaxed);
+            slot.bid = 0.0;
+            slot.ask = 0.0;
+            slot.last = 0.0;
+            slot.updatedNs = 0;
+            slot.position.store(0.0, std::memory_order_relaxed);
+            slot.pending.store(0.0, std::memory_order_relaxed);
+            slot.orders.store(0, std::memory_order_relaxed);
+        }
+        mDefaults.store(Retain(RiskLimits()), std::memory_order_release);
+    }
+
+    RiskGate::~RiskGate() {
+    }
+
+    // ===== LIMITES =====
+
+    const RiskLimits* RiskGate::Retain(const RiskLimits& limits) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mLimits.emplace_back(new RiskLimits(limits));
+        return mLimits.back().get();
+    }
+
+    void RiskGate::SetLimits(const RiskLimits& limits) {
+        mDefaults.store(Retain(limits), std::memory_order_release);
+    }
+
+    void RiskGate::SetPairLimits(const std::string& pair, const RiskLimits& limits) {
+        SPairSlot* slot = FindOrAdd(pair);
+        if (slot) {
+            slot->limits.store(Retain(limits), std::memory_order_release);
+        }
+    }
+
+    void RiskGate::SetMaxOrdersPerSecond(int orders) {
+        mMaxOrdersPerSecond.store(orders, std::memory_order_relaxed);
+    }
+
+    // ===== COUPE-CIRCUIT =====
+
+    void RiskGate::Trip() {
+        mTripped.store(true, std::memory_order_release);
+        RiskMetrics().tripped.Set(1);
+    }
+
+    void RiskGate::Reset() {
+        mTripped.store(false, std::memory_order_release);
+        RiskMetrics().tripped.Set(0);
+    }
+
+    bool RiskGate::IsTripped() const {
+        return mTripped.load(std::memory_order_acquire);
+    }
+
+    // ===== TABLE DES PAIRES =====
+
+    uint32_t RiskGate::Hash(const std::string& pair) {
+        // FNV-1a
+        uint32_t hash = 2166136261u;
+        for (char c : pair) {
+            hash = (hash ^ (uint8_t) c) * 16777619u;
+        }
+        return hash;
+    }
+
+    RiskGate::SPairSlot* RiskGate::Find(const std::string& pair, uint32_t hash) const {
+        size_t count = mCount.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; ++i) {
+            const SPairSlot& slot = mSlots[i];
+            if (slot.hash == hash && std::strncmp(slot.name, pair.c_str(), RISK_PAIR_NAME) == 0) {
+                return const_cast<SPairSlot*>(&slot);
+            }
+        }
+        return nullptr;
+    }
+
+    RiskGate::SPairSlot* RiskGate::FindOrAdd(const std::string& pair) {
+        if (pair.empty() || pair.size() >= RISK_PAIR_NAME) {
+            return nullptr;
+        }
+        uint32_t hash = Hash(pair);
+        SPairSlot* slot = Find(pair, hash);
+        if (slot) {
+            return slot;
+        }
+
+        // Première apparition de la paire : seul cas qui prend le verrou
+        std::lock_guard<std::mutex> lock(mMutex);
+        slot = Find(pair, hash);
+        size_t count = mCount.load(std::memory_order_relaxed);
+        if (slot || count >= RISK_MAX_PAIRS) {
+            return slot;
+        }
+        slot = &mSlots[count];
+        std::strncpy(slot->name, pair.c_str(), RISK_PAIR_NAME - 1);
+        slot->hash = hash;
+        mCount.store(count + 1, std::memory_order_release);
+        return slot;
+    }
+
+    // ===== RÉFÉRENCE ET POSITION =====
+
+    void RiskGate::OnTicker(const TickerData& ticker) {
+        SPairSlot* slot = FindOrAdd(ticker.pair);
+        if (!slot) {
+            return;
+        }
+
+        // Flux et appels REST peuvent écrire en même temps : les écrivains s'excluent par la séquence
+        uint64_t sequence = slot->sequence.load(std::memory_order_relaxed);
+        while ((sequence & 1) || !slot->sequence.compare_exchange_weak(sequence, sequence + 1,
+                                                                       std::memory_order_acquire)) {
+            sequence = slot->sequence.load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        slot->bid = ticker.bid;
+        slot->ask = ticker.ask;
+        slot->last = ticker.last;
+        slot->updatedNs = NowNs();
+        slot->sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    bool RiskGate::ReadReference(const SPairSlot& slot, SReference& reference) const {
+        // L'écriture dure quelques ns ; si l'écrivain a été préempté, on lui rend la main
+        for (int attempt = 0;; ++attempt) {
+            if (attempt >= 64) {
+                std::this_thread::yield();
+            }
+            uint64_t before = slot.sequence.load(std::memory_order_acquire);
+            if (before & 1) {
+                continue;
+            }
+            reference.bid = slot.bid;
+            reference.ask = slot.ask;
+            reference.last = slot.last;
+            reference.updatedNs = slot.updatedNs;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == before) {
+                return reference.updatedNs != 0;
+            }
+        }
+    }
+
+    void RiskGate::SetPosition(const std::string& pair, double volume) {
+        SPairSlot* slot = FindOrAdd(pair);
+        if (slot) {
+            slot->position.store(volume, std::memory_order_relaxed);
+        }
+    }
+
+    double RiskGate::GetPosition(const std::string& pair) const {
+        SPairSlot* slot = Find(pair, Hash(pair));
+        return slot ? slot->position.load(std::memory_order_relaxed) : 0.0;
+    }
+
+    double RiskGate::GetPending(const std::string& pair) const {
+        SPairSlot* slot = Find(pair, Hash(pair));
+        return slot ? slot->pending.load(std::memory_order_relaxed) : 0.0;
+    }
+
+    double RiskGate::GetReferencePrice(const std::string& pair, bool buy) const {
+        SPairSlot* slot = Find(pair, Hash(pair));
+        SReference reference;
+        if (!slot || !ReadReference(*slot, reference)) {
+            return 0.0;
+        }
+        double touch = buy ? reference.ask : reference.bid;
+        return touch > 0.0 ? touch : reference.last;
+    }
+
+    void RiskGate::Add(std::atomic<double>& value, double delta) {
+        double current = value.load(std::memory_order_relaxed);
+        while (!value.compare_exchange_weak(current, current + delta, std::memory_order_relaxed)) {
+        }
+    }
+
+    // ===== CONTRÔLE =====
+
+    bool RiskGate::TakeOrder(std::atomic<uint64_t>& window, int maxPerSecond, int64_t nowNs) {
+        if (maxPerSecond <= 0) {
+            return true;
+        }
+
+        // Fenêtre d'une seconde : seconde courante et compte dans un seul mot atomique
+        uint64_t second = (uint64_t) (nowNs / 1000000000LL);
+        uint64_t current = window.load(std::memory_order_relaxed);
+        uint64_t next;
+        do {
+            if ((current >> 32) != second) {
+                next = (second << 32) | 1;
+            } else if ((current & 0xffffffffu) >= (uint64_t) maxPerSecond) {
+                return false;
+            } else {
+                next = current + 1;
+            }
+        } while (!window.compare_exchange_weak(current, next, std::memory_order_relaxed));
+        return true;
+    }
+
+    ERiskCheck RiskGate::Reject(ERiskCheck verdict) {
+        mRejected.fetch_add(1, std::memory_order_relaxed);
+        RiskMetrics().rejects[verdict].Add();
+        return verdict;
+    }
+
+    ERiskCheck RiskGate::Check(const std::string& pair, const std::string& type, double volume, double price) {
+        if (mTripped.load(std::memory_order_acquire)) {
+            return Reject(eRiskKillSwitch);
+        }
+        if (!std::isfinite(volume) || !std::isfinite(price) || volume <= 0.0 || price < 0.0) {
+            return Reject(eRiskInvalidOrder);
+        }
+
+        SPairSlot* slot = FindOrAdd(pair);
+        if (!slot) {
+            return Reject(eRiskUnknownPair);
+        }
+        const RiskLimits* limits = slot->limits.load(std::memory_order_acquire);
+        if (!limits) {
+            limits = mDefaults.load(std::memory_order_acquire);
+        }
+        bool buy = !type.empty() && type[0] == 'b';
+        int64_t now = NowNs();
+
+        // Prix de référence, uniquement si un contrôle en dépend
+        double notionalPrice = price;
+        if (limits->priceBandPercent > 0.0 || (limits->maxNotional > 0.0 && price == 0.0)) {
+            SReference reference;
+            if (!ReadReference(*slot, reference)) {
+                return Reject(eRiskNoReference);
+            }
+            if (limits->maxReferenceAgeMs > 0 && now - reference.updatedNs > limits->maxReferenceAgeMs * 1000000LL) {
+                return Reject(eRiskStaleReference);
+            }
+            double mid = (reference.bid > 0.0 && reference.ask > 0.0)
+                ? (reference.bid + reference.ask) / 2.0 : reference.last;
+            if (mid <= 0.0) {
+                return Reject(eRiskNoReference);
+            }
+            if (price > 0.0 && limits->priceBandPercent > 0.0 &&
+                std::fabs(price - mid) > mid * limits->priceBandPercent / 100.0) {
+                return Reject(eRiskPriceBand);
+            }
+            if (price == 0.0) {
+                // Ordre au marché : valorisé au prix qu'il traversera
+                double touch = buy ? reference.ask : reference.bid;
+                notionalPrice = touch > 0.0 ? touch : mid;
+            }
+        }
+        if (limits->maxNotional > 0.0 && volume * notionalPrice > limits->maxNotional) {
+            return Reject(eRiskNotional);
+        }
+
+        // Un jeton consommé n'est pas rendu, même si un contrôle suivant refuse l'ordre
+        if (!TakeOrder(mOrders, mMaxOrdersPerSecond.load(std::memory_order_relaxed), now) ||
+            !TakeOrder(slot->orders, limits->maxOrdersPerSecond, now)) {
+            return Reject(eRiskOrderRate);
+        }
+
+        // Réservation en dernier : seuls les ordres acceptés entrent dans l'exposition
+        // (position exécutée + ordres ouverts). Un ordre qui la réduit passe toujours.
+        double delta = buy ? volume : -volume;
+        double pending = slot->pending.load(std::memory_order_relaxed);
+        do {
+            double exposure = slot->position.load(std::memory_order_relaxed) + pending;
+            double after = exposure + delta;
+            if (limits->maxPosition > 0.0 && std::fabs(after) > limits->maxPosition &&
+                std::fabs(after) > std::fabs(exposure)) {
+                return Reject(eRiskPosition);
+            }
+        } while (!slot->pending.compare_exchange_weak(pending, pending + delta, std::memory_order_relaxed));
+
+        RiskMetrics().accepted.Add();
+        return eRiskAccepted;
+    }
+
+    void RiskGate::Release(const std::string& pair, const std::string& type, double volume) {
+        SPairSlot* slot = Find(pair, Hash(pair));
+        if (!slot) {
+            return;
+        }
+        Add(slot->pending, (!type.empty() && type[0] == 'b') ? -volume : volume);
+    }
+
+    void RiskGate::ApplyFill(const std::string& pair, const std::string& type, double volume) {
+        SPairSlot* slot = FindOrAdd(pair);
+        if (!slot) {
+            return;
+        }
+        double delta = (!type.empty() && type[0] == 'b') ? volume : -volume;
+        Add(slot->pending, -delta);
+        Add(slot->position, delta);
+    }
+
+    // ===== SUIVI DES ORDRES =====
+
+    void RiskGate::Track(const std::string& orderId, const std::string& pair, const std::string& type, double volume,
+                         const void* owner) {
+        if (orderId.empty()) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mTrackedMutex);
+        mTracked[orderId] = {pair, type, volume, 0.0, 0.0, 0.0, owner};
+    }
+
+    OrderFill RiskGate::OnOrder(const Order& order) {
+        OrderFill fill;
+        std::lock_guard<std::mutex> lock(mTrackedMutex);
+        auto it = mTracked.find(order.orderId);
+        if (it == mTracked.end()) {
+            return fill;
+        }
+        STrackedOrder& tracked = it->second;
+        double filled = std::min(order.filled, tracked.volume);
+        if (filled > tracked.filled) {
+            fill.pair = tracked.pair;
+            fill.type = tracked.type;
+            fill.volume = filled - tracked.filled;
+            // Coût cumulé inconnu : prix de l'ordre
+            double cost = order.cost - tracked.cost;
+            fill.price = cost > 0.0 ? cost / fill.volume : order.price;
+            fill.fee = std::max(0.0, order.fee - tracked.fee);
+            ApplyFill(tracked.pair, tracked.type, fill.volume);
+            tracked.filled = filled;
+            tracked.cost = std::max(tracked.cost, order.cost);
+            tracked.fee = std::max(tracked.fee, order.fee);
+        }
+        if (order.status == "closed" || order.status == "canceled" || order.status == "expired") {
+            Release(tracked.pair, tracked.type, tracked.volume - tracked.filled);
+            mTracked.erase(it);
+        }
+        return fill;
+    }
+
+    void RiskGate::Close(const std::string& orderId) {
+        std::lock_guard<std::mutex> lock(mTrackedMutex);
+        auto it = mTracked.find(orderId);
+        if (it == mTracked.end()) {
+            return;
+        }
+        Release(it->second.pair, it->second.type, it->second.volume - it->second.filled);
+        mTracked.erase(it);
+    }
+
+    std::vector<std::string> RiskGate::GetTrackedOrders(const void* owner) const {
+        std::lock_guard<std::mutex> lock(mTrackedMutex);
+        std::vector<std::string> orders;
+        for (const auto& entry : mTracked) {
+            if (!owner || entry.second.owner == owner) {
+                orders.push_back(entry.first);
+            }
+        }
+        return orders;
+    }
+
+    unsigned long RiskGate::GetRejected() const {
+        return mRejected.load(std::memory_order_relaxed);
+    }
+
+    const char* RiskGate::ToString(ERiskCheck verdict) {
+        switch (verdict) {
+            case eRiskAccepted:         return "accepted";
+            case eRiskKillSwitch:       return "kill_switch";
+            case eRiskInvalidOrder:     return "invalid_order";
+            case eRiskUnknownPair:      return "unknown_pair";
+            case eRiskNoReference:      return "no_reference";
+            case eRiskStaleReference:   return "stale_reference";
+            case eRiskPriceBand:        return "price_band";
+            case eRiskNotional:         return "max_notional";
+            case eRiskPosition:         return "max_position";
+            case eRiskOrderRate:        return "order_rate";
+            default:                    return "unknown";
+        }
+    }
+
+} // API
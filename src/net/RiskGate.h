@@ -0,0 +1,184 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#ifndef RISKGATE_H
+#define RISKGATE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include "KrakenApi.h"
+
+namespace API {
+
+    static const size_t RISK_MAX_PAIRS = 64;
+    static const size_t RISK_PAIR_NAME = 16;
+
+    enum ERiskCheck : uint8_t {
+        eRiskAccepted = 0,
+        eRiskKillSwitch,
+        eRiskInvalidOrder,
+        eRiskUnknownPair,       // nom invalide ou table des paires pleine
+        eRiskNoReference,       // aucun ticker reçu pour la paire
+        eRiskStaleReference,
+        eRiskPriceBand,
+        eRiskNotional,
+        eRiskPosition,
+        eRiskOrderRate,
+        eRiskCheckCount
+    };
+
+    // 0 = contrôle désactivé
+    struct RiskLimits {
+        double maxNotional = 0.0;           // en devise de cotation, par ordre
+        double maxPosition = 0.0;           // en devise de base, position nette absolue
+        double priceBandPercent = 0.0;      // écart maximal au prix de référence
+        int maxOrdersPerSecond = 0;         // par paire
+        long maxReferenceAgeMs = 0;         // âge maximal du dernier ticker
+    };
+
+    // Exécution nouvellement observée d'un ordre suivi (volume 0 : rien de nouveau)
+    struct OrderFill {
+        std::string pair;
+        std::string type;
+        double volume = 0.0;
+        double price = 0.0;     // prix moyen de cette exécution
+        double fee = 0.0;
+    };
+
+    /*
+     * Contrôle pré-trade, en mémoire, sur le chemin de chaque ordre.
+     *
+     * Tout est préalloué : une table fixe de paires (prix de référence sous
+     * seqlock, position nette, compteur d'ordres) et des limites publiées
+     * comme la configuration, en instantanés immuables. Un contrôle ne prend
+     * aucun verrou et ne touche jamais le réseau ; seul le premier ordre ou
+     * ticker d'une paire inconnue l'enregistre, sous verrou.
+     *
+     *     ERiskCheck verdict = gate.Check("XBTUSD", "buy", 0.01, 0.0);
+     *     if (verdict != eRiskAccepted) {
+     *         std::cout << RiskGate::ToString(verdict);
+     *     }
+     *
+     * Un ordre accepté réserve son volume (pending) : Release l'annule si
+     * l'envoi échoue. Un ordre envoyé est suivi par son txid (Track) ; chaque
+     * état observé (OnOrder) fait passer les exécutions de la réservation à
+     * la position, les rapporte, et libère le reste à la clôture (annulé,
+     * expiré, exécuté).
+     * SetPosition recale la position exécutée sur celle de l'exchange.
+     * Les noms de paires doivent être ceux des abonnements (TickerData::pair).
+     */
+    class RiskGate {
+        public:
+            RiskGate();
+            ~RiskGate();
+
+            // Limites par défaut, et surcharges par paire
+            void SetLimits(const RiskLimits& limits);
+            void SetPairLimits(const std::string& pair, const RiskLimits& limits);
+            // Plafond global, toutes paires confondues (0 = pas de limite)
+            void SetMaxOrdersPerSecond(int orders);
+
+            // Coupe-circuit : plus aucun ordre ni retrait tant qu'il est armé
+            void Trip();
+            void Reset();
+            bool IsTripped() const;
+
+            // Prix de référence et position
+            void OnTicker(const TickerData& ticker);
+            void SetPosition(const std::string& pair, double volume);
+            double GetPosition(const std::string& pair) const;     // exécutée
+            double GetPending(const std::string& pair) const;      // réservée par les ordres ouverts
+            // Prix que traverserait un ordre au marché (ask à l'achat), 0 sans référence
+            double GetReferencePrice(const std::string& pair, bool buy) const;
+
+            // type = "buy" ou "sell", price = 0 pour un ordre au marché
+            ERiskCheck Check(const std::string& pair, const std::string& type, double volume, double price);
+            void Release(const std::string& pair, const std::string& type, double volume);
+            // Volume exécuté : quitte la réservation pour la position
+            void ApplyFill(const std::string& pair, const std::string& type, double volume);
+
+            // Suivi des ordres envoyés, hors chemin critique (sous verrou). owner : clé
+            // qui a placé l'ordre quand le contrôle est partagé (nullptr = toutes)
+            void Track(const std::string& orderId, const std::string& pair, const std::string& type, double volume,
+                       const void* owner = nullptr);
+            // Nouvelle exécution depuis l'état précédent, rapportée une seule fois
+            OrderFill OnOrder(const Order& order);
+            // Clôture sans état connu (annulation confirmée) : le reste est libéré
+            void Close(const std::string& orderId);
+            std::vector<std::string> GetTrackedOrders(const void* owner = nullptr) const;
+
+            unsigned long GetRejected() const;
+            static const char* ToString(ERiskCheck verdict);
+
+        private:
+            struct alignas(64) SPairSlot {
+                char name[RISK_PAIR_NAME];
+                uint32_t hash;
+                std::atomic<const RiskLimits*> limits;      // nullptr : limites par défaut
+
+                // Référence (seqlock : impair pendant l'écriture)
+                std::atomic<uint64_t> sequence;
+                double bid;
+                double ask;
+                double last;
+                int64_t updatedNs;
+
+                std::atomic<double> position;               // exécutée
+                std::atomic<double> pending;                // ordres ouverts, signé
+                std::atomic<uint64_t> orders;               // seconde << 32 | ordres dans la seconde
+            };
+
+            struct STrackedOrder {
+                std::string pair;
+                std::string type;
+                double volume;
+                // Cumuls déjà appliqués
+                double filled;
+                double cost;
+                double fee;
+                const void* owner;
+            };
+
+            struct SReference {
+                double bid;
+                double ask;
+                double last;
+                int64_t updatedNs;
+            };
+
+            SPairSlot* Find(const std::string& pair, uint32_t hash) const;
+            SPairSlot* FindOrAdd(const std::string& pair);
+            bool ReadReference(const SPairSlot& slot, SReference& reference) const;
+            const RiskLimits* Retain(const RiskLimits& limits);
+            ERiskCheck Reject(ERiskCheck verdict);
+
+            static void Add(std::atomic<double>& value, double delta);
+            static uint32_t Hash(const std::string& pair);
+            static bool TakeOrder(std::atomic<uint64_t>& window, int maxPerSecond, int64_t nowNs);
+
+            SPairSlot mSlots[RISK_MAX_PAIRS];
+            std::atomic<size_t> mCount;
+            std::atomic<const RiskLimits*> mDefaults;
+            std::atomic<int> mMaxOrdersPerSecond;
+            std::atomic<uint64_t> mOrders;
+            std::atomic<bool> mTripped;
+            std::atomic<unsigned long> mRejected;
+
+            // Enregistrements et instantanés de limites (jamais libérés avant la destruction)
+            std::mutex mMutex;
+            std::vector<std::unique_ptr<RiskLimits>> mLimits;
+
+            // Ordres ouverts par txid
+            std::unordered_map<std::string, STrackedOrder> mTracked;
+            mutable std::mutex mTrackedMutex;
+    };
+
+} // API
+
+#endif //RISKGATE_H
@@ -0,0 +1,1198 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#include "SimExchange.h"
+#include <cmath>
+#include <ctime>
+#include <chrono>
+#include <cstdlib>
+#include <limits>
+#include <sstream>
+#include <algorithm>
+#include "Endpoints.h"
+#include "HistoryDownloader.h"
+
+namespace API {
+
+    // Reliquat considéré nul (volumes en double, 8 décimales chez Kraken)
+    static const double SIM_EPSILON = 1e-10;
+    static const double SIM_UNLIMITED = std::numeric_limits<double>::infinity();
+    static const size_t SIM_PAGE = 50;
+
+    // Meilleur prix d'un côté, ordres simulés et marché confondus
+    template <typename Levels, typename Depth>
+    static bool BestTicks(const Levels& levels, const Depth& depth, int64_t& ticks) {
+        if (levels.empty() && depth.empty()) {
+            return false;
+        }
+        if (levels.empty()) {
+            ticks = depth.begin()->first;
+        } else if (depth.empty()) {
+            ticks = levels.begin()->first;
+        } else {
+            ticks = levels.key_comp()(levels.begin()->first, depth.begin()->first) ?
+                    levels.begin()->first : depth.begin()->first;
+        }
+        return true;
+    }
+
+    SimExchange::SimExchange() :
+        mAccounts(1),
+        mTrades(0),
+        mNow(std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()
+        ).count()),
+        mKeepHistory(true) {
+    }
+
+    SimExchange::~SimExchange() {
+    }
+
+    // ===== CONFIGURATION =====
+
+    uint32_t SimExchange::AddAsset(const std::string& asset) {
+        auto it = mAssetIndex.find(asset);
+        if (it != mAssetIndex.end()) {
+            return it->second;
+        }
+        uint32_t index = (uint32_t) mAssets.size();
+        mAssets.push_back(asset);
+        mAssetIndex[asset] = index;
+        for (auto& account : mAccounts) {
+            account.total.push_back(0.0);
+            account.held.push_back(0.0);
+        }
+        return index;
+    }
+
+    uint32_t SimExchange::AddPair(const PairInfo& info) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto existing = mPairIndex.find(info.name);
+        if (existing != mPairIndex.end()) {
+            return existing->second;
+        }
+
+        SBook book;
+        book.info = info;
+        book.tick = info.tickSize > 0.0 ? info.tickSize : std::pow(10.0, -info.pairDecimals);
+        // Premier palier du barème, sinon les frais de base de Kraken Pro
+        book.takerRate = info.fees.empty() ? 0.004 : info.fees[0].percent / 100.0;
+        book.makerRate = info.feesMaker.empty() ? (info.fees.empty() ? 0.0025 : book.takerRate) :
+                         info.feesMaker[0].percent / 100.0;
+        book.base = AddAsset(info.base);
+        book.quote = AddAsset(info.quote);
+        book.ticker.pair = info.wsname.empty() ? info.name : info.wsname;
+
+        uint32_t index = (uint32_t) mBooks.size();
+        mBooks.push_back(std::move(book));
+        for (const std::string* name : {&info.name, &info.altname, &info.wsname}) {
+            if (!name->empty()) {
+                mPairIndex.emplace(*name, index);
+            }
+        }
+        return index;
+    }
+
+    uint32_t SimExchange::FindPair(const std::string& name) const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mPairIndex.find(name);
+        return it != mPairIndex.end() ? it->second : SIM_NO_PAIR;
+    }
+
+    std::string SimExchange::GetPairName(uint32_t pair) const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (pair >= mBooks.size()) {
+            return "";
+        }
+        const PairInfo& info = mBooks[pair].info;
+        return info.altname.empty() ? info.name : info.altname;
+    }
+
+    std::vector<PairInfo> SimExchange::GetPairs() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        std::vector<PairInfo> pairs;
+        pairs.reserve(mBooks.size());
+        for (const auto& book : mBooks) {
+            pairs.push_back(book.info);
+        }
+        return pairs;
+    }
+
+    void SimExchange::SetFees(uint32_t pair, double makerRate, double takerRate) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (pair >= mBooks.size()) {
+            return;
+        }
+        SBook& book = mBooks[pair];
+        book.makerRate = makerRate;
+        book.takerRate = takerRate;
+        // AssetPairs renvoie le barème effectivement appliqué
+        book.info.fees = {{0.0, takerRate * 100.0}};
+        book.info.feesMaker = {{0.0, makerRate * 100.0}};
+    }
+
+    uint32_t SimExchange::AddAccount() {
+        std::lock_guard<std::mutex> lock(mMutex);
+        SAccount account;
+        account.total.assign(mAssets.size(), 0.0);
+        account.held.assign(mAssets.size(), 0.0);
+        mAccounts.push_back(std::move(account));
+        return (uint32_t) mAccounts.size() - 1;
+    }
+
+    void SimExchange::SetBalance(uint32_t account, const std::string& asset, double amount) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (account >= mAccounts.size()) {
+            return;
+        }
+        uint32_t index = AddAsset(asset);
+        mAccounts[account].total[index] = amount;
+        mAccounts[account].funded = true;
+    }
+
+    std::vector<Balance> SimExchange::GetBalances(uint32_t account) const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        std::vector<Balance> balances;
+        if (account >= mAccounts.size()) {
+            return balances;
+        }
+        const SAccount& data = mAccounts[account];
+        for (size_t i = 0; i < mAssets.size(); ++i) {
+            if (data.total[i] != 0.0 || data.held[i] != 0.0) {
+                balances.push_back({mAssets[i], data.total[i] - data.held[i], data.held[i], data.total[i]});
+            }
+        }
+        return balances;
+    }
+
+    double SimExchange::GetTradedVolume(uint32_t account) const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return account < mAccounts.size() ? mAccounts[account].traded : 0.0;
+    }
+
+    void SimExchange::SetKeepHistory(bool keep) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mKeepHistory = keep;
+    }
+
+    void SimExchange::SetFillCallback(std::function<void(const SimFill&)> callback) {
+        mFillCallback = callback;
+    }
+
+    void SimExchange::SetTime(long timestamp) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mNow = timestamp;
+    }
+
+    long SimExchange::GetTime() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mNow;
+    }
+
+    int64_t SimExchange::ToTicks(const SBook& book, double price) const {
+        return (int64_t) std::llround(price / book.tick);
+    }
+
+    double SimExchange::ToPrice(const SBook& book, int64_t ticks) const {
+        return (double) ticks * book.tick;
+    }
+
+    // ===== DONNÉES DE MARCHÉ =====
+
+    void SimExchange::OnTicker(const TickerData& ticker) {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            auto it = mPairIndex.find(ticker.pair);
+            if (it == mPairIndex.end()) {
+                return;
+            }
+            SBook& book = mBooks[it->second];
+            mNow = std::max(mNow, ticker.timestamp);
+            std::string pair = book.ticker.pair;
+            book.ticker = ticker;
+            book.ticker.pair = pair;
+
+            // Sans carnet, le meilleur prix du ticker tient lieu de profondeur, en volume illimité
+            if (!book.hasDepth) {
+                book.marketBids.clear();
+                book.marketAsks.clear();
+                if (ticker.bid > 0.0) {
+                    book.marketBids[ToTicks(book, ticker.bid)] = SIM_UNLIMITED;
+                }
+                if (ticker.ask > 0.0) {
+                    book.marketAsks[ToTicks(book, ticker.ask)] = SIM_UNLIMITED;
+                }
+                Cross(book, book.bids, book.marketAsks);
+                Cross(book, book.asks, book.marketBids);
+            }
+        }
+        Deliver();
+    }
+
+    void SimExchange::OnOrderBook(const OrderBook& snapshot) {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            auto it = mPairIndex.find(snapshot.pair);
+            if (it == mPairIndex.end()) {
+                return;
+            }
+            SBook& book = mBooks[it->second];
+            book.hasDepth = true;
+            book.marketBids.clear();
+            book.marketAsks.clear();
+            for (const auto& entry : snapshot.bids) {
+                if (entry.volume > 0.0) {
+                    book.marketBids[ToTicks(book, entry.price)] += entry.volume;
+                }
+            }
+            for (const auto& entry : snapshot.asks) {
+                if (entry.volume > 0.0) {
+                    book.marketAsks[ToTicks(book, entry.price)] += entry.volume;
+                }
+            }
+
+            ClampQueues(book.bids, book.marketBids);
+            ClampQueues(book.asks, book.marketAsks);
+            Cross(book, book.bids, book.marketAsks);
+            Cross(book, book.asks, book.marketBids);
+        }
+        Deliver();
+    }
+
+    void SimExchange::OnTrade(const Trade& trade) {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            auto it = mPairIndex.find(trade.pair);
+            if (it == mPairIndex.end()) {
+                return;
+            }
+            SBook& book = mBooks[it->second];
+            mNow = std::max(mNow, trade.timestamp);
+            book.ticker.last = trade.price;
+
+            // Le côté du trade est celui de l'agresseur : un achat consomme les ventes
+            int64_t ticks = ToTicks(book, trade.price);
+            if (trade.type == "buy") {
+                TradeThrough(book, book.asks, ticks, trade.volume);
+            } else {
+                TradeThrough(book, book.bids, ticks, trade.volume);
+            }
+        }
+        Deliver();
+    }
+
+    size_t SimExchange::ReplayTrades(const std::string& path) {
+        size_t count = 0;
+        TradeColumnWriter::Read(path, [this, &count](const Trade& trade) {
+            OnTrade(trade);
+            ++count;
+            return true;
+        });
+        return count;
+    }
+
+    // ===== APPARIEMENT =====
+
+    template <typename Iterator>
+    double SimExchange::Sweep(SBook& book, Iterator level, double budget, double* depth, SSlot* taker,
+                              bool& selfTrade) {
+        // File du niveau : volume du marché devant chaque ordre (queueAhead, croissant), puis l'ordre
+        double price = ToPrice(book, level->first);
+        double consumed = 0.0;
+        double used = 0.0;
+        uint32_t index = level->second.head;
+        while (index != NIL && budget - used > SIM_EPSILON) {
+            SSlot& resting = mSlots[index];
+            uint32_t next = resting.next;
+
+            double ahead = resting.queueAhead - consumed;
+            if (ahead > SIM_EPSILON) {
+                double take = std::min(ahead, budget - used);
+                consumed += take;
+                used += take;
+                if (taker) {
+                    Fill(book, *taker, price, take, false, ++mTrades);
+                }
+                if (budget - used <= SIM_EPSILON) {
+                    break;
+                }
+            }
+
+            if (taker && resting.order.account == taker->order.account) {
+                selfTrade = true;
+                break;
+            }
+
+            double volume = std::min(resting.remaining, budget - used);
+            uint64_t trade = ++mTrades;
+            used += volume;
+            Fill(book, resting, price, volume, true, trade);
+            if (taker) {
+                Fill(book, *taker, price, volume, false, trade);
+            }
+            if (resting.remaining <= SIM_EPSILON) {
+                Close(index, eSimClosed);
+            }
+            index = next;
+        }
+
+        // Ordre entrant : volume du marché derrière le dernier ordre simulé
+        if (taker && depth && !selfTrade && index == NIL && budget - used > SIM_EPSILON) {
+            double take = std::min(*depth - consumed, budget - used);
+            if (take > SIM_EPSILON) {
+                consumed += take;
+                used += take;
+                Fill(book, *taker, price, take, false, ++mTrades);
+            }
+        }
+        if (depth) {
+            *depth -= consumed;
+        }
+
+        if (consumed > 0.0) {
+            for (uint32_t i = level->second.head; i != NIL; i = mSlots[i].next) {
+                mSlots[i].queueAhead = std::max(mSlots[i].queueAhead - consumed, 0.0);
+            }
+        }
+        return used;
+    }
+
+    template <typename Levels, typename Depth>
+    bool SimExchange::Take(SBook& book, SSlot& taker, Levels& levels, Depth& depth) {
+        auto better = levels.key_comp();
+        bool market = taker.order.type == eSimMarket;
+        bool selfTrade = false;
+        while (taker.remaining > SIM_EPSILON && !selfTrade) {
+            int64_t ticks;
+            if (!BestTicks(levels, depth, ticks) || (!market && better(taker.ticks, ticks))) {
+                break;
+            }
+
+            auto level = levels.begin();
+            auto shown = depth.begin();
+            bool hasShown = shown != depth.end() && shown->first == ticks;
+            if (level != levels.end() && level->first == ticks) {
+                Sweep(book, level, taker.remaining, hasShown ? &shown->second : nullptr, &taker, selfTrade);
+                if (level->second.head == NIL) {
+                    levels.erase(level);
+                }
+            } else {
+                double take = std::min(taker.remaining, shown->second);
+                Fill(book, taker, ToPrice(book, ticks), take, false, ++mTrades);
+                shown->second -= take;
+            }
+            if (hasShown && shown->second <= SIM_EPSILON) {
+                depth.erase(shown);
+            }
+        }
+        return selfTrade;
+    }
+
+    template <typename Levels, typename Depth>
+    void SimExchange::Rest(uint32_t index, Levels& levels, const Depth& depth) {
+        // Derrière le volume affiché du marché à ce prix (inconnu avec le seul ticker)
+        SSlot& slot = mSlots[index];
+        auto shown = depth.find(slot.ticks);
+        slot.queueAhead = shown == depth.end() || std::isinf(shown->second) ? 0.0 : shown->second;
+
+        SLevel& level = levels[slot.ticks];
+        slot.level = &level;
+        slot.prev = level.tail;
+        slot.next = NIL;
+        if (level.tail != NIL) {
+            mSlots[level.tail].next = index;
+        } else {
+            level.head = index;
+        }
+        level.tail = index;
+    }
+
+    template <typename Levels, typename Depth>
+    void SimExchange::Cross(SBook& book, Levels& levels, Depth& depth) {
+        // Marché passé au travers d'ordres au repos : exécutés à leur prix, comme makers
+        auto better = depth.key_comp();
+        bool selfTrade = false;
+        while (!levels.empty() && !depth.empty()) {
+            auto level = levels.begin();
+            auto shown = depth.begin();
+            if (better(level->first, shown->first)) {
+                break;
+            }
+            shown->second -= Sweep(book, level, shown->second, nullptr, nullptr, selfTrade);
+
+            bool progressed = false;
+            if (level->second.head == NIL) {
+                levels.erase(level);
+                progressed = true;
+            }
+            if (shown->second <= SIM_EPSILON) {
+                depth.erase(shown);
+                progressed = true;
+            }
+            if (!progressed) {
+                break;
+            }
+        }
+    }
+
+    template <typename Levels>
+    void SimExchange::TradeThrough(SBook& book, Levels& levels, int64_t ticks, double volume) {
+        // Niveaux meilleurs que le prix du trade : traversés, exécutés en entier
+        auto better = levels.key_comp();
+        bool selfTrade = false;
+        while (!levels.empty()) {
+            auto level = levels.begin();
+            bool through = better(level->first, ticks);
+            if (!through && level->first != ticks) {
+                break;
+            }
+            Sweep(book, level, through ? SIM_UNLIMITED : volume, nullptr, nullptr, selfTrade);
+            if (level->second.head == NIL) {
+                levels.erase(level);
+            }
+            if (!through) {
+                break;
+            }
+        }
+    }
+
+    template <typename Levels, typename Depth>
+    void SimExchange::ClampQueues(Levels& levels, const Depth& depth) {
+        // Volume affiché en baisse : la file devant chaque ordre ne dépasse plus ce qui reste
+        if (depth.empty()) {
+            return;
+        }
+        auto better = depth.key_comp();
+        int64_t worst = depth.rbegin()->first;
+        for (auto& level : levels) {
+            if (better(worst, level.first)) {
+                break;   // au-delà de la profondeur reçue : rien n'est connu
+            }
+            auto shown = depth.find(level.first);
+            double volume = shown != depth.end() ? shown->second : 0.0;
+            for (uint32_t i = level.second.head; i != NIL; i = mSlots[i].next) {
+                mSlots[i].queueAhead = std::min(mSlots[i].queueAhead, volume);
+            }
+        }
+    }
+
+    void SimExchange::Fill(SBook& book, SSlot& slot, double price, double volume, bool maker, uint64_t trade) {
+        double notional = price * volume;
+        double fee = notional * (maker ? book.makerRate : book.takerRate);
+        slot.remaining -= volume;
+        if (slot.remaining < SIM_EPSILON) {
+            slot.remaining = 0.0;
+        }
+        slot.filled += volume;
+        slot.cost += notional;
+        slot.fee += fee;
+
+        // Frais en devise de cotation ; la part exécutée d'un ordre au carnet libère ses fonds
+        SAccount& account = mAccounts[slot.order.account];
+        if (slot.order.side == eSimBuy) {
+            if (slot.held > 0.0) {
+                double release = std::min(volume * slot.order.price, slot.held);
+                slot.held -= release;
+                account.held[book.quote] -= release;
+            }
+            account.total[book.base] += volume;
+            account.total[book.quote] -= notional + fee;
+        } else {
+            if (slot.held > 0.0) {
+                double release = std::min(volume, slot.held);
+                slot.held -= release;
+                account.held[book.base] -= release;
+            }
+            account.total[book.base] -= volume;
+            account.total[book.quote] += notional - fee;
+        }
+        account.traded += notional;
+
+        if (mKeepHistory || mFillCallback) {
+            SimFill fill;
+            fill.trade = trade;
+            fill.order = slot.id;
+            fill.account = slot.order.account;
+            fill.pair = slot.order.pair;
+            fill.side = slot.order.side;
+            fill.maker = maker;
+            fill.price = price;
+            fill.volume = volume;
+            fill.fee = fee;
+            fill.timestamp = mNow;
+            if (mKeepHistory) {
+                mFills.push_back(fill);
+            }
+            if (mFillCallback) {
+                mPending.push_back(fill);
+            }
+        }
+    }
+
+    void SimExchange::Deliver() {
+        if (!mFillCallback) {
+            return;
+        }
+        std::vector<SimFill> fills;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            fills.swap(mPending);
+        }
+        for (const auto& fill : fills) {
+            mFillCallback(fill);
+        }
+    }
+
+    // ===== ORDRES =====
+
+    uint32_t SimExchange::Allocate() {
+        // Emplacements recyclés : l'identifiant porte la génération, un ancien id ne désigne plus rien
+        uint32_t index;
+        if (!mFree.empty()) {
+            index = mFree.back();
+            mFree.pop_back();
+        } else {
+            index = (uint32_t) mSlots.size();
+            mSlots.emplace_back();
+        }
+        SSlot& slot = mSlots[index];
+        slot.id = ((uint64_t) slot.generation << 32) | index;
+        return index;
+    }
+
+    uint32_t SimExchange::Lookup(uint64_t id) const {
+        uint32_t index = (uint32_t) (id & 0xFFFFFFFF);
+        if (index < mSlots.size() && mSlots[index].live && mSlots[index].id == id) {
+            return index;
+        }
+        return NIL;
+    }
+
+    void SimExchange::Unlink(SSlot& slot) {
+        SLevel& level = *slot.level;
+        if (slot.prev != NIL) {
+            mSlots[slot.prev].next = slot.next;
+        } else {
+            level.head = slot.next;
+        }
+        if (slot.next != NIL) {
+            mSlots[slot.next].prev = slot.prev;
+        } else {
+            level.tail = slot.prev;
+        }
+        slot.level = nullptr;
+        slot.prev = NIL;
+        slot.next = NIL;
+    }
+
+    SimOrderState SimExchange::ToState(const SSlot& slot, ESimStatus status) const {
+        SimOrderState state;
+        state.id = slot.id;
+        state.order = slot.order;
+        state.status = status;
+        state.filled = slot.filled;
+        state.cost = slot.cost;
+        state.fee = slot.fee;
+        state.opened = slot.opened;
+        state.closed = status == eSimOpen ? 0 : mNow;
+        return state;
+    }
+
+    void SimExchange::Close(uint32_t index, ESimStatus status) {
+        // Le niveau vidé reste dans le carnet : l'appelant l'efface (itérateurs en cours)
+        SSlot& slot = mSlots[index];
+        if (slot.level) {
+            Unlink(slot);
+        }
+        if (slot.held > 0.0) {
+            const SBook& book = mBooks[slot.order.pair];
+            mAccounts[slot.order.account].held[slot.order.side == eSimBuy ? book.quote : book.base] -= slot.held;
+            slot.held = 0.0;
+        }
+        if (mKeepHistory) {
+            mClosedIndex[slot.id] = mClosed.size();
+            mClosed.push_back(ToState(slot, status));
+        }
+        slot.live = false;
+        slot.generation++;
+        mFree.push_back(index);
+    }
+
+    ESimResult SimExchange::Submit(const SimOrder& order, uint64_t& id) {
+        ESimResult result;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            result = SubmitLocked(order, id);
+        }
+        Deliver();
+        return result;
+    }
+
+    ESimResult SimExchange::SubmitLocked(const SimOrder& order, uint64_t& id) {
+        id = 0;
+        if (order.account >= mAccounts.size()) {
+            return eSimUnknownAccount;
+        }
+        if (order.pair >= mBooks.size()) {
+            return eSimUnknownPair;
+        }
+        if (!(order.volume > SIM_EPSILON)) {
+            return eSimInvalidVolume;
+        }
+        SBook& book = mBooks[order.pair];
+        bool buy = order.side == eSimBuy;
+        bool limit = order.type == eSimLimit;
+        int64_t ticks = limit ? ToTicks(book, order.price) : 0;
+        if (limit && !(ticks > 0)) {
+            return eSimInvalidPrice;
+        }
+
+        int64_t opposite = 0;
+        bool hasOpposite = buy ? BestTicks(book.asks, book.marketAsks, opposite) :
+                                 BestTicks(book.bids, book.marketBids, opposite);
+        if (limit && (order.flags & eSimPostOnly) && hasOpposite &&
+            (buy ? opposite <= ticks : opposite >= ticks)) {
+            return eSimPostOnlyWouldTake;
+        }
+
+        // Fonds disponibles (soldes posés) : un achat au marché est estimé au meilleur prix vendeur
+        SAccount& account = mAccounts[order.account];
+        if (account.funded) {
+            double required = order.volume;
+            uint32_t asset = book.base;
+            if (buy) {
+                double reference = limit ? ToPrice(book, ticks) :
+                                   (hasOpposite ? ToPrice(book, opposite) : book.ticker.last);
+                required = order.volume * reference * (1.0 + book.takerRate);
+                asset = book.quote;
+            }
+            if (account.total[asset] - account.held[asset] < required - SIM_EPSILON) {
+                return eSimInsufficientFunds;
+            }
+        }
+
+        uint32_t index = Allocate();
+        SSlot& slot = mSlots[index];
+        slot.live = true;
+        slot.order = order;
+        slot.order.price = limit ? ToPrice(book, ticks) : 0.0;
+        slot.ticks = ticks;
+        slot.remaining = order.volume;
+        slot.queueAhead = 0.0;
+        slot.filled = 0.0;
+        slot.cost = 0.0;
+        slot.fee = 0.0;
+        slot.held = 0.0;
+        slot.opened = mNow;
+        id = slot.id;
+
+        bool selfTrade = buy ? Take(book, slot, book.asks, book.marketAsks) :
+                               Take(book, slot, book.bids, book.marketBids);
+        if (slot.remaining <= SIM_EPSILON) {
+            Close(index, eSimClosed);
+            return eSimAccepted;
+        }
+        if (!limit || selfTrade || (order.flags & eSimImmediateOrCancel)) {
+            Close(index, eSimCanceled);
+            return eSimAccepted;
+        }
+
+        if (buy) {
+            Rest(index, book.bids, book.marketBids);
+            slot.held = slot.remaining * slot.order.price;
+            account.held[book.quote] += slot.held;
+        } else {
+            Rest(index, book.asks, book.marketAsks);
+            slot.held = slot.remaining;
+            account.held[book.base] += slot.held;
+        }
+        return eSimAccepted;
+    }
+
+    bool SimExchange::CancelLocked(uint32_t index) {
+        SSlot& slot = mSlots[index];
+        SBook& book = mBooks[slot.order.pair];
+        int64_t ticks = slot.ticks;
+        bool buy = slot.order.side == eSimBuy;
+        Close(index, eSimCanceled);
+
+        if (buy) {
+            auto level = book.bids.find(ticks);
+            if (level != book.bids.end() && level->second.head == NIL) {
+                book.bids.erase(level);
+            }
+        } else {
+            auto level = book.asks.find(ticks);
+            if (level != book.asks.end() && level->second.head == NIL) {
+                book.asks.erase(level);
+            }
+        }
+        return true;
+    }
+
+    bool SimExchange::Cancel(uint64_t id) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        uint32_t index = Lookup(id);
+        return index != NIL && CancelLocked(index);
+    }
+
+    size_t SimExchange::CancelAll(uint32_t account) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        size_t count = 0;
+        for (uint32_t i = 0; i < mSlots.size(); ++i) {
+            if (mSlots[i].live && mSlots[i].order.account == account) {
+                CancelLocked(i);
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    bool SimExchange::GetOrder(uint64_t id, SimOrderState& state) const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        uint32_t index = Lookup(id);
+        if (index != NIL) {
+            state = ToState(mSlots[index], eSimOpen);
+            return true;
+        }
+        auto closed = mClosedIndex.find(id);
+        if (closed == mClosedIndex.end()) {
+            return false;
+        }
+        state = mClosed[closed->second];
+        return true;
+    }
+
+    std::vector<SimOrderState> SimExchange::GetOpenOrders(uint32_t account) const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        std::vector<SimOrderState> orders;
+        for (const auto& slot : mSlots) {
+            if (slot.live && slot.order.account == account) {
+                orders.push_back(ToState(slot, eSimOpen));
+            }
+        }
+        return orders;
+    }
+
+    std::vector<SimOrderState> SimExchange::GetClosedOrders(uint32_t account) const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        std::vector<SimOrderState> orders;
+        for (const auto& state : mClosed) {
+            if (state.order.account == account) {
+                orders.push_back(state);
+            }
+        }
+        return orders;
+    }
+
+    std::vector<SimFill> SimExchange::GetFills(uint32_t account) const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        std::vector<SimFill> fills;
+        for (const auto& fill : mFills) {
+            if (fill.account == account) {
+                fills.push_back(fill);
+            }
+        }
+        return fills;
+    }
+
+    // ===== CONSULTATION DU CARNET =====
+
+    template <typename Levels, typename Depth>
+    void SimExchange::AppendDepth(const SBook& book, const Levels& levels, const Depth& depth, int count,
+                                  std::vector<OrderBookEntry>& out) const {
+        auto better = levels.key_comp();
+        auto level = levels.begin();
+        auto shown = depth.begin();
+        while ((count <= 0 || out.size() < (size_t) count) && (level != levels.end() || shown != depth.end())) {
+            int64_t ticks;
+            if (shown == depth.end() || (level != levels.end() && !better(shown->first, level->first))) {
+                ticks = level->first;
+            } else {
+                ticks = shown->first;
+            }
+
+            double volume = 0.0;
+            if (level != levels.end() && level->first == ticks) {
+                for (uint32_t i = level->second.head; i != NIL; i = mSlots[i].next) {
+                    volume += mSlots[i].remaining;
+                }
+                ++level;
+            }
+            if (shown != depth.end() && shown->first == ticks) {
+                // Profondeur illimitée du ticker : volume inconnu, non publié
+                if (!std::isinf(shown->second)) {
+                    volume += shown->second;
+                }
+                ++shown;
+            }
+            out.push_back({ToPrice(book, ticks), volume, mNow});
+        }
+    }
+
+    OrderBook SimExchange::GetDepth(uint32_t pair, int depth) const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        OrderBook result;
+        if (pair >= mBooks.size()) {
+            return result;
+        }
+        const SBook& book = mBooks[pair];
+        result.pair = book.info.altname.empty() ? book.info.name : book.info.altname;
+        AppendDepth(book, book.asks, book.marketAsks, depth, result.asks);
+        AppendDepth(book, book.bids, book.marketBids, depth, result.bids);
+        return result;
+    }
+
+    TickerData SimExchange::GetTicker(uint32_t pair) const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (pair >= mBooks.size()) {
+            return TickerData();
+        }
+        const SBook& book = mBooks[pair];
+        TickerData ticker = book.ticker;
+        int64_t ticks;
+        if (BestTicks(book.bids, book.marketBids, ticks)) {
+            ticker.bid = ToPrice(book, ticks);
+        }
+        if (BestTicks(book.asks, book.marketAsks, ticks)) {
+            ticker.ask = ToPrice(book, ticks);
+        }
+        ticker.timestamp = mNow;
+        return ticker;
+    }
+
+    const char* SimExchange::ToString(ESimResult result) {
+        switch (result) {
+            case eSimAccepted:          return "";
+            case eSimUnknownPair:       return "EQuery:Unknown asset pair";
+            case eSimUnknownAccount:    return "EGeneral:Permission denied";
+            case eSimInvalidVolume:     return "EGeneral:Invalid arguments:volume";
+            case eSimInvalidPrice:      return "EGeneral:Invalid arguments:price";
+            case eSimInsufficientFunds: return "EOrder:Insufficient funds";
+            case eSimPostOnlyWouldTake: return "EOrder:Post only order";
+        }
+        return "EGeneral:Internal error";
+    }
+
+    // ===== TRANSPORT =====
+
+    // Même format que KrakenApi::FormatNumber : 8 décimales au plus, sans zéros de fin
+    static std::string Number(double value) {
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "%.8f", value);
+        std::string text(buffer);
+        text.erase(text.find_last_not_of('0') + 1);
+        if (!text.empty() && text.back() == '.') {
+            text.pop_back();
+        }
+        return text;
+    }
+
+    static std::string Quoted(double value) {
+        return "\"" + Number(value) + "\"";
+    }
+
+    static std::string Error(const std::string& message) {
+        return "{\"error\":[\"" + message + "\"]}";
+    }
+
+    static std::string Result(const std::string& result) {
+        return "{\"error\":[],\"result\":" + result + "}";
+    }
+
+    static std::string Param(const std::map<std::string, std::string>& params, const char* name) {
+        auto it = params.find(name);
+        return it != params.end() ? it->second : "";
+    }
+
+    static std::vector<std::string> Split(const std::string& list) {
+        std::vector<std::string> items;
+        std::stringstream stream(list);
+        std::string item;
+        while (std::getline(stream, item, ',')) {
+            if (!item.empty()) {
+                items.push_back(item);
+            }
+        }
+        return items;
+    }
+
+    static std::string TxId(uint64_t id) {
+        return "OSIM-" + std::to_string(id);
+    }
+
+    static uint64_t ParseTxId(const std::string& txid) {
+        if (txid.compare(0, 5, "OSIM-") != 0) {
+            return 0;
+        }
+        return std::strtoull(txid.c_str() + 5, nullptr, 10);
+    }
+
+    // Fenêtre ]start, end] des historiques privés (0 = non bornée)
+    static bool InWindow(long time, long start, long end) {
+        return (start == 0 || time > start) && (end == 0 || time <= end);
+    }
+
+    // Paramètres "start", "end" et "ofs" d'un historique ; renvoie le décalage de la page
+    static size_t HistoryQuery(const std::map<std::string, std::string>& params, long& start, long& end) {
+        start = std::atol(Param(params, "start").c_str());
+        end = std::atol(Param(params, "end").c_str());
+        return (size_t) std::max(std::atol(Param(params, "ofs").c_str()), 0L);
+    }
+
+    SimTransport::SimTransport(std::shared_ptr<SimExchange> exchange, uint32_t account) :
+        mExchange(exchange),
+        mAccount(account) {
+    }
+
+    void SimTransport::OnTicker(const TickerData& ticker) {
+        mExchange->OnTicker(ticker);
+    }
+
+    void SimTransport::OnOrderBook(const OrderBook& book) {
+        mExchange->OnOrderBook(book);
+    }
+
+    void SimTransport::OnTrade(const Trade& trade) {
+        mExchange->OnTrade(trade);
+    }
+
+    std::string SimTransport::OrderJson(const SimOrderState& state) const {
+        static const char* STATUS[] = {"open", "closed", "canceled"};
+        bool limit = state.order.type == eSimLimit;
+        return "{\"descr\":{\"pair\":\"" + mExchange->GetPairName(state.order.pair) + "\","
+               "\"type\":\"" + (state.order.side == eSimBuy ? "buy" : "sell") + "\","
+               "\"ordertype\":\"" + (limit ? "limit" : "market") + "\","
+               "\"price\":" + Quoted(state.order.price) + "},"
+               "\"vol\":" + Quoted(state.order.volume) + ","
+               "\"vol_exec\":" + Quoted(state.filled) + ","
+               "\"cost\":" + Quoted(state.cost) + ","
+               "\"fee\":" + Quoted(state.fee) + ","
+               "\"price\":" + Quoted(state.filled > 0.0 ? state.cost / state.filled : 0.0) + ","
+               "\"status\":\"" + STATUS[state.status] + "\","
+               "\"opentm\":" + std::to_string(state.opened) + ","
+               "\"closetm\":" + std::to_string(state.closed) + "}";
+    }
+
+    std::string SimTransport::Orders(const std::vector<SimOrderState>& orders, size_t offset, size_t count) const {
+        std::string json = "{";
+        for (size_t i = offset; i < orders.size() && i < offset + count; ++i) {
+            json += (i > offset ? ",\"" : "\"") + TxId(orders[i].id) + "\":" + OrderJson(orders[i]);
+        }
+        return json + "}";
+    }
+
+    std::string SimTransport::AddOrder(const std::map<std::string, std::string>& params) {
+        SimOrder order;
+        order.account = mAccount;
+        order.pair = mExchange->FindPair(Param(params, "pair"));
+        if (order.pair == SIM_NO_PAIR) {
+            return Error(SimExchange::ToString(eSimUnknownPair));
+        }
+
+        std::string type = Param(params, "type");
+        std::string orderType = Param(params, "ordertype");
+        if (type != "buy" && type != "sell") {
+            return Error("EGeneral:Invalid arguments:type");
+        }
+        if (orderType != "limit" && orderType != "market") {
+            return Error("EGeneral:Invalid arguments:ordertype");
+        }
+        order.side = type == "buy" ? eSimBuy : eSimSell;
+        order.type = orderType == "limit" ? eSimLimit : eSimMarket;
+        order.volume = std::atof(Param(params, "volume").c_str());
+        order.price = std::atof(Param(params, "price").c_str());
+        if (Param(params, "oflags").find("post") != std::string::npos) {
+            order.flags |= eSimPostOnly;
+        }
+        if (Param(params, "timeinforce") == "IOC") {
+            order.flags |= eSimImmediateOrCancel;
+        }
+
+        std::string description = type + " " + Number(order.volume) + " " + mExchange->GetPairName(order.pair) +
+                                   " @ " + orderType + (order.type == eSimLimit ? " " + Number(order.price) : "");
+        if (Param(params, "validate") == "true") {
+            return Result("{\"descr\":{\"order\":\"" + description + "\"}}");
+        }
+
+        uint64_t id;
+        ESimResult result = mExchange->Submit(order, id);
+        if (result != eSimAccepted) {
+            return Error(SimExchange::ToString(result));
+        }
+        return Result("{\"descr\":{\"order\":\"" + description + "\"},\"txid\":[\"" + TxId(id) + "\"]}");
+    }
+
+    std::string SimTransport::Request(const EndpointInfo& endpoint,
+                                      const std::map<std::string, std::string>& params) {
+        switch (endpoint.id) {
+            // ===== PUBLICS =====
+            case eTime: {
+                time_t now = (time_t) mExchange->GetTime();
+                struct tm utc;
+                gmtime_r(&now, &utc);
+                char rfc1123[64];
+                strftime(rfc1123, sizeof(rfc1123), "%a, %d %b %y %H:%M:%S +0000", &utc);
+                return Result("{\"unixtime\":" + std::to_string((long) now) + ",\"rfc1123\":\"" + rfc1123 + "\"}");
+            }
+            case eSystemStatus:
+                return Result("{\"status\":\"online\"}");
+            case eAssets:
+            case eAssetPairs: {
+                std::vector<PairInfo> pairs = mExchange->GetPairs();
+                std::map<std::string, std::string> entries;
+                for (const auto& info : pairs) {
+                    if (endpoint.id == eAssets) {
+                        entries[info.base] = "{\"altname\":\"" + info.base + "\"}";
+                        entries[info.quote] = "{\"altname\":\"" + info.quote + "\"}";
+                        continue;
+                    }
+                    std::string fees, feesMaker;
+                    for (const auto& tier : info.fees) {
+                        fees += (fees.empty() ? "[" : ",[") + Number(tier.volume) + "," + Number(tier.percent) + "]";
+                    }
+                    for (const auto& tier : info.feesMaker) {
+                        feesMaker += (feesMaker.empty() ? "[" : ",[") + Number(tier.volume) + "," + Number(tier.percent) + "]";
+                    }
+                    entries[info.name] = "{\"altname\":\"" + info.altname + "\",\"wsname\":\"" + info.wsname + "\","
+                                         "\"base\":\"" + info.base + "\",\"quote\":\"" + info.quote + "\","
+                                         "\"pair_decimals\":" + std::to_string(info.pairDecimals) + ","
+                                         "\"lot_decimals\":" + std::to_string(info.lotDecimals) + ","
+                                         "\"ordermin\":" + Quoted(info.orderMin) + ","
+                                         "\"tick_size\":" + Quoted(info.tickSize) + ","
+                                         "\"fees\":[" + fees + "],\"fees_maker\":[" + feesMaker + "]}";
+                }
+                std::string json = "{";
+                for (const auto& entry : entries) {
+                    json += (json.size() > 1 ? ",\"" : "\"") + entry.first + "\":" + entry.second;
+                }
+                return Result(json + "}");
+            }
+            case eTicker: {
+                std::string json = "{";
+                for (const auto& pair : Split(Param(params, "pair"))) {
+                    uint32_t id = mExchange->FindPair(pair);
+                    if (id == SIM_NO_PAIR) {
+                        return Error(SimExchange::ToString(eSimUnknownPair));
+                    }
+                    TickerData ticker = mExchange->GetTicker(id);
+                    json += (json.size() > 1 ? ",\"" : "\"") + pair + "\":{"
+                            "\"a\":[" + Quoted(ticker.ask) + ",\"0\",\"0\"],"
+                            "\"b\":[" + Quoted(ticker.bid) + ",\"0\",\"0\"],"
+                            "\"c\":[" + Quoted(ticker.last) + ",\"0\"],"
+                            "\"v\":[" + Quoted(ticker.volume) + "," + Quoted(ticker.volume) + "],"
+                            "\"h\":[" + Quoted(ticker.high) + "," + Quoted(ticker.high) + "],"
+                            "\"l\":[" + Quoted(ticker.low) + "," + Quoted(ticker.low) + "],"
+                            "\"o\":" + Quoted(ticker.open) + "}";
+                }
+                return Result(json + "}");
+            }
+            case eDepth: {
+                std::string pair = Param(params, "pair");
+                uint32_t id = mExchange->FindPair(pair);
+                if (id == SIM_NO_PAIR) {
+                    return Error(SimExchange::ToString(eSimUnknownPair));
+                }
+                std::string count = Param(params, "count");
+                OrderBook book = mExchange->GetDepth(id, count.empty() ? 100 : std::atoi(count.c_str()));
+                std::string asks, bids;
+                for (const auto& entry : book.asks) {
+                    asks += (asks.empty() ? "[" : ",[") + Quoted(entry.price) + "," + Quoted(entry.volume) + "," +
+                            std::to_string(entry.timestamp) + "]";
+                }
+                for (const auto& entry : book.bids) {
+                    bids += (bids.empty() ? "[" : ",[") + Quoted(entry.price) + "," + Quoted(entry.volume) + "," +
+                            std::to_string(entry.timestamp) + "]";
+                }
+                return Result("{\"" + pair + "\":{\"asks\":[" + asks + "],\"bids\":[" + bids + "]}}");
+            }
+
+            // ===== PRIVÉS =====
+            case eBalance:
+            case eBalanceEx: {
+                std::string json = "{";
+                for (const auto& balance : mExchange->GetBalances(mAccount)) {
+                    json += (json.size() > 1 ? ",\"" : "\"") + balance.currency + "\":" +
+                            (endpoint.id == eBalance ? Quoted(balance.total) :
+                             "{\"balance\":" + Quoted(balance.total) + ",\"hold_trade\":" + Quoted(balance.locked) + "}");
+                }
+                return Result(json + "}");
+            }
+            case eTradeVolume:
+                return Result("{\"currency\":\"ZUSD\",\"volume\":" + Quoted(mExchange->GetTradedVolume(mAccount)) + "}");
+            case eAddOrder:
+                return AddOrder(params);
+            case eCancelOrder: {
+                SimOrderState state;
+                uint64_t id = ParseTxId(Param(params, "txid"));
+                if (!mExchange->GetOrder(id, state) || state.order.account != mAccount || !mExchange->Cancel(id)) {
+                    return Error("EOrder:Unknown order");
+                }
+                return Result("{\"count\":1}");
+            }
+            case eCancelAll:
+                return Result("{\"count\":" + std::to_string(mExchange->CancelAll(mAccount)) + "}");
+            case eOpenOrders: {
+                std::vector<SimOrderState> orders = mExchange->GetOpenOrders(mAccount);
+                return Result("{\"open\":" + Orders(orders, 0, orders.size()) + "}");
+            }
+            case eQueryOrders: {
+                std::vector<SimOrderState> orders;
+                for (const auto& txid : Split(Param(params, "txid"))) {
+                    SimOrderState state;
+                    if (!mExchange->GetOrder(ParseTxId(txid), state) || state.order.account != mAccount) {
+                        return Error("EOrder:Unknown order");
+                    }
+                    orders.push_back(state);
+                }
+                return Result(Orders(orders, 0, orders.size()));
+            }
+
+            // Historiques : plus récents d'abord, pages de 50 à partir de "ofs"
+            case eClosedOrders: {
+                long start, end;
+                size_t offset = HistoryQuery(params, start, end);
+                bool byOpen = Param(params, "closetime") == "open";
+                std::vector<SimOrderState> closed = mExchange->GetClosedOrders(mAccount);
+                std::vector<SimOrderState> orders;
+                for (auto it = closed.rbegin(); it != closed.rend(); ++it) {
+                    if (InWindow(byOpen ? it->opened : it->closed, start, end)) {
+                        orders.push_back(*it);
+                    }
+                }
+                return Result("{\"closed\":" + Orders(orders, offset, SIM_PAGE) +
+                              ",\"count\":" + std::to_string(orders.size()) + "}");
+            }
+            case eTradesHistory: {
+                long start, end;
+                size_t offset = HistoryQuery(params, start, end);
+                std::vector<SimFill> all = mExchange->GetFills(mAccount);
+                std::vector<const SimFill*> fills;
+                for (auto it = all.rbegin(); it != all.rend(); ++it) {
+                    if (InWindow(it->timestamp, start, end)) {
+                        fills.push_back(&*it);
+                    }
+                }
+                std::string json = "{";
+                for (size_t i = offset; i < fills.size() && i < offset + SIM_PAGE; ++i) {
+                    const SimFill& fill = *fills[i];
+                    json += (i > offset ? ",\"" : "\"") + std::string("TSIM-") + std::to_string(fill.trade) + "\":{"
+                            "\"ordertxid\":\"" + TxId(fill.order) + "\","
+                            "\"pair\":\"" + mExchange->GetPairName(fill.pair) + "\","
+                            "\"time\":" + std::to_string(fill.timestamp) + ","
+                            "\"type\":\"" + (fill.side == eSimBuy ? "buy" : "sell") + "\","
+                            "\"price\":" + Quoted(fill.price) + ","
+                            "\"cost\":" + Quoted(fill.price * fill.volume) + ","
+                            "\"fee\":" + Quoted(fill.fee) + ","
+                            "\"vol\":" + Quoted(fill.volume) + ","
+                            "\"maker\":" + (fill.maker ? "true" : "false") + "}";
+                }
+                return Result("{\"trades\":" + json + "},\"count\":" + std::to_string(fills.size()) + "}");
+            }
+            default:
+                return Error("EGeneral:Unknown method");
+        }
+    }
+
+} // API
@@ -0,0 +1,323 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#ifndef SIMEXCHANGE_H
+#define SIMEXCHANGE_H
+
+#include <map>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include "KrakenApi.h"
+#include "Transport.h"
+
+namespace API {
+
+    static const uint32_t SIM_NO_PAIR = 0xFFFFFFFF;
+
+    enum ESimSide : uint8_t {
+        eSimBuy = 0,
+        eSimSell
+    };
+
+    enum ESimOrderType : uint8_t {
+        eSimLimit = 0,
+        eSimMarket
+    };
+
+    enum ESimFlag : uint8_t {
+        eSimPostOnly = 1,               // refusé s'il prendrait de la liquidité
+        eSimImmediateOrCancel = 2       // reliquat annulé au lieu d'entrer au carnet
+    };
+
+    enum ESimStatus : uint8_t {
+        eSimOpen = 0,
+        eSimClosed,                     // entièrement exécuté
+        eSimCanceled                    // annulé, éventuellement après exécution partielle
+    };
+
+    enum ESimResult : uint8_t {
+        eSimAccepted = 0,
+        eSimUnknownPair,
+        eSimUnknownAccount,
+        eSimInvalidVolume,
+        eSimInvalidPrice,
+        eSimInsufficientFunds,
+        eSimPostOnlyWouldTake
+    };
+
+    struct SimOrder {
+        uint32_t account = 0;
+        uint32_t pair = 0;
+        ESimSide side = eSimBuy;
+        ESimOrderType type = eSimLimit;
+        uint8_t flags = 0;              // ESimFlag
+        double volume = 0.0;
+        double price = 0.0;             // limite, ignorée au marché
+    };
+
+    struct SimOrderState {
+        uint64_t id = 0;
+        SimOrder order;
+        ESimStatus status = eSimOpen;
+        double filled = 0.0;
+        double cost = 0.0;              // somme prix x volume exécutés
+        double fee = 0.0;               // en devise de cotation
+        long opened = 0;
+        long closed = 0;
+    };
+
+    struct SimFill {
+        uint64_t trade = 0;             // numéro d'exécution (commun aux deux côtés d'un appariement interne)
+        uint64_t order = 0;
+        uint32_t account = 0;
+        uint32_t pair = 0;
+        ESimSide side = eSimBuy;
+        bool maker = false;
+        double price = 0.0;
+        double volume = 0.0;
+        double fee = 0.0;
+        long timestamp = 0;
+    };
+
+    /*
+     * Moteur d'appariement en processus, pour le paper trading et les backtests.
+     *
+     * Chaque paire a deux carnets superposés : les ordres simulés, en priorité
+     * prix-temps (file FIFO par niveau), et la profondeur affichée du marché,
+     * reçue du flux réel ou d'un enregistrement. Un ordre simulé qui traverse
+     * prend la profondeur du marché et les ordres simulés d'autres comptes,
+     * meilleur prix d'abord ; à prix égal, le volume affiché du marché passe
+     * devant (il était là avant). Un même compte ne s'apparie jamais avec
+     * lui-même : le reliquat de l'ordre entrant est annulé (cancel-newest, le
+     * défaut de Kraken).
+     *
+     * Position dans la file : un ordre qui entre au carnet se place derrière
+     * le volume affiché du marché à son prix. Les trades du marché à ce prix
+     * consomment d'abord ce volume, puis exécutent l'ordre (partiellement si
+     * besoin) ; un niveau traversé par un trade est exécuté en entier. Une
+     * baisse du volume affiché sans trade est supposée venir de derrière
+     * (annulations) : la file devant l'ordre ne fait que se réduire au volume
+     * restant. Un flux limité au ticker donne une profondeur illimitée au
+     * meilleur prix, et une file vide devant l'ordre.
+     *
+     *     SimExchange exchange;
+     *     uint32_t pair = exchange.AddPair(info);
+     *     exchange.SetBalance(0, "ZUSD", 100000.0);
+     *     exchange.OnOrderBook(book);
+     *     SimOrder order;
+     *     order.pair = pair;
+     *     order.volume = 0.5;
+     *     order.price = 60000.0;
+     *     uint64_t id;
+     *     if (exchange.Submit(order, id) != eSimAccepted) { ... }
+     *     exchange.OnTrade(trade);
+     *
+     * Frais maker/taker par paire, en devise de cotation. Les fonds ne sont
+     * contrôlés qu'une fois un solde posé pour le compte : sans solde initial,
+     * les soldes donnent simplement le P&L. Toutes les méthodes prennent un
+     * verrou unique ; les exécutions sont remises au callback hors verrou.
+     */
+    class SimExchange {
+        public:
+            SimExchange();
+            ~SimExchange();
+
+            // ===== CONFIGURATION =====
+
+            // Nom Kraken, altname et wsname désignent tous la paire ; frais du premier palier
+            uint32_t AddPair(const PairInfo& info);
+            uint32_t FindPair(const std::string& name) const;
+            std::string GetPairName(uint32_t pair) const;   // altname
+            std::vector<PairInfo> GetPairs() const;
+            // Fractions (0.0025 = 0.25 %)
+            void SetFees(uint32_t pair, double makerRate, double takerRate);
+
+            // Le compte 0 existe d'office
+            uint32_t AddAccount();
+            void SetBalance(uint32_t account, const std::string& asset, double amount);
+            std::vector<Balance> GetBalances(uint32_t account) const;
+            double GetTradedVolume(uint32_t account) const;   // notionnel cumulé
+
+            // Ordres clos et exécutions conservés pour les consultations (défaut : oui)
+            void SetKeepHistory(bool keep);
+            // À poser avant le premier ordre ; ne doit pas rappeler l'exchange de façon bloquante
+            void SetFillCallback(std::function<void(const SimFill&)> callback);
+
+            // ===== DONNÉES DE MARCHÉ =====
+
+            void OnTicker(const TickerData& ticker);
+            void OnOrderBook(const OrderBook& book);
+            void OnTrade(const Trade& trade);
+            // Rejoue un fichier de TradeColumnWriter ; nombre de trades lus
+            size_t ReplayTrades(const std::string& path);
+
+            // Horloge simulée (s) : avancée par les horodatages du marché
+            void SetTime(long timestamp);
+            long GetTime() const;
+
+            // ===== ORDRES =====
+
+            ESimResult Submit(const SimOrder& order, uint64_t& id);
+            bool Cancel(uint64_t id);
+            size_t CancelAll(uint32_t account);
+
+            bool GetOrder(uint64_t id, SimOrderState& state) const;
+            std::vector<SimOrderState> GetOpenOrders(uint32_t account) const;
+            std::vector<SimOrderState> GetClosedOrders(uint32_t account) const;   // ordre de clôture
+            std::vector<SimFill> GetFills(uint32_t account) const;
+
+            // Marché et ordres simulés confondus
+            OrderBook GetDepth(uint32_t pair, int depth) const;
+            TickerData GetTicker(uint32_t pair) const;
+
+            // Message d'erreur au format Kraken
+            static const char* ToString(ESimResult result);
+
+        private:
+            static const uint32_t NIL = 0xFFFFFFFF;
+
+            struct SLevel {
+                uint32_t head = NIL;
+                uint32_t tail = NIL;
+            };
+
+            typedef std::map<int64_t, SLevel, std::greater<int64_t>> BidLevels;
+            typedef std::map<int64_t, SLevel> AskLevels;
+            typedef std::map<int64_t, double, std::greater<int64_t>> BidDepth;
+            typedef std::map<int64_t, double> AskDepth;
+
+            struct SSlot {
+                uint64_t id = 0;
+                uint32_t generation = 1;
+                uint32_t prev = NIL;
+                uint32_t next = NIL;
+                SLevel* level = nullptr;    // niveau du carnet si l'ordre y repose
+                bool live = false;
+                SimOrder order;
+                int64_t ticks = 0;
+                double remaining = 0.0;
+                double queueAhead = 0.0;    // volume du marché devant l'ordre à son prix
+                double filled = 0.0;
+                double cost = 0.0;
+                double fee = 0.0;
+                double held = 0.0;          // fonds bloqués par l'ordre au carnet
+                long opened = 0;
+            };
+
+            struct SBook {
+                PairInfo info;
+                double tick = 0.0;
+                double makerRate = 0.0;
+                double takerRate = 0.0;
+                uint32_t base = 0;
+                uint32_t quote = 0;
+                BidLevels bids;
+                AskLevels asks;
+                BidDepth marketBids;
+                AskDepth marketAsks;
+                bool hasDepth = false;      // carnet reçu : le ticker ne sert plus de profondeur
+                TickerData ticker = {};
+            };
+
+            struct SAccount {
+                std::vector<double> total;  // par actif
+                std::vector<double> held;
+                bool funded = false;        // fonds contrôlés
+                double traded = 0.0;
+            };
+
+            uint32_t AddAsset(const std::string& asset);
+            int64_t ToTicks(const SBook& book, double price) const;
+            double ToPrice(const SBook& book, int64_t ticks) const;
+
+            ESimResult SubmitLocked(const SimOrder& order, uint64_t& id);
+            bool CancelLocked(uint32_t index);
+            uint32_t Lookup(uint64_t id) const;
+            uint32_t Allocate();
+            void Unlink(SSlot& slot);
+            void Close(uint32_t index, ESimStatus status);
+            SimOrderState ToState(const SSlot& slot, ESimStatus status) const;
+
+            void Fill(SBook& book, SSlot& slot, double price, double volume, bool maker, uint64_t trade);
+            void Deliver();
+
+            // Appariement, génériques sur le côté (BidLevels/BidDepth ou AskLevels/AskDepth)
+            template <typename Iterator>
+            double Sweep(SBook& book, Iterator level, double budget, double* depth, SSlot* taker, bool& selfTrade);
+            // Vrai si l'appariement s'est arrêté sur un ordre du même compte
+            template <typename Levels, typename Depth>
+            bool Take(SBook& book, SSlot& taker, Levels& levels, Depth& depth);
+            template <typename Levels, typename Depth>
+            void Rest(uint32_t index, Levels& levels, const Depth& depth);
+            template <typename Levels, typename Depth>
+            void Cross(SBook& book, Levels& levels, Depth& depth);
+            template <typename Levels>
+            void TradeThrough(SBook& book, Levels& levels, int64_t ticks, double volume);
+            template <typename Levels, typename Depth>
+            void ClampQueues(Levels& levels, const Depth& depth);
+            template <typename Levels, typename Depth>
+            void AppendDepth(const SBook& book, const Levels& levels, const Depth& depth, int count,
+                             std::vector<OrderBookEntry>& out) const;
+
+            mutable std::mutex mMutex;
+            std::vector<SBook> mBooks;
+            std::unordered_map<std::string, uint32_t> mPairIndex;
+            std::vector<std::string> mAssets;
+            std::unordered_map<std::string, uint32_t> mAssetIndex;
+            std::vector<SAccount> mAccounts;
+
+            std::vector<SSlot> mSlots;
+            std::vector<uint32_t> mFree;
+            uint64_t mTrades;
+            long mNow;
+
+            bool mKeepHistory;
+            std::vector<SimOrderState> mClosed;
+            std::unordered_map<uint64_t, size_t> mClosedIndex;
+            std::vector<SimFill> mFills;
+
+            std::function<void(const SimFill&)> mFillCallback;
+            std::vector<SimFill> mPending;
+    };
+
+    /*
+     * Transport de KrakenApi vers un SimExchange, pour un compte : la
+     * stratégie garde KrakenApi, les ordres sont appariés en processus.
+     *
+     *     auto exchange = std::make_shared<SimExchange>();
+     *     exchange->AddPair(info);
+     *     api.SetTransport(std::make_shared<SimTransport>(exchange, 0));
+     *
+     * Les réponses suivent le format Kraken (txid "OSIM-n", trades "TSIM-n") ;
+     * les endpoints sans équivalent simulé renvoient "EGeneral:Unknown method".
+     * Le flux temps réel de KrakenApi alimente l'exchange.
+     */
+    class SimTransport : public Transport {
+        public:
+            SimTransport(std::shared_ptr<SimExchange> exchange, uint32_t account = 0);
+
+            std::string Request(const EndpointInfo& endpoint,
+                                const std::map<std::string, std::string>& params) override;
+
+            void OnTicker(const TickerData& ticker) override;
+            void OnOrderBook(const OrderBook& book) override;
+            void OnTrade(const Trade& trade) override;
+
+        private:
+            std::string AddOrder(const std::map<std::string, std::string>& params);
+            std::string Orders(const std::vector<SimOrderState>& orders, size_t offset, size_t count) const;
+            std::string OrderJson(const SimOrderState& state) const;
+
+            std::shared_ptr<SimExchange> mExchange;
+            uint32_t mAccount;
+    };
+
+} // API
+
+#endif //SIMEXCHANGE_H
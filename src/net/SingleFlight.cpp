@@ -0,0 +1,123 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#include "SingleFlight.h"
+#include <thread>
+#include <chrono>
+
+namespace API {
+
+    // ===== SINGLE-FLIGHT =====
+
+    SingleFlight::SingleFlight() :
+        mShared(0) {
+    }
+
+    SingleFlight::~SingleFlight() {
+    }
+
+    FlightResult SingleFlight::Do(const std::string& key, const std::function<FlightResult()>& fn) {
+        std::promise<FlightResult> promise;
+        std::shared_future<FlightResult> pending;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            auto it = mInFlight.find(key);
+            if (it != mInFlight.end()) {
+                pending = it->second;
+            } else {
+                mInFlight[key] = promise.get_future().share();
+            }
+        }
+
+        // Une requête identique est déjà en vol : on attend son résultat
+        if (pending.valid()) {
+            mShared++;
+            return pending.get();
+        }
+
+        FlightResult result;
+        try {
+            result = fn();
+        } catch (...) {
+            result.body = "";
+            result.error = "Request failed for " + key;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mInFlight.erase(key);
+        }
+        promise.set_value(result);
+        return result;
+    }
+
+    unsigned long SingleFlight::GetShared() const {
+        return mShared;
+    }
+
+    // ===== REGROUPEMENT DES TICKERS =====
+
+    TickerBatcher::TickerBatcher(FetchFunction fetch) :
+        mFetch(fetch),
+        mWindow(0) {
+    }
+
+    TickerBatcher::~TickerBatcher() {
+    }
+
+    void TickerBatcher::SetWindow(long microseconds) {
+        mWindow = microseconds;
+    }
+
+    long TickerBatcher::GetWindow() const {
+        return mWindow;
+    }
+
+    TickerData TickerBatcher::Get(const std::string& pair, std::string& error) {
+        std::shared_ptr<SBatch> batch;
+        bool leader = false;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (!mOpen) {
+                mOpen = std::make_shared<SBatch>();
+                mOpen->future = mOpen->promise.get_future().share();
+                leader = true;
+            }
+            mOpen->pairs.insert(pair);
+            batch = mOpen;
+        }
+
+        if (leader) {
+            // Le premier appelant laisse la fenêtre se remplir puis la ferme
+            std::this_thread::sleep_for(std::chrono::microseconds(mWindow.load()));
+            {
+                std::lock_guard<std::mutex> lock(mMutex);
+                mOpen.reset();
+            }
+
+            SResults results;
+            std::vector<std::string> pairs(batch->pairs.begin(), batch->pairs.end());
+            try {
+                for (const auto& ticker : mFetch(pairs, results.error)) {
+                    results.tickers[ticker.pair] = ticker;
+                }
+            } catch (...) {
+                results.error = "Ticker batch failed";
+            }
+            batch->promise.set_value(results);
+        }
+
+        const SResults& results = batch->future.get();
+        error = results.error;
+        auto it = results.tickers.find(pair);
+        if (it != results.tickers.end()) {
+            return it->second;
+        }
+
+        TickerData ticker = {};
+        ticker.pair = pair;
+        return ticker;
+    }
+
+} // API
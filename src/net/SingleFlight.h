@@ -0,0 +1,90 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#ifndef SINGLEFLIGHT_H
+#define SINGLEFLIGHT_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <mutex>
+#include <future>
+#include <memory>
+#include <atomic>
+#include <functional>
+#include "KrakenApi.h"
+
+namespace API {
+
+    // Réponse partagée : l'erreur voyage avec le corps (mLastError est par thread)
+    struct FlightResult {
+        std::string body;
+        std::string error;
+    };
+
+    /*
+     * Fusion des requêtes identiques en vol (single-flight).
+     *
+     * Le premier appelant d'une clé exécute la requête, les appelants suivants
+     * attendent et reçoivent le même résultat, erreur comprise. La clé est
+     * retirée dès que la réponse est disponible : il ne s'agit pas d'un cache.
+     */
+    class SingleFlight {
+        public:
+            SingleFlight();
+            ~SingleFlight();
+
+            FlightResult Do(const std::string& key, const std::function<FlightResult()>& fn);
+
+            // Nombre d'appels servis sans requête réseau
+            unsigned long GetShared() const;
+
+        private:
+            std::mutex mMutex;
+            std::map<std::string, std::shared_future<FlightResult>> mInFlight;
+            std::atomic<unsigned long> mShared;
+    };
+
+    /*
+     * Regroupement des GetTicker sur des paires différentes.
+     *
+     * Les demandes arrivant pendant la fenêtre sont envoyées en un seul
+     * appel GetMultipleTickers, puis redistribuées à chaque appelant avec
+     * l'erreur éventuelle de cet appel.
+     */
+    class TickerBatcher {
+        public:
+            typedef std::function<std::vector<TickerData>(const std::vector<std::string>&, std::string& error)> FetchFunction;
+
+            TickerBatcher(FetchFunction fetch);
+            ~TickerBatcher();
+
+            void SetWindow(long microseconds);
+            long GetWindow() const;
+
+            // error : celle de l'appel groupé, vide en cas de succès
+            TickerData Get(const std::string& pair, std::string& error);
+
+        private:
+            struct SResults {
+                std::map<std::string, TickerData> tickers;
+                std::string error;
+            };
+
+            struct SBatch {
+                std::set<std::string> pairs;
+                std::promise<SResults> promise;
+                std::shared_future<SResults> future;
+            };
+
+            FetchFunction mFetch;
+            std::atomic<long> mWindow;
+            std::mutex mMutex;
+            std::shared_ptr<SBatch> mOpen;
+    };
+
+} // API
+
+#endif //SINGLEFLIGHT_H
@@ -0,0 +1,45 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#ifndef TRANSPORT_H
+#define TRANSPORT_H
+
+#include <map>
+#include <string>
+#include "KrakenApi.h"
+
+namespace API {
+
+    struct EndpointInfo;
+
+    /*
+     * Transport REST enfichable de KrakenApi, à la place de HTTP.
+     *
+     * Request reçoit l'endpoint et ses paramètres non encodés, et renvoie le
+     * corps JSON que Kraken aurait renvoyé ({"error":[...],"result":...}) :
+     * les décodeurs typés de KrakenApi restent les mêmes. Une chaîne vide
+     * signale un échec du transport lui-même.
+     *
+     *     api.SetTransport(std::make_shared<SimTransport>(exchange, account));
+     *
+     * Avec un transport, ni signature, ni budget de rate-limit, ni retries.
+     * Le flux temps réel reçu par KrakenApi lui est aussi relayé (exchange
+     * simulé alimenté par le marché réel). Appelé depuis plusieurs threads.
+     */
+    class Transport {
+        public:
+            virtual ~Transport() {}
+
+            virtual std::string Request(const EndpointInfo& endpoint,
+                                        const std::map<std::string, std::string>& params) = 0;
+
+            // Flux temps réel (thread du flux), ignoré par défaut
+            virtual void OnTicker(const TickerData&) {}
+            virtual void OnOrderBook(const OrderBook&) {}
+            virtual void OnTrade(const Trade&) {}
+    };
+
+} // API
+
+#endif //TRANSPORT_H
@@ -0,0 +1,483 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#include "WebSocketClient.h"
+#include "LatencyProbe.h"
+#include "../core/ThreadLayout.h"
+#include <chrono>
+#include <cstring>
+#include <cerrno>
+#include <netdb.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <openssl/err.h>
+#include <openssl/rand.h>
+#include <openssl/evp.h>
+
+namespace API {
+
+    // Opcodes RFC 6455
+    static const int WS_CONTINUATION = 0x0;
+    static const int WS_TEXT = 0x1;
+    static const int WS_BINARY = 0x2;
+    static const int WS_CLOSE = 0x8;
+    static const int WS_PING = 0x9;
+    static const int WS_PONG = 0xA;
+
+    WebSocketClient::WebSocketClient() :
+        mFd(-1),
+        mCtx(NULL),
+        mSsl(NULL),
+        mConnected(false),
+        mWriteTimeoutMs(0) {
+    }
+
+    WebSocketClient::~WebSocketClient() {
+        Close();
+    }
+
+    bool WebSocketClient::Fail(const std::string& error) {
+        mLastError = error;
+        Close();
+        return false;
+    }
+
+    const std::string& WebSocketClient::GetLastError() const {
+        return mLastError;
+    }
+
+    bool WebSocketClient::IsConnected() const {
+        return mConnected;
+    }
+
+    int WebSocketClient::GetFd() const {
+        return mFd;
+    }
+
+    // ===== CONNEXION =====
+
+    bool WebSocketClient::Connect(const std::string& url, long timeoutMs) {
+        Close();
+        mWriteTimeoutMs = timeoutMs;
+
+        bool secure;
+        std::string rest;
+        if (url.compare(0, 6, "wss://") == 0) {
+            secure = true;
+            rest = url.substr(6);
+        } else if (url.compare(0, 5, "ws://") == 0) {
+            secure = false;
+            rest = url.substr(5);
+        } else {
+            return Fail("Unsupported WebSocket URL: " + url);
+        }
+
+        size_t slash = rest.find('/');
+        std::string authority = rest.substr(0, slash);
+        std::string path = slash == std::string::npos ? "/" : rest.substr(slash);
+        std::string host = authority;
+        std::string port = secure ? "443" : "80";
+        size_t colon = authority.find(':');
+        if (colon != std::string::npos) {
+            host = authority.substr(0, colon);
+            port = authority.substr(colon + 1);
+        }
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        auto left = [&deadline]() -> long {
+            return std::max(1L, (long) std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()
+            ).count());
+        };
+
+        if (!ConnectSocket(host, port, timeoutMs)) {
+            return false;
+        }
+
+        if (secure) {
+            mCtx = SSL_CTX_new(TLS_client_method());
+            if (!mCtx) {
+                return Fail("Cannot create TLS context");
+            }
+            SSL_CTX_set_default_verify_paths(mCtx);
+            SSL_CTX_set_verify(mCtx, SSL_VERIFY_PEER, NULL);
+
+            mSsl = SSL_new(mCtx);
+            SSL_set_fd(mSsl, mFd);
+            SSL_set_tlsext_host_name(mSsl, host.c_str());
+            SSL_set1_host(mSsl, host.c_str());
+
+            for (;;) {
+                int res = SSL_connect(mSsl);
+                if (res == 1) {
+                    break;
+                }
+                int error = SSL_get_error(mSsl, res);
+                if (error == SSL_ERROR_WANT_READ || error == SSL_ERROR_WANT_WRITE) {
+                    if (!WaitFor(error == SSL_ERROR_WANT_WRITE, left())) {
+                        return Fail("TLS handshake timeout");
+                    }
+                    continue;
+                }
+                return Fail("TLS handshake failed");
+            }
+        }
+
+        if (!Handshake(authority, path, left())) {
+            return false;
+        }
+
+        mConnected = true;
+        return true;
+    }
+
+    bool WebSocketClient::ConnectSocket(const std::string& host, const std::string& port, long timeoutMs) {
+        struct addrinfo hints;
+        std::memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+
+        struct addrinfo* result = NULL;
+        if (getaddrinfo(host.c_str(), port.c_str(), &hints, &result) != 0 || !result) {
+            return Fail("Cannot resolve " + host);
+        }
+
+        for (struct addrinfo* addr = result; addr; addr = addr->ai_next) {
+            mFd = socket(addr->ai_family, addr->ai_socktype, addr->ai_protocol);
+            if (mFd < 0) {
+                continue;
+            }
+
+            // Socket non bloquante : toutes les attentes passent par poll
+            fcntl(mFd, F_SETFL, fcntl(mFd, F_GETFL, 0) | O_NONBLOCK);
+            int one = 1;
+            setsockopt(mFd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+            if (connect(mFd, addr->ai_addr, addr->ai_addrlen) == 0 ||
+                (errno == EINPROGRESS && WaitFor(true, timeoutMs))) {
+                int error = 0;
+                socklen_t len = sizeof(error);
+                getsockopt(mFd, SOL_SOCKET, SO_ERROR, &error, &len);
+                if (error == 0) {
+                    freeaddrinfo(result);
+                    return true;
+                }
+            }
+            close(mFd);
+            mFd = -1;
+        }
+
+        freeaddrinfo(result);
+        return Fail("Cannot connect to " + host + ":" + port);
+    }
+
+    bool WebSocketClient::Handshake(const std::string& host, const std::string& path, long timeoutMs) {
+        unsigned char nonce[16];
+        RAND_bytes(nonce, sizeof(nonce));
+        unsigned char key[32];
+        EVP_EncodeBlock(key, nonce, sizeof(nonce));
+
+        std::string request = "GET " + path + " HTTP/1.1\r\n"
+                              "Host: " + host + "\r\n"
+                              "Upgrade: websocket\r\n"
+                              "Connection: Upgrade\r\n"
+                              "Sec-WebSocket-Key: " + std::string((char*) key) + "\r\n"
+                              "Sec-WebSocket-Version: 13\r\n"
+                              "User-Agent: Richy Trading Bot 1.0\r\n\r\n";
+        if (!WriteAll(request.data(), request.size())) {
+            return Fail("Cannot send WebSocket handshake");
+        }
+
+        // Lecture de la réponse HTTP ; ce qui suit l'en-tête appartient déjà au flux
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        size_t end;
+        while ((end = mBuffer.find("\r\n\r\n")) == std::string::npos) {
+            long left = (long) std::chrono::duration_cast<std::chrono::milliseconds>(
+                deadline - std::chrono::steady_clock::now()
+            ).count();
+            if (left <= 0 || !WaitFor(false, left)) {
+                return Fail("WebSocket handshake timeout");
+            }
+            char chunk[BUFSIZ];
+            long len = ReadSome(chunk, sizeof(chunk));
+            if (len < 0) {
+                return Fail("Connection closed during WebSocket handshake");
+            }
+            mBuffer.append(chunk, len);
+        }
+
+        std::string status = mBuffer.substr(0, mBuffer.find("\r\n"));
+        if (status.find(" 101") == std::string::npos) {
+            return Fail("WebSocket upgrade refused: " + status);
+        }
+        mBuffer.erase(0, end + 4);
+        return true;
+    }
+
+    void WebSocketClient::Close() {
+        if (mConnected) {
+            // Trame de fermeture "best effort"
+            SendFrame(WS_CLOSE, "");
+        }
+        mConnected = false;
+        if (mSsl) {
+            SSL_free(mSsl);
+            mSsl = NULL;
+        }
+        if (mCtx) {
+            SSL_CTX_free(mCtx);
+            mCtx = NULL;
+        }
+        if (mFd >= 0) {
+            close(mFd);
+            mFd = -1;
+        }
+        mBuffer.clear();
+        mFragments.clear();
+    }
+
+    // ===== ENTRÉES / SORTIES =====
+
+    bool WebSocketClient::WaitFor(bool write, long timeoutMs) {
+        struct pollfd pfd = {mFd, (short) (write ? POLLOUT : POLLIN), 0};
+        return poll(&pfd, 1, (int) timeoutMs) > 0;
+    }
+
+    // Une socket qui n'accepte plus rien pendant le délai de connexion est considérée perdue
+    bool WebSocketClient::WriteAll(const char* data, size_t len) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(mWriteTimeoutMs);
+        while (len > 0) {
+            long written;
+            bool write = true;
+            if (mSsl) {
+                int res = SSL_write(mSsl, data, (int) len);
+                if (res <= 0) {
+                    int error = SSL_get_error(mSsl, res);
+                    if (error != SSL_ERROR_WANT_WRITE && error != SSL_ERROR_WANT_READ) {
+                        return false;
+                    }
+                    write = error == SSL_ERROR_WANT_WRITE;
+                    written = 0;
+                } else {
+                    written = res;
+                }
+            } else {
+                written = send(mFd, data, len, MSG_NOSIGNAL);
+                if (written < 0) {
+                    if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                        return false;
+                    }
+                    written = 0;
+                }
+            }
+
+            if (written == 0) {
+                long left = (long) std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - std::chrono::steady_clock::now()
+                ).count();
+                if (left <= 0 || !WaitFor(write, left)) {
+                    // Pas de Close ici : il tenterait d'écrire la trame de fermeture
+                    mLastError = "WebSocket write timeout";
+                    mConnected = false;
+                    return false;
+                }
+                continue;
+            }
+            data += written;
+            len -= written;
+        }
+        return true;
+    }
+
+    // Nombre d'octets lus, 0 si rien n'est disponible, -1 si la connexion est perdue
+    long WebSocketClient::ReadSome(char* data, size_t len) {
+        if (mSsl) {
+            int res = SSL_read(mSsl, data, (int) len);
+            if (res > 0) {
+                LatencyProbe::NoteRead();
+                return res;
+            }
+            int error = SSL_get_error(mSsl, res);
+            return (error == SSL_ERROR_WANT_READ || error == SSL_ERROR_WANT_WRITE) ? 0 : -1;
+        }
+
+        long res = recv(mFd, data, len, 0);
+        if (res > 0) {
+            LatencyProbe::NoteRead();
+            return res;
+        }
+        if (res < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return 0;
+        }
+        return -1;
+    }
+
+    bool WebSocketClient::SendFrame(int opcode, const std::string& payload) {
+        if (mFd < 0) {
+            return false;
+        }
+
+        std::string frame;
+        frame.reserve(payload.size() + 14);
+        frame.push_back((char) (0x80 | opcode));
+
+        // Les trames client sont toujours masquées
+        size_t len = payload.size();
+        if (len < 126) {
+            frame.push_back((char) (0x80 | len));
+        } else if (len <= 0xFFFF) {
+            frame.push_back((char) (0x80 | 126));
+            frame.push_back((char) ((len >> 8) & 0xFF));
+            frame.push_back((char) (len & 0xFF));
+        } else {
+            frame.push_back((char) (0x80 | 127));
+            for (int shift = 56; shift >= 0; shift -= 8) {
+                frame.push_back((char) ((len >> shift) & 0xFF));
+            }
+        }
+
+        unsigned char mask[4];
+        RAND_bytes(mask, sizeof(mask));
+        frame.append((const char*) mask, 4);
+        for (size_t i = 0; i < len; ++i) {
+            frame.push_back((char) (payload[i] ^ mask[i & 3]));
+        }
+
+        return WriteAll(frame.data(), frame.size());
+    }
+
+    bool WebSocketClient::SendText(const std::string& text) {
+        return mConnected && SendFrame(WS_TEXT, text);
+    }
+
+    bool WebSocketClient::SendPing() {
+        return mConnected && SendFrame(WS_PING, "");
+    }
+
+    // 1 = message complet, 0 = trame incomplète ou de contrôle, -1 = fermeture
+    int WebSocketClient::ParseFrame(std::string& message) {
+        if (mBuffer.size() < 2) {
+            return 0;
+        }
+
+        const unsigned char* data = (const unsigned char*) mBuffer.data();
+        bool fin = (data[0] & 0x80) != 0;
+        int opcode = data[0] & 0x0F;
+        bool masked = (data[1] & 0x80) != 0;
+        uint64_t len = data[1] & 0x7F;
+        size_t header = 2;
+
+        if (len == 126) {
+            if (mBuffer.size() < 4) {
+                return 0;
+            }
+            len = ((uint64_t) data[2] << 8) | data[3];
+            header = 4;
+        } else if (len == 127) {
+            if (mBuffer.size() < 10) {
+                return 0;
+            }
+            len = 0;
+            for (int i = 0; i < 8; ++i) {
+                len = (len << 8) | data[2 + i];
+            }
+            header = 10;
+        }
+
+        size_t maskOffset = header;
+        if (masked) {
+            header += 4;
+        }
+        if (mBuffer.size() < header + len) {
+            return 0;
+        }
+
+        std::string payload = mBuffer.substr(header, len);
+        if (masked) {
+            for (size_t i = 0; i < payload.size(); ++i) {
+                payload[i] ^= data[maskOffset + (i & 3)];
+            }
+        }
+        mBuffer.erase(0, header + len);
+
+        switch (opcode) {
+            case WS_PING:
+                SendFrame(WS_PONG, payload);
+                return 0;
+            case WS_PONG:
+                return 0;
+            case WS_CLOSE:
+                mLastError = "Connection closed by peer";
+                return -1;
+            case WS_TEXT:
+            case WS_BINARY:
+                mFragments = payload;
+                break;
+            case WS_CONTINUATION:
+                mFragments += payload;
+                break;
+            default:
+                return 0;
+        }
+
+        if (!fin) {
+            return 0;
+        }
+        message.swap(mFragments);
+        mFragments.clear();
+        return 1;
+    }
+
+    int WebSocketClient::Receive(std::string& message, int timeoutMs, bool spin) {
+        if (!mConnected) {
+            return -1;
+        }
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        for (;;) {
+            // Une trame complète est peut-être déjà en mémoire
+            // (les trames de contrôle sont consommées sans rien produire)
+            int parsed;
+            size_t before;
+            do {
+                before = mBuffer.size();
+                parsed = ParseFrame(message);
+            } while (parsed == 0 && mBuffer.size() != before);
+            if (parsed == 1) {
+                return 1;
+            }
+            if (parsed < 0) {
+                mConnected = false;
+                return -1;
+            }
+
+            // Données TLS déjà déchiffrées : pas besoin d'attendre la socket
+            if (!(mSsl && SSL_pending(mSsl) > 0)) {
+                long left = (long) std::chrono::duration_cast<std::chrono::milliseconds>(
+                    deadline - std::chrono::steady_clock::now()
+                ).count();
+                if (left < 0) {
+                    return 0;
+                }
+                if (Richy::CThreadLayout::WaitReadable(mFd, (int) left, spin) <= 0) {
+                    return 0;
+                }
+            }
+
+            char chunk[16384];
+            long len = ReadSome(chunk, sizeof(chunk));
+            if (len < 0) {
+                mLastError = "Connection lost";
+                mConnected = false;
+                return -1;
+            }
+            mBuffer.append(chunk, len);
+        }
+    }
+
+} // API
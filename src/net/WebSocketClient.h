@@ -0,0 +1,62 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#ifndef WEBSOCKETCLIENT_H
+#define WEBSOCKETCLIENT_H
+
+#include <string>
+#include <openssl/ssl.h>
+
+namespace API {
+
+    /*
+     * Client WebSocket minimal (RFC 6455) sur socket POSIX, TLS via OpenSSL.
+     *
+     * Gère le handshake HTTP, le masquage des trames sortantes, la
+     * réassemblage des messages fragmentés et répond seul aux pings.
+     * Non thread-safe : toutes les lectures et écritures doivent se faire
+     * depuis le même thread (celui du flux).
+     */
+    class WebSocketClient {
+        public:
+            WebSocketClient();
+            ~WebSocketClient();
+
+            // url : ws://hôte[:port]/chemin ou wss://hôte[:port]/chemin
+            bool Connect(const std::string& url, long timeoutMs);
+            void Close();
+            bool IsConnected() const;
+            int GetFd() const;
+
+            bool SendText(const std::string& text);
+            bool SendPing();
+
+            // 1 = message reçu, 0 = rien avant le délai, -1 = connexion perdue
+            int Receive(std::string& message, int timeoutMs, bool spin = false);
+
+            const std::string& GetLastError() const;
+
+        private:
+            bool ConnectSocket(const std::string& host, const std::string& port, long timeoutMs);
+            bool Handshake(const std::string& host, const std::string& path, long timeoutMs);
+            bool WaitFor(bool write, long timeoutMs);
+            bool WriteAll(const char* data, size_t len);
+            long ReadSome(char* data, size_t len);
+            bool SendFrame(int opcode, const std::string& payload);
+            int ParseFrame(std::string& message);
+            bool Fail(const std::string& error);
+
+            int mFd;
+            SSL_CTX* mCtx;
+            SSL* mSsl;
+            bool mConnected;
+            long mWriteTimeoutMs;   // délai de connexion, repris pour chaque écriture
+            std::string mBuffer;
+            std::string mFragments;
+            std::string mLastError;
+    };
+
+} // API
+
+#endif //WEBSOCKETCLIENT_H
@@ -0,0 +1,77 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include "../core/def.h"
+#include "../trading/OrderBookView.h"
+
+// Banc de test des métriques de carnet, noyaux scalaires contre AVX2.
+// Usage : richy-bookbench
+static double Measure(const std::function<double()>& metric, int iterations) {
+    volatile double sink = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        sink = sink + metric();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return (double) std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / iterations;
+}
+
+static API::OrderBook MakeBook(size_t levels) {
+    API::OrderBook book;
+    for (size_t i = 0; i < levels; ++i) {
+        API::OrderBookEntry ask = {50000.0 + 0.5 * (double) (i + 1), 0.1 + 0.01 * (double) (i % 7), 0};
+        API::OrderBookEntry bid = {50000.0 - 0.5 * (double) (i + 1), 0.1 + 0.01 * (double) (i % 5), 0};
+        book.asks.push_back(ask);
+        book.bids.push_back(bid);
+    }
+    return book;
+}
+
+int main() {
+    std::cout << FULLNAME << " - order book analytics benchmark" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+
+    const size_t depths[] = {10, 100, 1000};
+    for (size_t levels : depths) {
+        Richy::COrderBookView view;
+        view.Assign(MakeBook(levels));
+
+        // Balayage d'environ 80% de la profondeur pour parcourir le carnet
+        double quantity = 0.8 * 0.13 * (double) levels;
+        int iterations = (int) (20000000 / levels);
+
+        struct SMetric {
+            const char* name;
+            std::function<double()> run;
+        } metrics[] = {
+            {"sweep_vwap", [&]() { return view.GetSweepVWAP(Richy::eAsks, quantity); }},
+            {"depth_50bps", [&]() { return view.GetDepthWithin(Richy::eBids, 50.0); }},
+            {"imbalance", [&]() { return view.GetImbalance(levels); }},
+            {"microprice", [&]() { return view.GetMicroprice(); }},
+        };
+
+        std::cout << "levels=" << levels << std::endl;
+        for (const auto& metric : metrics) {
+            Richy::COrderBookView::EnableSimd(false);
+            double scalarValue = metric.run();
+            double scalar = Measure(metric.run, iterations);
+            Richy::COrderBookView::EnableSimd(true);
+            double simdValue = metric.run();
+            double simd = Measure(metric.run, iterations);
+
+            bool mismatch = std::fabs(scalarValue - simdValue) > 1e-9 * std::fabs(scalarValue);
+            std::cout << "  " << std::left << std::setw(12) << metric.name << std::right
+                      << " scalar=" << std::setw(8) << scalar << "ns"
+                      << " simd=" << std::setw(8) << simd << "ns"
+                      << (mismatch ? RED " MISMATCH" STOP : "")
+                      << std::endl;
+        }
+    }
+    return 0;
+}
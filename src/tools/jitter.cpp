@@ -0,0 +1,63 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#include <iostream>
+#include <cstdlib>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "../core/def.h"
+#include "../core/Configuration.h"
+#include "../core/ThreadLayout.h"
+
+// Mesure de la gigue d'ordonnancement, sans puis avec le placement configuré,
+// puis en spin sur une socket en busy-poll (boucle de réception du flux).
+// Usage : richy-jitter [durée_ms] [cpu]
+static void Print(const char* label, const Richy::SJitterStats& stats) {
+    std::cout << label
+              << " samples=" << stats.samples
+              << " p50=" << stats.p50 << "ns"
+              << " p99=" << stats.p99 << "ns"
+              << " p99.9=" << stats.p999 << "ns"
+              << " max=" << stats.max << "ns" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    std::cout << FULLNAME << " - jitter" << std::endl;
+
+    Richy::CConfiguration config;
+    config.Load();
+    Richy::SRuntimeConfig runtime = *config.GetRuntime();
+
+    int durationMs = argc > 1 ? std::atoi(argv[1]) : 2000;
+    if (argc > 2) {
+        runtime.networkCpu = std::atoi(argv[2]);
+    }
+    if (runtime.networkCpu < 0) {
+        runtime.networkCpu = 0;
+    }
+
+    Print("default  ", Richy::CThreadLayout::MeasureJitter(durationMs));
+
+    if (!Richy::CThreadLayout::Apply(runtime, Richy::eNetworkThread)) {
+        std::cout << YELLOW "Thread layout only partially applied (affinity or mlock refused)" STOP << std::endl;
+    }
+    std::cout << "pinned on cpu " << runtime.networkCpu << (runtime.lockMemory ? ", memory locked" : "") << std::endl;
+
+    Print("pinned   ", Richy::CThreadLayout::MeasureJitter(durationMs));
+
+    int busyPollUs = runtime.busyPollUs > 0 ? runtime.busyPollUs : 50;
+    int fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        std::cout << YELLOW "Cannot create a socket for the busy-poll run" STOP << std::endl;
+        return 0;
+    }
+    if (!Richy::CThreadLayout::EnableBusyPoll(fd, busyPollUs)) {
+        std::cout << YELLOW "SO_BUSY_POLL refused (CAP_NET_ADMIN needed above net.core.busy_read)" STOP << std::endl;
+    }
+    std::cout << "busy-poll " << busyPollUs << "us, spinning on the socket" << std::endl;
+
+    Print("busy-poll", Richy::CThreadLayout::MeasureJitter(durationMs, fd));
+    close(fd);
+    return 0;
+}
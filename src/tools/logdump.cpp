@@ -0,0 +1,50 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#include <iostream>
+#include <strings.h>
+#include "../core/def.h"
+#include "../core/LogReader.h"
+
+// Rendu texte du journal binaire.
+// Usage : richy-logdump [fichier] [niveau minimal : debug|info|warning|error]
+static Richy::ELogLevel ParseLevel(const char* name) {
+    if (strcasecmp(name, "info") == 0) return Richy::eLogInfo;
+    if (strcasecmp(name, "warning") == 0) return Richy::eLogWarning;
+    if (strcasecmp(name, "error") == 0) return Richy::eLogError;
+    return Richy::eLogDebug;
+}
+
+int main(int argc, char** argv) {
+    std::string path = argc > 1 ? argv[1] : LOG_FILE;
+    Richy::ELogLevel minimum = argc > 2 ? ParseLevel(argv[2]) : Richy::eLogDebug;
+
+    Richy::CLogReader reader;
+    if (!reader.Open(path)) {
+        std::cerr << RED << reader.GetLastError() << STOP << std::endl;
+        return 1;
+    }
+
+    Richy::SLogEntry entry;
+    unsigned long count = 0;
+    while (reader.Next(entry)) {
+        if (entry.level < minimum) {
+            continue;
+        }
+        std::cout << Richy::CLogReader::FormatTime(entry.timestamp)
+                  << " [" << entry.thread << "] "
+                  << Richy::CLogReader::LevelName(entry.level) << " "
+                  << entry.file << ":" << entry.line << " "
+                  << entry.message << std::endl;
+        count++;
+    }
+
+    if (!reader.GetLastError().empty()) {
+        std::cerr << YELLOW << reader.GetLastError() << STOP << std::endl;
+    }
+    if (reader.GetDropped() > 0) {
+        std::cerr << YELLOW << reader.GetDropped() << " records dropped (buffer full)" << STOP << std::endl;
+    }
+    return reader.GetLastError().empty() ? 0 : 1;
+}
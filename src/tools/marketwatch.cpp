@@ -0,0 +1,70 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include "../core/def.h"
+#include "../net/MarketBus.h"
+
+// Abonné d'exemple au flux diffusé par un richy en mode éditeur (publish_market_data).
+// Usage : richy-marketwatch [paire]   (sans paire : tous les événements)
+int main(int argc, char** argv) {
+    std::string filter = argc > 1 ? argv[1] : "";
+
+    API::MarketSubscriber subscriber;
+    if (!subscriber.Open()) {
+        std::cerr << RED << subscriber.GetLastError() << STOP << std::endl;
+        return 1;
+    }
+    std::cout << "Attached to publisher pid " << subscriber.GetPublisherPid() << std::endl;
+
+    API::MarketEvent event;
+    auto lastTop = std::chrono::steady_clock::now();
+    std::cout << std::fixed << std::setprecision(5);
+    while (subscriber.IsPublisherAlive()) {
+        if (!subscriber.Poll(event)) {
+            // Meilleurs prix une fois par seconde, lus sans attendre d'événement
+            if (!filter.empty() && std::chrono::steady_clock::now() - lastTop > std::chrono::seconds(1)) {
+                API::TopOfBook top;
+                if (subscriber.ReadTop(subscriber.FindPair(filter), top)) {
+                    std::cout << CYAN << filter << " bid " << top.bid << " x " << top.bidVolume
+                              << " ask " << top.ask << " x " << top.askVolume
+                              << " last " << top.last << STOP << std::endl;
+                }
+                lastTop = std::chrono::steady_clock::now();
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            continue;
+        }
+
+        std::string pair = subscriber.GetPairName(event.pair);
+        if (!filter.empty() && pair != filter) {
+            continue;
+        }
+        std::cout << "#" << event.sequence << " " << pair << " ";
+        switch (event.type) {
+            case API::eMarketTicker:
+                std::cout << "ticker bid " << event.bid << " ask " << event.ask << " last " << event.price;
+                break;
+            case API::eMarketTrade:
+                std::cout << "trade " << (event.side == 'b' ? "buy " : "sell ") << event.volume << " @ " << event.price;
+                break;
+            case API::eMarketBook:
+                std::cout << "book " << (int) event.bidCount << "x" << (int) event.askCount;
+                if (event.bidCount > 0 && event.askCount > 0) {
+                    std::cout << " " << event.bids[0].price << " / " << event.asks[0].price;
+                }
+                break;
+            case API::eMarketGap:
+                std::cout << YELLOW "gap " << event.channel << " (" << event.reason << ")" STOP;
+                break;
+        }
+        std::cout << std::endl;
+    }
+
+    std::cout << "Publisher gone, " << subscriber.GetLost() << " event(s) lost" << std::endl;
+    return 0;
+}
@@ -0,0 +1,83 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <thread>
+#include <chrono>
+#include "../core/def.h"
+#include "../core/MetricsReader.h"
+
+// Lecture des métriques d'un processus richy en cours, sans l'interrompre.
+// Usage : richy-metrics                       (tableau)
+//         richy-metrics fichier.prom [période_s]  (export Prometheus, répété si période > 0)
+static void Print(const Richy::CMetricsReader& reader, const std::vector<Richy::SMetricSample>& samples) {
+    std::cout << "pid " << reader.GetPid() << (reader.IsAlive() ? "" : " (not running)")
+              << ", up " << (long long) time(NULL) - reader.GetStarted() << "s" << std::endl;
+
+    for (const auto& sample : samples) {
+        std::cout << std::left << std::setw(64) << sample.name << " ";
+        if (sample.type != Richy::eMetricHistogram) {
+            std::cout << sample.value << std::endl;
+            continue;
+        }
+        std::cout << "count=" << sample.value;
+        if (sample.value > 0) {
+            std::cout << " mean=" << sample.sum / sample.value
+                      << " p50<=" << sample.Quantile(0.50)
+                      << " p99<=" << sample.Quantile(0.99)
+                      << " max<=" << sample.Quantile(1.0);
+        }
+        std::cout << std::endl;
+    }
+}
+
+// Écriture puis renommage : le collecteur ne lit jamais un fichier partiel
+static bool Export(const std::string& path, const std::vector<Richy::SMetricSample>& samples) {
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        file << Richy::CMetricsReader::ToPrometheus(samples);
+        if (!file) {
+            return false;
+        }
+    }
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+int main(int argc, char** argv) {
+    Richy::CMetricsReader reader;
+    if (!reader.Open()) {
+        std::cerr << RED << reader.GetLastError() << STOP << std::endl;
+        return 1;
+    }
+
+    std::vector<Richy::SMetricSample> samples;
+    if (argc < 2) {
+        reader.Snapshot(samples);
+        Print(reader, samples);
+        return 0;
+    }
+
+    std::string path = argv[1];
+    int period = argc > 2 ? std::atoi(argv[2]) : 0;
+    do {
+        reader.Snapshot(samples);
+        if (!Export(path, samples)) {
+            std::cerr << RED "Cannot write " << path << STOP << std::endl;
+            return 1;
+        }
+        if (period > 0) {
+            std::this_thread::sleep_for(std::chrono::seconds(period));
+        }
+    } while (period > 0 && reader.IsAlive());
+    return 0;
+}
@@ -0,0 +1,126 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <vector>
+#include "../core/def.h"
+#include "../net/SimExchange.h"
+
+// Banc du moteur d'appariement simulé : flux aléatoire d'ordres limites, au marché et
+// d'annulations entre plusieurs comptes, en appel direct puis à travers KrakenApi.
+// Usage : richy-simbench [ordres en appel direct] [ordres via KrakenApi]
+static API::PairInfo MakePair() {
+    API::PairInfo info;
+    info.name = "XXBTZUSD";
+    info.altname = "XBTUSD";
+    info.wsname = "XBT/USD";
+    info.base = "XXBT";
+    info.quote = "ZUSD";
+    info.pairDecimals = 1;
+    info.lotDecimals = 8;
+    info.orderMin = 0.0001;
+    info.tickSize = 0.1;
+    return info;
+}
+
+static double Seconds(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    long direct = argc > 1 ? atol(argv[1]) : 5000000;
+    long routed = argc > 2 ? atol(argv[2]) : 200000;
+
+    std::cout << FULLNAME << " - simulated exchange benchmark" << std::endl;
+    std::cout << std::fixed << std::setprecision(0);
+
+    // ===== APPEL DIRECT =====
+    {
+        API::SimExchange exchange;
+        exchange.SetKeepHistory(false);
+        uint32_t pair = exchange.AddPair(MakePair());
+        const uint32_t accounts = 8;
+        for (uint32_t i = 1; i < accounts; ++i) {
+            exchange.AddAccount();
+        }
+
+        // Prix autour de 60000 à ±2 $ : files de quelques dizaines d'ordres par niveau
+        std::mt19937_64 random(42);
+        std::vector<uint64_t> live;
+        live.reserve(1 << 16);
+        unsigned long fills = 0;
+        exchange.SetFillCallback([&fills](const API::SimFill&) {
+            fills++;
+        });
+
+        auto start = std::chrono::steady_clock::now();
+        for (long i = 0; i < direct; ++i) {
+            uint64_t draw = random();
+            // 25 % d'annulations d'un ordre au hasard parmi les derniers placés
+            if ((draw & 3) == 0 && !live.empty()) {
+                size_t index = (size_t) ((draw >> 8) % live.size());
+                exchange.Cancel(live[index]);
+                live[index] = live.back();
+                live.pop_back();
+                continue;
+            }
+
+            API::SimOrder order;
+            order.account = (uint32_t) ((draw >> 2) % accounts);
+            order.pair = pair;
+            order.side = (draw >> 5) & 1 ? API::eSimBuy : API::eSimSell;
+            order.type = (draw >> 6) % 10 == 0 ? API::eSimMarket : API::eSimLimit;
+            order.volume = 0.001 * (double) (1 + (draw >> 10) % 100);
+            double offset = 0.1 * (double) ((int) ((draw >> 20) % 41) - 20);
+            order.price = 60000.0 + (order.side == API::eSimBuy ? -offset : offset) - 1.0;
+            uint64_t id;
+            if (exchange.Submit(order, id) == API::eSimAccepted && order.type == API::eSimLimit) {
+                if (live.size() >= (1 << 16)) {
+                    live[(draw >> 32) % live.size()] = id;
+                } else {
+                    live.push_back(id);
+                }
+            }
+        }
+        double elapsed = Seconds(start);
+        std::cout << "direct   " << std::setw(10) << direct << " requests in " << std::setprecision(3) << elapsed
+                  << " s: " << std::setprecision(0) << (double) direct / elapsed << " requests/s, "
+                  << fills << " fills" << std::endl;
+    }
+
+    // ===== À TRAVERS KRAKENAPI =====
+    {
+        auto exchange = std::make_shared<API::SimExchange>();
+        exchange->SetKeepHistory(false);
+        exchange->AddPair(MakePair());
+        uint32_t other = exchange->AddAccount();
+
+        API::KrakenApi api;
+        API::KrakenApi counterparty;
+        api.SetTransport(std::make_shared<API::SimTransport>(exchange, 0));
+        counterparty.SetTransport(std::make_shared<API::SimTransport>(exchange, other));
+
+        std::mt19937_64 random(7);
+        auto start = std::chrono::steady_clock::now();
+        long placed = 0;
+        for (long i = 0; i < routed; ++i) {
+            uint64_t draw = random();
+            API::KrakenApi& trader = (draw & 1) ? api : counterparty;
+            double offset = 0.1 * (double) ((int) ((draw >> 20) % 41) - 20);
+            bool buy = (draw >> 5) & 1;
+            std::string txid = trader.PlaceLimitOrder("XBTUSD", buy ? "buy" : "sell", 0.01,
+                                                      60000.0 + (buy ? -offset : offset) - 1.0);
+            placed += txid.empty() ? 0 : 1;
+        }
+        double elapsed = Seconds(start);
+        std::cout << "krakenapi" << std::setw(11) << routed << " orders in " << std::setprecision(3) << elapsed
+                  << " s: " << std::setprecision(0) << (double) routed / elapsed << " orders/s, "
+                  << placed << " accepted" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,369 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#include <iostream>
+#include <iomanip>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <string>
+#include <cstring>
+#include <algorithm>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <openssl/sha.h>
+#include <openssl/evp.h>
+#include "../core/def.h"
+#include "../net/KrakenApi.h"
+#include "../net/LatencyProbe.h"
+
+// Banc tick-to-trade : une bourse de substitution en boucle locale (flux WebSocket
+// en clair + REST), un ticker à débit fixe, un ordre tous les N tickers, et la
+// distribution de chaque étape entre la lecture socket et l'écriture de l'ordre.
+// Usage : richy-ticktotrade [messages/s] [durée_s] [un ordre tous les N tickers]
+
+static std::atomic<bool> gStop{false};
+
+static int Listen(int& port) {
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    if (bind(fd, (sockaddr*) &address, sizeof(address)) != 0 || listen(fd, 16) != 0) {
+        close(fd);
+        return -1;
+    }
+    socklen_t length = sizeof(address);
+    getsockname(fd, (sockaddr*) &address, &length);
+    port = ntohs(address.sin_port);
+    return fd;
+}
+
+// Connexion entrante, ou -1 si rien avant le délai (pour relire gStop)
+static int Accept(int listenFd, int timeoutMs) {
+    pollfd pfd = {listenFd, POLLIN, 0};
+    if (poll(&pfd, 1, timeoutMs) <= 0) {
+        return -1;
+    }
+    int fd = accept(listenFd, nullptr, nullptr);
+    if (fd >= 0) {
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    return fd;
+}
+
+static bool SendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) {
+            return false;
+        }
+        sent += (size_t) n;
+    }
+    return true;
+}
+
+// Lit jusqu'à la fin des en-têtes HTTP ; le reste éventuel reste dans buffer
+static bool ReadHeaders(int fd, std::string& buffer, std::string& headers) {
+    char chunk[4096];
+    size_t end;
+    while ((end = buffer.find("\r\n\r\n")) == std::string::npos) {
+        ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+        if (n <= 0) {
+            return false;
+        }
+        buffer.append(chunk, (size_t) n);
+    }
+    headers = buffer.substr(0, end + 4);
+    buffer.erase(0, end + 4);
+    return true;
+}
+
+static std::string HeaderValue(const std::string& headers, const std::string& name) {
+    size_t pos = headers.find(name + ":");
+    if (pos == std::string::npos) {
+        return "";
+    }
+    pos += name.size() + 1;
+    while (pos < headers.size() && headers[pos] == ' ') {
+        ++pos;
+    }
+    return headers.substr(pos, headers.find("\r\n", pos) - pos);
+}
+
+// ===== FLUX WEBSOCKET =====
+
+static std::string AcceptKey(const std::string& key) {
+    std::string input = key + "258EAFA5-E914-47DA-95CA-C5AB0DC85B11";
+    unsigned char digest[SHA_DIGEST_LENGTH];
+    SHA1((const unsigned char*) input.data(), input.size(), digest);
+    unsigned char encoded[64];
+    int length = EVP_EncodeBlock(encoded, digest, SHA_DIGEST_LENGTH);
+    return std::string((char*) encoded, (size_t) length);
+}
+
+// Trame serveur : texte, non masquée
+static std::string TextFrame(const std::string& payload) {
+    std::string frame;
+    frame.push_back((char) 0x81);
+    if (payload.size() < 126) {
+        frame.push_back((char) payload.size());
+    } else {
+        frame.push_back((char) 126);
+        frame.push_back((char) ((payload.size() >> 8) & 0xFF));
+        frame.push_back((char) (payload.size() & 0xFF));
+    }
+    return frame + payload;
+}
+
+// Trame client complète en tête de buffer (masquée), sinon faux
+static bool PopClientFrame(std::string& buffer, std::string& payload) {
+    if (buffer.size() < 2) {
+        return false;
+    }
+    size_t length = (uint8_t) buffer[1] & 0x7F;
+    size_t header = 2;
+    if (length == 126) {
+        if (buffer.size() < 4) {
+            return false;
+        }
+        length = ((size_t) (uint8_t) buffer[2] << 8) | (uint8_t) buffer[3];
+        header = 4;
+    } else if (length == 127) {
+        if (buffer.size() < 10) {
+            return false;
+        }
+        length = 0;
+        for (int i = 0; i < 8; ++i) {
+            length = (length << 8) | (uint8_t) buffer[2 + i];
+        }
+        header = 10;
+    }
+    bool masked = ((uint8_t) buffer[1] & 0x80) != 0;
+    size_t maskOffset = header;
+    if (masked) {
+        header += 4;
+    }
+    if (buffer.size() < header + length) {
+        return false;
+    }
+    payload = buffer.substr(header, length);
+    if (masked) {
+        for (size_t i = 0; i < length; ++i) {
+            payload[i] ^= buffer[maskOffset + (i & 3)];
+        }
+    }
+    buffer.erase(0, header + length);
+    return true;
+}
+
+static std::string TickerMessage(const std::string& pair, uint64_t sequence) {
+    char prices[128];
+    double bid = 60000.0 + 0.1 * (double) (sequence % 100);
+    snprintf(prices, sizeof(prices), "\"a\":[\"%.1f\",0,\"1.0\"],\"b\":[\"%.1f\",0,\"1.0\"],\"c\":[\"%.1f\",\"0.01\"]",
+             bid + 0.1, bid, bid);
+    return "[42,{" + std::string(prices) +
+           ",\"v\":[\"0\",\"100\"],\"h\":[\"0\",\"61000\"],\"l\":[\"0\",\"59000\"],\"o\":[\"0\",\"60000\"]},"
+           "\"ticker\",\"" + pair + "\"]";
+}
+
+static void RunFeed(int listenFd, int rate) {
+    int fd = -1;
+    while (fd < 0 && !gStop) {
+        fd = Accept(listenFd, 100);
+    }
+    if (fd < 0) {
+        return;
+    }
+
+    std::string buffer, headers;
+    if (!ReadHeaders(fd, buffer, headers)) {
+        close(fd);
+        return;
+    }
+    SendAll(fd, "HTTP/1.1 101 Switching Protocols\r\n"
+                "Upgrade: websocket\r\n"
+                "Connection: Upgrade\r\n"
+                "Sec-WebSocket-Accept: " + AcceptKey(HeaderValue(headers, "Sec-WebSocket-Key")) + "\r\n\r\n");
+
+    // Cadence fixe : le n-ième ticker part à start + n * intervalle, les trames du client lues entre deux
+    std::string pair;
+    auto interval = std::chrono::nanoseconds(1000000000LL / std::max(rate, 1));
+    auto next = std::chrono::steady_clock::now();
+    uint64_t sequence = 0;
+    char chunk[4096];
+    while (!gStop) {
+        int waitMs = 100;
+        if (!pair.empty()) {
+            auto now = std::chrono::steady_clock::now();
+            waitMs = now >= next ? 0 : (int) std::chrono::duration_cast<std::chrono::milliseconds>(next - now).count();
+        }
+        pollfd pfd = {fd, POLLIN, 0};
+        if (poll(&pfd, 1, waitMs) > 0) {
+            ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                break;
+            }
+            buffer.append(chunk, (size_t) n);
+            std::string payload;
+            while (PopClientFrame(buffer, payload)) {
+                size_t pos = payload.find("\"pair\":[\"");
+                if (payload.find("\"subscribe\"") != std::string::npos && pos != std::string::npos) {
+                    pos += 9;
+                    pair = payload.substr(pos, payload.find('"', pos) - pos);
+                    SendAll(fd, TextFrame("{\"channelID\":42,\"channelName\":\"ticker\",\"event\":\"subscriptionStatus\","
+                                          "\"pair\":\"" + pair + "\",\"status\":\"subscribed\","
+                                          "\"subscription\":{\"name\":\"ticker\"}}"));
+                    next = std::chrono::steady_clock::now();
+                }
+            }
+        }
+
+        if (pair.empty()) {
+            continue;
+        }
+        // Attente active sous la milliseconde : poll() n'a pas la résolution voulue
+        while (std::chrono::steady_clock::now() < next && !gStop) {
+        }
+        if (!SendAll(fd, TextFrame(TickerMessage(pair, sequence++)))) {
+            break;
+        }
+        next += interval;
+        // Client en retard : la cadence repart de maintenant au lieu de rafaler le retard
+        if (std::chrono::steady_clock::now() - next > std::chrono::milliseconds(100)) {
+            next = std::chrono::steady_clock::now();
+        }
+    }
+    close(fd);
+}
+
+// ===== REST =====
+
+static void RunRest(int listenFd) {
+    uint64_t orders = 0;
+    while (!gStop) {
+        int fd = Accept(listenFd, 100);
+        if (fd < 0) {
+            continue;
+        }
+
+        // Requêtes successives sur la même connexion (keep-alive côté client)
+        std::string buffer, headers;
+        char chunk[4096];
+        while (!gStop && ReadHeaders(fd, buffer, headers)) {
+            size_t length = (size_t) atol(HeaderValue(headers, "Content-Length").c_str());
+            while (buffer.size() < length) {
+                ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) {
+                    break;
+                }
+                buffer.append(chunk, (size_t) n);
+            }
+            buffer.erase(0, std::min(length, buffer.size()));
+
+            std::string body = "{\"error\":[],\"result\":{\"descr\":{\"order\":\"harness\"},\"txid\":[\"OHARN-" +
+                               std::to_string(++orders) + "\"]}}";
+            if (!SendAll(fd, "HTTP/1.1 200 OK\r\n"
+                             "Content-Type: application/json\r\n"
+                             "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body)) {
+                break;
+            }
+        }
+        close(fd);
+    }
+}
+
+// ===== RAPPORT =====
+
+static void Print(const char* name, const API::StageStats& stats) {
+    std::cout << std::left << std::setw(14) << name << std::right
+              << std::setw(10) << stats.count
+              << std::setw(10) << stats.p50
+              << std::setw(10) << stats.p90
+              << std::setw(10) << stats.p99
+              << std::setw(10) << stats.p999
+              << std::setw(10) << stats.max << std::endl;
+}
+
+int main(int argc, char** argv) {
+    int rate = argc > 1 ? atoi(argv[1]) : 1000;
+    int duration = argc > 2 ? atoi(argv[2]) : 5;
+    int every = argc > 3 ? std::max(atoi(argv[3]), 1) : 10;
+
+    std::cout << FULLNAME << " - tick-to-trade latency harness" << std::endl;
+    std::cout << rate << " msgs/s for " << duration << " s, one order every " << every << " ticker(s)" << std::endl;
+
+    int wsPort = 0, restPort = 0;
+    int wsFd = Listen(wsPort);
+    int restFd = Listen(restPort);
+    if (wsFd < 0 || restFd < 0) {
+        std::cerr << RED << "Cannot listen on loopback" << STOP << std::endl;
+        return 1;
+    }
+    std::thread feed(RunFeed, wsFd, rate);
+    std::thread rest(RunRest, restFd);
+
+    API::LatencyProbe::Enable(true);
+
+    API::KrakenApi api;
+    api.SetBaseUrl("http://127.0.0.1:" + std::to_string(restPort));
+    api.SetWebSocketUrl("ws://127.0.0.1:" + std::to_string(wsPort));
+    api.SetCredentials("harness", "aGFybmVzcy1zZWNyZXQtaGFybmVzcy1zZWNyZXQ=");
+    api.SetRateLimits(0, 0);
+
+    std::atomic<uint64_t> tickers{0}, placed{0}, failed{0};
+    api.SetTickerCallback([&](const API::TickerData& ticker) {
+        if (++tickers % (uint64_t) every != 0) {
+            return;
+        }
+        API::LatencyProbe::Mark(API::eStageDecision);
+        if (api.PlaceLimitOrder(ticker.pair, "buy", 0.001, ticker.bid - 100.0).empty()) {
+            failed++;
+        } else {
+            placed++;
+        }
+    });
+
+    if (!api.ConnectWebSocket() || !api.SubscribeToTicker("XBT/USD")) {
+        std::cerr << RED << api.GetLastError() << STOP << std::endl;
+        gStop = true;
+        feed.join();
+        rest.join();
+        return 1;
+    }
+
+    // Première seconde écartée : connexions, étalonnage et caches à froid
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+    API::LatencyProbe::Reset();
+    tickers = placed = failed = 0;
+    std::this_thread::sleep_for(std::chrono::seconds(duration));
+
+    api.DisconnectWebSocket();
+    gStop = true;
+    feed.join();
+    rest.join();
+    close(wsFd);
+    close(restFd);
+
+    std::cout << tickers << " ticker(s), " << placed << " order(s) placed, " << failed << " failed" << std::endl;
+    std::cout << std::left << std::setw(14) << "stage (ns)" << std::right
+              << std::setw(10) << "count" << std::setw(10) << "p50" << std::setw(10) << "p90"
+              << std::setw(10) << "p99" << std::setw(10) << "p99.9" << std::setw(10) << "max" << std::endl;
+    for (int stage = API::eStageDecode; stage < API::eStageCount; ++stage) {
+        Print(API::LatencyProbe::ToString((API::ELatencyStage) stage),
+              API::LatencyProbe::GetStats((API::ELatencyStage) stage));
+    }
+    Print("total", API::LatencyProbe::GetTotal());
+    return 0;
+}
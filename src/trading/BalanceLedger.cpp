@@ -0,0 +1,258 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#include "BalanceLedger.h"
+#include <chrono>
+#include <algorithm>
+
+namespace Richy {
+
+    CBalanceLedger::CBalanceLedger() :
+        mSequence(0),
+        mLastSync(0),
+        mStop(false) {
+    }
+
+    CBalanceLedger::~CBalanceLedger() {
+        StopReconciliation();
+    }
+
+    // ===== SYNCHRONISATION =====
+
+    uint64_t CBalanceLedger::GetMark() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mSequence;
+    }
+
+    bool CBalanceLedger::Sync(API::KrakenApi& api) {
+        uint64_t requested = GetMark();
+        std::vector<API::Balance> balances = api.GetAccountBalance();
+        // Un instantané vide ne vaut pas synchronisation : tous les soldes resteraient à zéro
+        if (balances.empty()) {
+            return false;
+        }
+        Apply(balances, requested);
+        return true;
+    }
+
+    void CBalanceLedger::Apply(const std::vector<API::Balance>& balances, uint64_t mark) {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        // Les mouvements antérieurs à la demande sont dans l'instantané
+        while (!mDeltas.empty() && mDeltas.front().sequence < mark) {
+            mDeltas.pop_front();
+        }
+
+        for (const auto& balance : balances) {
+            SAccount& account = mAccounts[balance.currency];
+            // Instantané de l'exchange, plus nos exécutions qu'il ne montre pas encore
+            account.total = balance.total;
+            for (const auto& delta : mDeltas) {
+                if (delta.currency == balance.currency) {
+                    account.total += delta.amount;
+                }
+            }
+            // Nos réservations incluent les ordres en vol que l'exchange ne voit pas encore
+            account.drift = account.reserved - balance.locked;
+        }
+
+        mLastSync = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()
+        ).count();
+    }
+
+    void CBalanceLedger::StartReconciliation(API::KrakenApi& api, int intervalSeconds) {
+        StopReconciliation();
+        {
+            std::lock_guard<std::mutex> lock(mThreadMutex);
+            mStop = false;
+        }
+        mThread = std::thread(&CBalanceLedger::ReconciliationLoop, this, &api, intervalSeconds);
+    }
+
+    void CBalanceLedger::StopReconciliation() {
+        {
+            std::lock_guard<std::mutex> lock(mThreadMutex);
+            mStop = true;
+        }
+        mWakeUp.notify_all();
+        if (mThread.joinable()) {
+            mThread.join();
+        }
+    }
+
+    void CBalanceLedger::ReconciliationLoop(API::KrakenApi* api, int intervalSeconds) {
+        std::unique_lock<std::mutex> lock(mThreadMutex);
+        while (!mStop) {
+            if (mWakeUp.wait_for(lock, std::chrono::seconds(intervalSeconds), [this] { return mStop; })) {
+                break;
+            }
+            // L'appel réseau se fait hors du verrou du thread
+            lock.unlock();
+            Sync(*api);
+            lock.lock();
+        }
+    }
+
+    // ===== CONTRÔLES PRÉ-TRADE =====
+
+    double CBalanceLedger::GetAvailable(const std::string& currency) const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mAccounts.find(currency);
+        if (it == mAccounts.end()) {
+            return 0.0;
+        }
+        return std::max(0.0, it->second.total - it->second.reserved);
+    }
+
+    double CBalanceLedger::GetReserved(const std::string& currency) const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mAccounts.find(currency);
+        return it != mAccounts.end() ? it->second.reserved : 0.0;
+    }
+
+    double CBalanceLedger::GetTotal(const std::string& currency) const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mAccounts.find(currency);
+        return it != mAccounts.end() ? it->second.total : 0.0;
+    }
+
+    bool CBalanceLedger::CanAfford(const std::string& currency, double amount) const {
+        return GetAvailable(currency) >= amount;
+    }
+
+    // ===== CYCLE DE VIE DES ORDRES =====
+
+    bool CBalanceLedger::Reserve(const std::string& orderId, const std::string& currency, double amount) {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        if (mReservations.find(orderId) != mReservations.end()) {
+            return false;
+        }
+
+        SAccount& account = mAccounts[currency];
+        if (account.total - account.reserved < amount) {
+            return false;
+        }
+
+        account.reserved += amount;
+        SReservation reservation;
+        reservation.currency = currency;
+        reservation.amount = amount;
+        mReservations[orderId] = reservation;
+        return true;
+    }
+
+    bool CBalanceLedger::Rename(const std::string& orderId, const std::string& newOrderId) {
+        // Permet de réserver sous un identifiant client puis de basculer sur le txid Kraken
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        auto it = mReservations.find(orderId);
+        if (it == mReservations.end() || mReservations.find(newOrderId) != mReservations.end()) {
+            return false;
+        }
+        mReservations[newOrderId] = it->second;
+        mReservations.erase(it);
+        return true;
+    }
+
+    void CBalanceLedger::Release(const std::string& orderId) {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        auto it = mReservations.find(orderId);
+        if (it == mReservations.end()) {
+            return;
+        }
+        SAccount& account = mAccounts[it->second.currency];
+        account.reserved = std::max(0.0, account.reserved - it->second.amount);
+        mReservations.erase(it);
+    }
+
+    void CBalanceLedger::ApplyFill(const std::string& orderId,
+                                   const std::string& debitCurrency, double debit,
+                                   const std::string& creditCurrency, double credit) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        Fill(orderId, debitCurrency, debit, creditCurrency, credit);
+        auto it = mReservations.find(orderId);
+        if (it != mReservations.end() && it->second.amount <= 0.0) {
+            mReservations.erase(it);
+        }
+    }
+
+    void CBalanceLedger::OnOrder(const API::Order& order, const std::string& base, const std::string& quote) {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        auto it = mReservations.find(order.orderId);
+        if (it == mReservations.end()) {
+            return;
+        }
+        SReservation& reservation = it->second;
+        double filled = order.filled - reservation.filled;
+        double cost = order.cost - reservation.cost;
+        double fee = order.fee - reservation.fee;
+        if (filled > 0.0 || cost > 0.0 || fee > 0.0) {
+            reservation.filled = order.filled;
+            reservation.cost = order.cost;
+            reservation.fee = order.fee;
+            if (order.type == "buy") {
+                Fill(order.orderId, quote, cost + fee, base, filled);
+            } else {
+                Fill(order.orderId, base, filled, quote, cost - fee);
+            }
+        }
+
+        // L'entrée reste jusqu'à la clôture, même épuisée : elle porte les cumuls
+        if (order.status == "closed" || order.status == "canceled" || order.status == "expired") {
+            SAccount& account = mAccounts[it->second.currency];
+            account.reserved = std::max(0.0, account.reserved - it->second.amount);
+            mReservations.erase(it);
+        }
+    }
+
+    void CBalanceLedger::Fill(const std::string& orderId,
+                              const std::string& debitCurrency, double debit,
+                              const std::string& creditCurrency, double credit) {
+        // Consommation de la réservation à hauteur du montant débité
+        auto it = mReservations.find(orderId);
+        if (it != mReservations.end() && it->second.currency == debitCurrency) {
+            double consumed = std::min(debit, it->second.amount);
+            it->second.amount -= consumed;
+            SAccount& account = mAccounts[debitCurrency];
+            account.reserved = std::max(0.0, account.reserved - consumed);
+        }
+
+        mAccounts[debitCurrency].total -= debit;
+        mAccounts[creditCurrency].total += credit;
+        mDeltas.push_back({mSequence, debitCurrency, -debit});
+        mDeltas.push_back({mSequence, creditCurrency, credit});
+        mSequence++;
+    }
+
+    // ===== CONSULTATION =====
+
+    double CBalanceLedger::GetDrift(const std::string& currency) const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto it = mAccounts.find(currency);
+        return it != mAccounts.end() ? it->second.drift : 0.0;
+    }
+
+    long CBalanceLedger::GetLastSync() const {
+        return mLastSync;
+    }
+
+    std::vector<API::Balance> CBalanceLedger::GetBalances() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        std::vector<API::Balance> balances;
+        for (const auto& account : mAccounts) {
+            API::Balance balance;
+            balance.currency = account.first;
+            balance.total = account.second.total;
+            balance.locked = account.second.reserved;
+            balance.available = std::max(0.0, account.second.total - account.second.reserved);
+            balances.push_back(balance);
+        }
+        return balances;
+    }
+}
@@ -0,0 +1,110 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#ifndef BALANCELEDGER_H
+#define BALANCELEDGER_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <condition_variable>
+#include "../net/KrakenApi.h"
+#include "../net/FundsLedger.h"
+
+namespace Richy {
+
+    /*
+     * Registre local des soldes.
+     *
+     * Initialisé par un seul appel REST, il réserve les fonds à l'envoi d'un
+     * ordre, les consomme à l'exécution et les libère à l'annulation. Les
+     * contrôles pré-trade se font donc sans aller-retour réseau. Un thread de
+     * fond peut resynchroniser périodiquement les totaux avec l'exchange :
+     * les exécutions appliquées localement depuis la demande de l'instantané
+     * s'y ajoutent, puisque l'exchange ne les reflète pas encore.
+     */
+    class CBalanceLedger : public API::FundsLedger {
+        public:
+            CBalanceLedger();
+            ~CBalanceLedger() override;
+
+            // Synchronisation avec l'exchange ; false si la requête échoue ou ne rapporte aucun solde
+            bool Sync(API::KrakenApi& api);
+            // mark : GetMark() relevé avant de demander l'instantané (par défaut, tout y est déjà reflété)
+            void Apply(const std::vector<API::Balance>& balances, uint64_t mark = UINT64_MAX);
+            uint64_t GetMark() const;
+            void StartReconciliation(API::KrakenApi& api, int intervalSeconds);
+            void StopReconciliation();
+
+            // Contrôles pré-trade (aucun appel réseau)
+            double GetAvailable(const std::string& currency) const override;
+            double GetReserved(const std::string& currency) const;
+            double GetTotal(const std::string& currency) const;
+            bool CanAfford(const std::string& currency, double amount) const;
+
+            // Cycle de vie des ordres
+            bool Reserve(const std::string& orderId, const std::string& currency, double amount) override;
+            bool Rename(const std::string& orderId, const std::string& newOrderId) override;
+            void Release(const std::string& orderId) override;
+            void ApplyFill(const std::string& orderId,
+                           const std::string& debitCurrency, double debit,
+                           const std::string& creditCurrency, double credit);
+            // État observé d'un ordre réservé : nouvelles exécutions (cumuls vol_exec, cost, fee)
+            // appliquées une seule fois, reste libéré à la clôture. Frais en devise de cotation.
+            void OnOrder(const API::Order& order, const std::string& base, const std::string& quote) override;
+
+            // Écart constaté entre nos réservations et le "hold_trade" de l'exchange
+            double GetDrift(const std::string& currency) const;
+            long GetLastSync() const override;
+            std::vector<API::Balance> GetBalances() const;
+
+        private:
+            struct SAccount {
+                double total = 0.0;
+                double reserved = 0.0;
+                double drift = 0.0;
+            };
+
+            struct SReservation {
+                std::string currency;
+                double amount = 0.0;
+                // Cumuls déjà appliqués
+                double filled = 0.0;
+                double cost = 0.0;
+                double fee = 0.0;
+            };
+
+            // Mouvement local pas encore forcément vu par l'exchange
+            struct SDelta {
+                uint64_t sequence;
+                std::string currency;
+                double amount;
+            };
+
+            void Fill(const std::string& orderId,
+                      const std::string& debitCurrency, double debit,
+                      const std::string& creditCurrency, double credit);
+            void ReconciliationLoop(API::KrakenApi* api, int intervalSeconds);
+
+            mutable std::mutex mMutex;
+            std::map<std::string, SAccount> mAccounts;
+            std::map<std::string, SReservation> mReservations;
+            std::deque<SDelta> mDeltas;
+            uint64_t mSequence;
+            std::atomic<long> mLastSync;
+
+            // Thread de réconciliation
+            std::thread mThread;
+            std::mutex mThreadMutex;
+            std::condition_variable mWakeUp;
+            bool mStop;
+    };
+}
+
+#endif //BALANCELEDGER_H
@@ -0,0 +1,263 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#include "OrderBookView.h"
+#include <algorithm>
+#include "Simd.h"
+
+namespace Richy {
+
+    static bool sSimdEnabled = true;
+
+    // ===== NOYAUX SCALAIRES =====
+
+    // Renvoie le notionnel balayé, "remaining" est décrémenté de la quantité prise
+    static double SweepScalar(const double* prices, const double* volumes, size_t begin, size_t end, double& remaining) {
+        double notional = 0.0;
+        for (size_t i = begin; i < end && remaining > 0.0; ++i) {
+            double take = std::min(volumes[i], remaining);
+            notional += take * prices[i];
+            remaining -= take;
+        }
+        return notional;
+    }
+
+    static double DepthScalar(const double* prices, const double* volumes, size_t begin, size_t end,
+                              double limit, bool asks) {
+        double depth = 0.0;
+        for (size_t i = begin; i < end; ++i) {
+            if (asks ? prices[i] > limit : prices[i] < limit) {
+                break;
+            }
+            depth += volumes[i];
+        }
+        return depth;
+    }
+
+    static double SumScalar(const double* values, size_t begin, size_t end) {
+        double sum = 0.0;
+        for (size_t i = begin; i < end; ++i) {
+            sum += values[i];
+        }
+        return sum;
+    }
+
+    // ===== NOYAUX AVX2 =====
+
+#ifdef RICHY_HAS_X86
+    RICHY_TARGET_AVX2
+    static inline double HorizontalSum(__m256d value) {
+        __m128d low = _mm256_castpd256_pd128(value);
+        __m128d high = _mm256_extractf128_pd(value, 1);
+        low = _mm_add_pd(low, high);
+        return _mm_cvtsd_f64(_mm_add_sd(low, _mm_unpackhi_pd(low, low)));
+    }
+
+    RICHY_TARGET_AVX2
+    static double SweepAVX2(const double* prices, const double* volumes, size_t count, double& remaining) {
+        double notional = 0.0;
+        size_t i = 0;
+
+        // Blocs de 4 niveaux entièrement consommés
+        for (; i + 4 <= count; i += 4) {
+            __m256d v = _mm256_loadu_pd(volumes + i);
+            double blockVolume = HorizontalSum(v);
+            if (blockVolume >= remaining) {
+                break;
+            }
+            notional += HorizontalSum(_mm256_mul_pd(v, _mm256_loadu_pd(prices + i)));
+            remaining -= blockVolume;
+        }
+
+        // Le dernier bloc, partiellement consommé, est fini en scalaire
+        return notional + SweepScalar(prices, volumes, i, count, remaining);
+    }
+
+    RICHY_TARGET_AVX2
+    static double DepthAVX2(const double* prices, const double* volumes, size_t count, double limit, bool asks) {
+        __m256d sum = _mm256_setzero_pd();
+        __m256d bound = _mm256_set1_pd(limit);
+        size_t i = 0;
+
+        for (; i + 4 <= count; i += 4) {
+            __m256d p = _mm256_loadu_pd(prices + i);
+            __m256d mask = asks ? _mm256_cmp_pd(p, bound, _CMP_LE_OQ) : _mm256_cmp_pd(p, bound, _CMP_GE_OQ);
+            sum = _mm256_add_pd(sum, _mm256_and_pd(mask, _mm256_loadu_pd(volumes + i)));
+            // Carnet trié : dès qu'un niveau sort de la bande, les suivants aussi
+            if (_mm256_movemask_pd(mask) != 0xF) {
+                return HorizontalSum(sum);
+            }
+        }
+
+        return HorizontalSum(sum) + DepthScalar(prices, volumes, i, count, limit, asks);
+    }
+
+    RICHY_TARGET_AVX2
+    static double SumAVX2(const double* values, size_t count) {
+        __m256d sum = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            sum = _mm256_add_pd(sum, _mm256_loadu_pd(values + i));
+        }
+        return HorizontalSum(sum) + SumScalar(values, i, count);
+    }
+#endif
+
+    static bool UseAVX2() {
+        return sSimdEnabled && HasAVX2();
+    }
+
+    static double Sweep(const double* prices, const double* volumes, size_t count, double& remaining) {
+#ifdef RICHY_HAS_X86
+        if (UseAVX2()) {
+            return SweepAVX2(prices, volumes, count, remaining);
+        }
+#endif
+        return SweepScalar(prices, volumes, 0, count, remaining);
+    }
+
+    static double Depth(const double* prices, const double* volumes, size_t count, double limit, bool asks) {
+#ifdef RICHY_HAS_X86
+        if (UseAVX2()) {
+            return DepthAVX2(prices, volumes, count, limit, asks);
+        }
+#endif
+        return DepthScalar(prices, volumes, 0, count, limit, asks);
+    }
+
+    static double Sum(const double* values, size_t count) {
+#ifdef RICHY_HAS_X86
+        if (UseAVX2()) {
+            return SumAVX2(values, count);
+        }
+#endif
+        return SumScalar(values, 0, count);
+    }
+
+    // ===== VUE =====
+
+    COrderBookView::COrderBookView() {
+    }
+
+    COrderBookView::~COrderBookView() {
+    }
+
+    void COrderBookView::EnableSimd(bool enabled) {
+        sSimdEnabled = enabled;
+    }
+
+    void COrderBookView::Assign(const API::OrderBook& book) {
+        const std::vector<API::OrderBookEntry>* entries[2] = {&book.bids, &book.asks};
+        for (int side = 0; side < 2; ++side) {
+            SSide& target = mSides[side];
+            target.prices.resize(entries[side]->size());
+            target.volumes.resize(entries[side]->size());
+            for (size_t i = 0; i < entries[side]->size(); ++i) {
+                target.prices[i] = (*entries[side])[i].price;
+                target.volumes[i] = (*entries[side])[i].volume;
+            }
+        }
+    }
+
+    void COrderBookView::SetLevels(EBookSide side, const double* prices, const double* volumes, size_t count) {
+        mSides[side].prices.assign(prices, prices + count);
+        mSides[side].volumes.assign(volumes, volumes + count);
+    }
+
+    void COrderBookView::SetLevel(EBookSide side, size_t index, double price, double volume) {
+        SSide& target = mSides[side];
+        if (index >= target.prices.size()) {
+            target.prices.resize(index + 1, 0.0);
+            target.volumes.resize(index + 1, 0.0);
+        }
+        target.prices[index] = price;
+        target.volumes[index] = volume;
+    }
+
+    void COrderBookView::Truncate(EBookSide side, size_t count) {
+        if (count < mSides[side].prices.size()) {
+            mSides[side].prices.resize(count);
+            mSides[side].volumes.resize(count);
+        }
+    }
+
+    void COrderBookView::Clear() {
+        Truncate(eBids, 0);
+        Truncate(eAsks, 0);
+    }
+
+    size_t COrderBookView::GetDepth(EBookSide side) const {
+        return mSides[side].prices.size();
+    }
+
+    const double* COrderBookView::GetPrices(EBookSide side) const {
+        return mSides[side].prices.data();
+    }
+
+    const double* COrderBookView::GetVolumes(EBookSide side) const {
+        return mSides[side].volumes.data();
+    }
+
+    double COrderBookView::GetBestBid() const {
+        return mSides[eBids].prices.empty() ? 0.0 : mSides[eBids].prices[0];
+    }
+
+    double COrderBookView::GetBestAsk() const {
+        return mSides[eAsks].prices.empty() ? 0.0 : mSides[eAsks].prices[0];
+    }
+
+    double COrderBookView::GetMid() const {
+        if (mSides[eBids].prices.empty() || mSides[eAsks].prices.empty()) {
+            return 0.0;
+        }
+        return (GetBestBid() + GetBestAsk()) * 0.5;
+    }
+
+    // ===== MÉTRIQUES =====
+
+    double COrderBookView::GetSweepVWAP(EBookSide side, double quantity, double* filled) const {
+        double remaining = quantity;
+        double notional = Sweep(GetPrices(side), GetVolumes(side), GetDepth(side), remaining);
+        double done = quantity - remaining;
+        if (filled) {
+            *filled = done;
+        }
+        return done > 0.0 ? notional / done : 0.0;
+    }
+
+    double COrderBookView::GetSweepCost(EBookSide side, double quantity) const {
+        double remaining = quantity;
+        return Sweep(GetPrices(side), GetVolumes(side), GetDepth(side), remaining);
+    }
+
+    double COrderBookView::GetDepthWithin(EBookSide side, double bps) const {
+        double mid = GetMid();
+        if (mid <= 0.0) {
+            return 0.0;
+        }
+        double offset = mid * bps / 10000.0;
+        double limit = side == eAsks ? mid + offset : mid - offset;
+        return Depth(GetPrices(side), GetVolumes(side), GetDepth(side), limit, side == eAsks);
+    }
+
+    double COrderBookView::GetImbalance(size_t levels) const {
+        double bids = Sum(GetVolumes(eBids), std::min(levels, GetDepth(eBids)));
+        double asks = Sum(GetVolumes(eAsks), std::min(levels, GetDepth(eAsks)));
+        double total = bids + asks;
+        return total > 0.0 ? (bids - asks) / total : 0.0;
+    }
+
+    double COrderBookView::GetMicroprice() const {
+        if (mSides[eBids].prices.empty() || mSides[eAsks].prices.empty()) {
+            return 0.0;
+        }
+        double bidVolume = mSides[eBids].volumes[0];
+        double askVolume = mSides[eAsks].volumes[0];
+        double total = bidVolume + askVolume;
+        if (total <= 0.0) {
+            return GetMid();
+        }
+        return (GetBestAsk() * bidVolume + GetBestBid() * askVolume) / total;
+    }
+}
@@ -0,0 +1,76 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#ifndef ORDERBOOKVIEW_H
+#define ORDERBOOKVIEW_H
+
+#include <vector>
+#include <cstddef>
+#include "../net/KrakenApi.h"
+
+namespace Richy {
+
+    enum EBookSide {
+        eBids = 0,
+        eAsks = 1,
+    };
+
+    /*
+     * Vue "structure de tableaux" d'un carnet d'ordres.
+     *
+     * Prix et volumes sont stockés dans des tableaux contigus séparés (sans le
+     * timestamp inutilisé d'OrderBookEntry), ce qui permet des noyaux AVX2
+     * pour les métriques de carnet. Les niveaux sont triés du meilleur au
+     * moins bon : prix croissants pour les asks, décroissants pour les bids.
+     *
+     * La vue peut être remplie depuis un instantané REST (Assign) ou mise à
+     * jour niveau par niveau par un flux temps réel (SetLevel/Truncate).
+     */
+    class COrderBookView {
+        public:
+            COrderBookView();
+            ~COrderBookView();
+
+            // Alimentation
+            void Assign(const API::OrderBook& book);
+            void SetLevels(EBookSide side, const double* prices, const double* volumes, size_t count);
+            void SetLevel(EBookSide side, size_t index, double price, double volume);
+            void Truncate(EBookSide side, size_t count);
+            void Clear();
+
+            // Accès
+            size_t GetDepth(EBookSide side) const;
+            const double* GetPrices(EBookSide side) const;
+            const double* GetVolumes(EBookSide side) const;
+            double GetBestBid() const;
+            double GetBestAsk() const;
+            double GetMid() const;
+
+            // Prix moyen pour balayer "quantity" unités ; filled reçoit la quantité réellement disponible
+            double GetSweepVWAP(EBookSide side, double quantity, double* filled = nullptr) const;
+            double GetSweepCost(EBookSide side, double quantity) const;
+
+            // Liquidité à moins de "bps" points de base du mid
+            double GetDepthWithin(EBookSide side, double bps) const;
+
+            // (bids - asks) / (bids + asks) sur les "levels" premiers niveaux, dans [-1, 1]
+            double GetImbalance(size_t levels = 1) const;
+
+            // Prix moyen pondéré par les volumes opposés du meilleur niveau
+            double GetMicroprice() const;
+
+            // Permet de forcer les noyaux scalaires (bancs de test)
+            static void EnableSimd(bool enabled);
+
+        private:
+            struct SSide {
+                std::vector<double> prices;
+                std::vector<double> volumes;
+            };
+
+            SSide mSides[2];
+    };
+}
+
+#endif //ORDERBOOKVIEW_H
@@ -0,0 +1,286 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#include "PositionEngine.h"
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include "Simd.h"
+
+namespace Richy {
+
+    // ===== NOYAUX DE RÉÉVALUATION =====
+
+    // unrealized[i] = quantity[i] * (mark[i] - avgPrice[i])
+    static void RevalueScalar(const double* quantity, const double* avgPrice, const double* mark,
+                              double* unrealized, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            unrealized[i] = quantity[i] * (mark[i] - avgPrice[i]);
+        }
+    }
+
+#ifdef RICHY_HAS_X86
+    RICHY_TARGET_AVX2
+    static void RevalueAVX2(const double* quantity, const double* avgPrice, const double* mark,
+                            double* unrealized, size_t count) {
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m256d q = _mm256_loadu_pd(quantity + i);
+            __m256d a = _mm256_loadu_pd(avgPrice + i);
+            __m256d m = _mm256_loadu_pd(mark + i);
+            _mm256_storeu_pd(unrealized + i, _mm256_mul_pd(q, _mm256_sub_pd(m, a)));
+        }
+        RevalueScalar(quantity, avgPrice, mark, unrealized, i, count);
+    }
+#endif
+
+    static void Revalue(const double* quantity, const double* avgPrice, const double* mark,
+                        double* unrealized, size_t count) {
+#ifdef RICHY_HAS_X86
+        if (HasAVX2()) {
+            RevalueAVX2(quantity, avgPrice, mark, unrealized, count);
+            return;
+        }
+#endif
+        RevalueScalar(quantity, avgPrice, mark, unrealized, 0, count);
+    }
+
+    // ===== MOTEUR =====
+
+    CPositionEngine::CPositionEngine() {
+    }
+
+    CPositionEngine::~CPositionEngine() {
+    }
+
+    long CPositionEngine::Now() {
+        return std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::system_clock::now().time_since_epoch()
+        ).count();
+    }
+
+    PairId CPositionEngine::Register(const std::string& pair) {
+        auto it = mIndex.find(pair);
+        if (it != mIndex.end()) {
+            return it->second;
+        }
+
+        PairId id = (PairId) mPairs.size();
+        mIndex[pair] = id;
+        mPairs.push_back(pair);
+        mQuantity.push_back(0.0);
+        mAvgPrice.push_back(0.0);
+        mMark.push_back(0.0);
+        mUnrealized.push_back(0.0);
+        mRealized.push_back(0.0);
+        mTimestamp.push_back(0);
+        return id;
+    }
+
+    PairId CPositionEngine::Find(const std::string& pair) const {
+        auto it = mIndex.find(pair);
+        return it != mIndex.end() ? it->second : INVALID_PAIR;
+    }
+
+    size_t CPositionEngine::Size() const {
+        return mPairs.size();
+    }
+
+    void CPositionEngine::ApplyFill(PairId id, const std::string& side, double volume, double price, double fee) {
+        ApplyFill(id, side == "sell" ? -volume : volume, price, fee);
+    }
+
+    void CPositionEngine::ApplyFill(PairId id, double signedVolume, double price, double fee) {
+        if (id >= mPairs.size() || signedVolume == 0.0) {
+            return;
+        }
+
+        double& qty = mQuantity[id];
+        double& avg = mAvgPrice[id];
+
+        if (qty == 0.0 || (qty > 0.0) == (signedVolume > 0.0)) {
+            // Ouverture ou renforcement : moyenne pondérée
+            double total = std::fabs(qty) + std::fabs(signedVolume);
+            avg = (avg * std::fabs(qty) + price * std::fabs(signedVolume)) / total;
+            qty += signedVolume;
+        } else {
+            // Réduction, clôture ou retournement
+            double closed = std::min(std::fabs(signedVolume), std::fabs(qty));
+            mRealized[id] += closed * (price - avg) * (qty > 0.0 ? 1.0 : -1.0);
+
+            double remaining = qty + signedVolume;
+            if (remaining == 0.0) {
+                avg = 0.0;
+            } else if ((remaining > 0.0) != (qty > 0.0)) {
+                // Retournement : le reliquat est ouvert au prix du fill
+                avg = price;
+            }
+            qty = remaining;
+        }
+
+        mRealized[id] -= fee;
+        mTimestamp[id] = Now();
+
+        if (mMark[id] == 0.0) {
+            mMark[id] = price;
+        }
+        mUnrealized[id] = qty * (mMark[id] - avg);
+    }
+
+    void CPositionEngine::OnTicker(const API::TickerData& ticker) {
+        PairId id = Find(ticker.pair);
+        if (id == INVALID_PAIR) {
+            return;
+        }
+
+        // Valorisation au mid si le carnet est connu, sinon au dernier prix
+        double mark = (ticker.bid > 0.0 && ticker.ask > 0.0) ? (ticker.bid + ticker.ask) * 0.5 : ticker.last;
+        OnMark(id, mark);
+    }
+
+    void CPositionEngine::OnMark(PairId id, double mark) {
+        if (id >= mPairs.size()) {
+            return;
+        }
+        mMark[id] = mark;
+        mUnrealized[id] = mQuantity[id] * (mark - mAvgPrice[id]);
+    }
+
+    void CPositionEngine::OnMarks(const PairId* ids, const double* marks, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            if (ids[i] < mPairs.size()) {
+                mMark[ids[i]] = marks[i];
+            }
+        }
+        RevalueAll();
+    }
+
+    void CPositionEngine::RevalueAll() {
+        Revalue(mQuantity.data(), mAvgPrice.data(), mMark.data(), mUnrealized.data(), mPairs.size());
+    }
+
+    void CPositionEngine::Load(const std::vector<API::Position>& positions) {
+        for (const auto& position : positions) {
+            PairId id = Register(position.pair);
+            double qty = position.type == "short" ? -position.volume : position.volume;
+
+            // Plusieurs positions sur la même paire sont agrégées, sens opposés compensés
+            double held = mQuantity[id];
+            if (held == 0.0 || (held > 0.0) == (qty > 0.0)) {
+                double total = std::fabs(held) + std::fabs(qty);
+                mAvgPrice[id] = total > 0.0 ?
+                                (mAvgPrice[id] * std::fabs(held) + position.avgPrice * std::fabs(qty)) / total : 0.0;
+            } else if (held + qty == 0.0) {
+                mAvgPrice[id] = 0.0;
+            } else if ((held + qty > 0.0) != (held > 0.0)) {
+                // Le côté chargé l'emporte : le reliquat garde son prix moyen
+                mAvgPrice[id] = position.avgPrice;
+            }
+            mQuantity[id] = held + qty;
+            mTimestamp[id] = position.timestamp;
+
+            // Sans tick reçu, valorisation au prix moyen (PnL latent nul) comme pour un fill
+            if (mMark[id] == 0.0) {
+                mMark[id] = mAvgPrice[id];
+            }
+        }
+        RevalueAll();
+    }
+
+    double CPositionEngine::GetQuantity(PairId id) const {
+        return id < mPairs.size() ? mQuantity[id] : 0.0;
+    }
+
+    double CPositionEngine::GetAvgPrice(PairId id) const {
+        return id < mPairs.size() ? mAvgPrice[id] : 0.0;
+    }
+
+    double CPositionEngine::GetUnrealizedPnL(PairId id) const {
+        return id < mPairs.size() ? mUnrealized[id] : 0.0;
+    }
+
+    double CPositionEngine::GetRealizedPnL(PairId id) const {
+        return id < mPairs.size() ? mRealized[id] : 0.0;
+    }
+
+    double CPositionEngine::GetTotalUnrealizedPnL() const {
+        double total = 0.0;
+        for (double pnl : mUnrealized) {
+            total += pnl;
+        }
+        return total;
+    }
+
+    double CPositionEngine::GetTotalRealizedPnL() const {
+        double total = 0.0;
+        for (double pnl : mRealized) {
+            total += pnl;
+        }
+        return total;
+    }
+
+    API::Position CPositionEngine::GetPosition(PairId id) const {
+        API::Position position = {};
+        if (id >= mPairs.size()) {
+            return position;
+        }
+        position.pair = mPairs[id];
+        position.type = mQuantity[id] < 0.0 ? "short" : "long";
+        position.volume = std::fabs(mQuantity[id]);
+        position.avgPrice = mAvgPrice[id];
+        position.unrealizedPnL = mUnrealized[id];
+        position.realizedPnL = mRealized[id];
+        position.timestamp = mTimestamp[id];
+        return position;
+    }
+
+    std::vector<API::Position> CPositionEngine::GetPositions() const {
+        std::vector<API::Position> positions;
+        for (PairId id = 0; id < mPairs.size(); ++id) {
+            if (mQuantity[id] != 0.0 || mRealized[id] != 0.0) {
+                positions.push_back(GetPosition(id));
+            }
+        }
+        return positions;
+    }
+
+    // ===== MOTEUR PARTAGÉ =====
+
+    CPositionBook::CPositionBook() {
+    }
+
+    CPositionBook::~CPositionBook() {
+    }
+
+    void CPositionBook::OnTicker(const API::TickerData& ticker) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mEngine.OnTicker(ticker);
+    }
+
+    void CPositionBook::OnFill(const std::string& pair, const std::string& type, double volume, double price,
+                               double fee) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mEngine.ApplyFill(mEngine.Register(pair), type, volume, price, fee);
+    }
+
+    void CPositionBook::Load(const std::vector<API::Position>& positions) {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mEngine.Load(positions);
+    }
+
+    std::vector<API::Position> CPositionBook::GetPositions() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mEngine.GetPositions();
+    }
+
+    double CPositionBook::GetTotalUnrealizedPnL() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mEngine.GetTotalUnrealizedPnL();
+    }
+
+    double CPositionBook::GetTotalRealizedPnL() const {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mEngine.GetTotalRealizedPnL();
+    }
+}
@@ -0,0 +1,111 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#ifndef POSITIONENGINE_H
+#define POSITIONENGINE_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include "../net/KrakenApi.h"
+#include "../net/PositionTracker.h"
+
+namespace Richy {
+
+    using API::PairId;
+    using API::INVALID_PAIR;
+
+    /*
+     * Moteur de positions incrémental.
+     *
+     * Les fills mettent à jour prix moyen et PnL réalisé en O(1), chaque tick
+     * réévalue le PnL latent de sa paire en O(1). Les données sont rangées en
+     * structure de tableaux pour permettre une réévaluation groupée (AVX2 si
+     * disponible) quand beaucoup de paires tickent ensemble.
+     *
+     * Pas de verrou : le moteur doit être piloté par un seul thread (celui du flux).
+     */
+    class CPositionEngine {
+        public:
+            CPositionEngine();
+            ~CPositionEngine();
+
+            // Enregistrement des paires (hors chemin critique)
+            PairId Register(const std::string& pair);
+            PairId Find(const std::string& pair) const;
+            size_t Size() const;
+
+            // Exécutions : side = "buy" ou "sell", fee en devise de cotation
+            void ApplyFill(PairId id, const std::string& side, double volume, double price, double fee = 0.0);
+            void ApplyFill(PairId id, double signedVolume, double price, double fee = 0.0);
+
+            // Réévaluation sur tick
+            void OnTicker(const API::TickerData& ticker);
+            void OnMark(PairId id, double mark);
+
+            // Réévaluation groupée : marks[i] s'applique à ids[i]
+            void OnMarks(const PairId* ids, const double* marks, size_t count);
+            void RevalueAll();
+
+            // Reprise de l'état depuis l'exchange (GetOpenPositions)
+            void Load(const std::vector<API::Position>& positions);
+
+            // Consultation
+            double GetQuantity(PairId id) const;
+            double GetAvgPrice(PairId id) const;
+            double GetUnrealizedPnL(PairId id) const;
+            double GetRealizedPnL(PairId id) const;
+            double GetTotalUnrealizedPnL() const;
+            double GetTotalRealizedPnL() const;
+            API::Position GetPosition(PairId id) const;
+            std::vector<API::Position> GetPositions() const;
+
+        private:
+            static long Now();
+
+            std::unordered_map<std::string, PairId> mIndex;
+            std::vector<std::string> mPairs;
+
+            // Structure de tableaux (quantité signée : > 0 long, < 0 short)
+            std::vector<double> mQuantity;
+            std::vector<double> mAvgPrice;
+            std::vector<double> mMark;
+            std::vector<double> mUnrealized;
+            std::vector<double> mRealized;
+            std::vector<long> mTimestamp;
+    };
+
+    /*
+     * Moteur de positions partagé, piloté par KrakenApi.
+     *
+     * Les ticks arrivent du thread du flux, les exécutions des threads des
+     * requêtes (suivi des ordres) : un verrou, rarement disputé, sérialise
+     * l'accès au moteur. Les paires sont enregistrées à leur premier fill ou
+     * au chargement des positions de l'exchange.
+     */
+    class CPositionBook : public API::PositionTracker {
+        public:
+            CPositionBook();
+            ~CPositionBook() override;
+
+            void OnTicker(const API::TickerData& ticker) override;
+            void OnFill(const std::string& pair, const std::string& type, double volume, double price,
+                        double fee) override;
+            void Load(const std::vector<API::Position>& positions) override;
+
+            // Consultation (copies cohérentes)
+            std::vector<API::Position> GetPositions() const;
+            double GetTotalUnrealizedPnL() const;
+            double GetTotalRealizedPnL() const;
+
+        private:
+            mutable std::mutex mMutex;
+            CPositionEngine mEngine;
+    };
+}
+
+#endif //POSITIONENGINE_H
@@ -0,0 +1,27 @@
+//
+// Created by Jean-Michel Frouin on 18/10/2026.
+//
+
+#ifndef SIMD_H
+#define SIMD_H
+
+// Détection du support AVX2 pour les noyaux vectoriels (x86 uniquement)
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define RICHY_HAS_X86 1
+#define RICHY_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace Richy {
+
+    inline bool HasAVX2() {
+#ifdef RICHY_HAS_X86
+        static const bool supported = __builtin_cpu_supports("avx2");
+        return supported;
+#else
+        return false;
+#endif
+    }
+}
+
+#endif //SIMD_H